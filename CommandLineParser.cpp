@@ -19,9 +19,16 @@ static const char optionStarter = '-';
 enum class ProgOptStatus
 {
 	NoErrors,
-	MissingArgument
+	MissingArgument,
+	InvalidValue
 };
 
+/*
+ * A ListCursor holds its streaming connection while it loads the related rows of
+ * each chunk on a second connection.
+ */
+static const unsigned int MinDBPoolMaxSize = 2;
+
 static po::options_description addOptions()
 {
 	po::options_description options("Options and arguments");
@@ -34,8 +41,14 @@ static po::options_description addOptions()
 		("mysql-dbname", po::value<std::string>()->default_value("PlannerTaskScheduleDB"), "The name of the database that contains the tables")
 		("user-data-file", po::value<std::string>()->default_value("testData/userData.txt"), "File path including file name to user test data")
 		("task-data-file", po::value<std::string>()->default_value("testData/planData.txt"), "File path including file name to task test data")
+		("db-pool-initial-size", po::value<unsigned int>(), "Number of MySQL connections the connection pool opens at startup. Default is 1.")
+		("db-pool-max-size", po::value<unsigned int>(), "Maximum number of MySQL connections in the connection pool, at least 2. Default is 16.")
+		("db-executor-threads", po::value<unsigned int>(), "Number of threads running the database event loop. Default is 2.")
+		("model-cache-size", po::value<unsigned int>(), "Number of rows of each table kept in the model row cache. Default is 0, no cache.")
 		("time-tests", "Time the execution of the tests")
 		("verbose", "Output additional information for testing and debugging.")
+		("run-benchmarks", "Run the database benchmarks after the tests pass")
+		("benchmark-iterations", po::value<unsigned int>(), "Number of iterations for each benchmark. Default is 1000.")
 	;
 
 	return options;
@@ -143,6 +156,28 @@ static auto processProgramOptions(po::variables_map& inputOptions,
 	programOptions.mySqlPort = (inputOptions.count("mysql-port")) ?
 			inputOptions["scale-factor"].as<unsigned int>() : 3306;
 
+	if (inputOptions.count("db-pool-initial-size")) {
+		programOptions.dbPoolInitialSize = inputOptions["db-pool-initial-size"].as<unsigned int>();
+	}
+
+	if (inputOptions.count("db-pool-max-size")) {
+		programOptions.dbPoolMaxSize = inputOptions["db-pool-max-size"].as<unsigned int>();
+		if (programOptions.dbPoolMaxSize < MinDBPoolMaxSize)
+		{
+			std::cerr << "The option \'--db-pool-max-size\' must be at least " << MinDBPoolMaxSize
+				<< ", a list cursor uses two connections!\n";
+			return std::unexpected(ProgOptStatus::InvalidValue);
+		}
+	}
+
+	if (inputOptions.count("db-executor-threads")) {
+		programOptions.dbExecutorThreads = inputOptions["db-executor-threads"].as<unsigned int>();
+	}
+
+	if (inputOptions.count("model-cache-size")) {
+		programOptions.modelCacheSize = inputOptions["model-cache-size"].as<unsigned int>();
+	}
+
 	if (inputOptions.count("time-tests")) {
 		programOptions.enableExecutionTime = true;
 	}
@@ -151,6 +186,14 @@ static auto processProgramOptions(po::variables_map& inputOptions,
 		programOptions.verboseOutput = true;
 	}
 
+	if (inputOptions.count("run-benchmarks")) {
+		programOptions.runBenchmarks = true;
+	}
+
+	if (inputOptions.count("benchmark-iterations")) {
+		programOptions.benchmarkIterations = inputOptions["benchmark-iterations"].as<unsigned int>();
+	}
+
 	return programOptions;
 }
 
@@ -14,8 +14,15 @@ struct ProgramOptions
     std::string mySqlDBName;
     std::string userTestDataFile;
     std::string taskTestDataFile;
+    unsigned int dbPoolInitialSize = 1;
+    unsigned int dbPoolMaxSize = 16;
+    unsigned int dbPoolIdlePingSeconds = 600;
+    unsigned int dbExecutorThreads = 2;
+    unsigned int modelCacheSize = 0;
+    unsigned int benchmarkIterations = 1000;
 	bool enableExecutionTime = false;
     bool verboseOutput = false;
+    bool runBenchmarks = false;
 };
 
 enum class CommandLineStatus
@@ -0,0 +1,32 @@
+-- --------------------------------------------------------
+-- Moves an existing PlannerTaskScheduleDB to the UserDaySchedule and
+-- UserScheduleItem tables of PlannerTaskScheduleDB.sql used by the DayScheduler.
+-- UserScheduleItem gets the TaskID of Task Execution items and an index on
+-- (UserID, StartDateTime), UserDaySchedule gets one row per user per day.
+-- New databases created by PlannerTaskScheduleDB.sql do not need it.
+--
+-- The new indexes start with UserID, so they replace the UserID indexes the
+-- foreign keys used. The migration fails if a user already has two
+-- UserDaySchedule rows for the same day.
+--
+-- mysql -u MySQLUser -p < MigrateDaySchedule.sql
+-- --------------------------------------------------------
+
+USE `PlannerTaskScheduleDB`;
+
+ALTER TABLE `UserDaySchedule`
+    ADD UNIQUE INDEX `UserID_DateOfSchedule_UNIQUE` (`UserID`, `DateOfSchedule`);
+ALTER TABLE `UserDaySchedule`
+    DROP INDEX `fk_UserDaySchedule_UserID_idx`;
+
+ALTER TABLE `UserScheduleItem`
+    ADD COLUMN `TaskID` INT UNSIGNED DEFAULT NULL,
+    ADD INDEX `UserID_StartDateTime_idx` (`UserID`, `StartDateTime`),
+    ADD INDEX `fk_UserScheduleItem_TaskID_idx` (`TaskID` ASC),
+    ADD CONSTRAINT `fk_UserScheduleItem_TaskID`
+      FOREIGN KEY (`TaskID`)
+      REFERENCES `Tasks` (`TaskID`)
+      ON DELETE CASCADE
+      ON UPDATE RESTRICT;
+ALTER TABLE `UserScheduleItem`
+    DROP INDEX `fk_UserScheduleItem_UserID_idx`;
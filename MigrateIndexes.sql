@@ -0,0 +1,62 @@
+-- --------------------------------------------------------
+-- Moves an existing PlannerTaskScheduleDB to the indexes of PlannerTaskScheduleDB.sql.
+-- The primary keys become the ID column alone, the UNIQUE indexes that duplicated
+-- the ID are dropped, and the Tasks table gets the composite indexes used by the
+-- TaskModel queries. New databases created by PlannerTaskScheduleDB.sql do not need it.
+--
+-- Each primary key is replaced before the unique ID index is dropped, so the
+-- foreign keys that reference the ID always have an index to use.
+--
+-- mysql -u MySQLUser -p < MigrateIndexes.sql
+-- --------------------------------------------------------
+
+USE `PlannerTaskScheduleDB`;
+
+ALTER TABLE `UserProfile`
+    DROP PRIMARY KEY,
+    ADD PRIMARY KEY (`UserID`);
+ALTER TABLE `UserProfile`
+    DROP INDEX `UserID_UNIQUE`;
+
+ALTER TABLE `UserGoals`
+    DROP PRIMARY KEY,
+    ADD PRIMARY KEY (`idUserGoals`);
+ALTER TABLE `UserGoals`
+    DROP INDEX `idUserGoals_UNIQUE`;
+
+ALTER TABLE `UserNotes`
+    DROP PRIMARY KEY,
+    ADD PRIMARY KEY (`idUserNotes`);
+ALTER TABLE `UserNotes`
+    DROP INDEX `idUserNotes_UNIQUE`;
+
+ALTER TABLE `Tasks`
+    DROP PRIMARY KEY,
+    ADD PRIMARY KEY (`TaskID`);
+ALTER TABLE `Tasks`
+    DROP INDEX `TaskID_UNIQUE`,
+    ADD INDEX `AsignedTo_Completed_RequiredDelivery_idx` (`AsignedTo`, `Completed`, `RequiredDelivery`),
+    ADD INDEX `AsignedTo_Status_ScheduledStart_idx` (`AsignedTo`, `Status`, `ScheduledStart`),
+    ADD INDEX `AsignedTo_Description_idx` (`AsignedTo`, `Description`),
+    ADD INDEX `ParentTask_AsignedTo_idx` (`ParentTask`, `AsignedTo`);
+-- The new indexes start with AsignedTo, the foreign key no longer needs its own.
+ALTER TABLE `Tasks`
+    DROP INDEX `fk_Tasks_AsignedTo_idx`,
+    DROP INDEX `Description_idx`;
+
+ALTER TABLE `UserScheduleItemTypeEnum`
+    DROP INDEX `idUserScheduleItemTypeEnum_UNIQUE`;
+
+ALTER TABLE `UserDaySchedule`
+    DROP PRIMARY KEY,
+    ADD PRIMARY KEY (`idUserDaySchedule`);
+ALTER TABLE `UserDaySchedule`
+    DROP INDEX `idUserDaySchedule_UNIQUE`;
+
+ALTER TABLE `UserScheduleItem`
+    DROP PRIMARY KEY,
+    ADD PRIMARY KEY (`idUserScheduleItem`);
+ALTER TABLE `UserScheduleItem`
+    DROP INDEX `idUserScheduleItem_UNIQUE`;
+
+ANALYZE TABLE `UserProfile`, `Tasks`;
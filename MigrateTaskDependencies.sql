@@ -0,0 +1,48 @@
+-- --------------------------------------------------------
+-- Moves the task dependencies of an existing PlannerTaskScheduleDB from the
+-- Tasks.Dependencies text column (task IDs separated by ';') to the
+-- TaskDependencies table, then drops the Dependencies and DependencyCount
+-- columns. New databases created by PlannerTaskScheduleDB.sql do not need it.
+--
+-- mysql -u MySQLUser -p < MigrateTaskDependencies.sql
+-- --------------------------------------------------------
+
+USE `PlannerTaskScheduleDB`;
+
+CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`TaskDependencies` (
+    `TaskID` INT UNSIGNED NOT NULL,
+    `DependsOn` INT UNSIGNED NOT NULL,
+    PRIMARY KEY (`TaskID`, `DependsOn`),
+    INDEX `DependsOn_idx` (`DependsOn`, `TaskID`),
+    CONSTRAINT `fk_TaskDependencies_TaskID`
+        FOREIGN KEY (`TaskID`)
+        REFERENCES `Tasks` (`TaskID`)
+        ON DELETE CASCADE
+        ON UPDATE RESTRICT,
+    CONSTRAINT `fk_TaskDependencies_DependsOn`
+        FOREIGN KEY (`DependsOn`)
+        REFERENCES `Tasks` (`TaskID`)
+        ON DELETE RESTRICT
+        ON UPDATE RESTRICT
+);
+
+START TRANSACTION;
+
+-- "3;7;12;" becomes the JSON array [3,7,12] and JSON_TABLE returns one row per ID.
+-- Dependencies on tasks that no longer exist are skipped by INSERT IGNORE.
+INSERT IGNORE INTO `TaskDependencies` (`TaskID`, `DependsOn`)
+    SELECT Tasks.TaskID, Edges.DependsOn
+        FROM Tasks,
+            JSON_TABLE(
+                CONCAT('[', REPLACE(TRIM(TRAILING ';' FROM Tasks.Dependencies), ';', ','), ']'),
+                '$[*]' COLUMNS (`DependsOn` INT UNSIGNED PATH '$')
+            ) AS Edges
+        WHERE Tasks.DependencyCount > 0 AND Tasks.Dependencies IS NOT NULL;
+
+COMMIT;
+
+ALTER TABLE `Tasks`
+    DROP COLUMN `DependencyCount`,
+    DROP COLUMN `Dependencies`;
+
+ANALYZE TABLE `TaskDependencies`;
@@ -2,22 +2,30 @@
 #include <boost/mysql.hpp>
 #include "CommandLineParser.h"
 #include "CoreDBInterface.h"
+#include "DBConnectionPool.h"
+#include "DBExecutionContext.h"
+#include <algorithm>
+#include <exception>
 #include <iostream>
 #include <string>
+#include <vector>
 
 CoreDBInterface::CoreDBInterface()
 :   errorMessages{""},
+    dbConnectionParameters{DBConnectionPool::connectionParametersFromProgramOptions()},
     verboseOutput{programOptions.verboseOutput}
 {
-    dbConnectionParameters.server_address.emplace_host_and_port(programOptions.mySqlUrl, programOptions.mySqlPort);
-    dbConnectionParameters.username = programOptions.mySqlUser;
-    dbConnectionParameters.password = programOptions.mySqlPassword;
-    dbConnectionParameters.database = programOptions.mySqlDBName;
 }
 
+/*
+ * The format options are cached by the connection pool for each connection profile,
+ * only the first model using a profile (or the first after a lost connection) has
+ * to wait for the network.
+ */
 void CoreDBInterface::initFormatOptions()
 {
     try {
+        format_opts = DBConnectionPool::getPool(dbConnectionParameters).getCachedFormatOptions();
         if (!format_opts.has_value())
         {
             format_opts = getConnectionFormatOptsAsync();
@@ -36,81 +44,224 @@ void CoreDBInterface::prepareForRunQueryAsync()
 };
 
 /*
- * All calls to runQueryAsync should be implemented within try blocks.
+ * Coroutine version of prepareForRunQueryAsync(), coroutines running on the shared
+ * executor must not block waiting for the format options.
  */
-NSBM::results CoreDBInterface::runQueryAsync(const std::string& query)
+NSBA::awaitable<void> CoreDBInterface::coRoutinePrepareForRunQuery()
 {
-    NSBM::results localResult;
-    NSBA::io_context ctx;
+    errorMessages.clear();
 
-    NSBA::co_spawn(ctx, coRoutineExecuteSqlStatement(query),
-        [&localResult, this](std::exception_ptr ptr, NSBM::results result)
-        {
-            if (ptr)
-            {
-                std::rethrow_exception(ptr);
-            }
-            localResult = std::move(result);
-        }
-    );
+    try
+    {
+        format_opts = co_await DBConnectionPool::getPool(dbConnectionParameters).asyncGetFormatOptions();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "ERROR: coRoutinePrepareForRunQuery() FAILED: " << e.what() << "\n";
+    }
+}
 
-    ctx.run();
+/*
+ * All calls to runQueryAsync should be implemented within try blocks.
+ */
+NSBM::results CoreDBInterface::runQueryAsync(const std::string& query)
+{
+    return DBExecutionContext::instance().runAndWait(coRoutineExecuteSqlStatement(query));
+}
 
-    return localResult;
+NSBM::results CoreDBInterface::runPreparedQueryAsync(const PreparedQuery& query)
+{
+    return DBExecutionContext::instance().runAndWait(coRoutineExecutePreparedStatement(query));
 }
 
+/*
+ * A failed statement returns the connection to the pool with a session reset, the
+ * reset deallocates any prepared statements on that connection.
+ */
 NSBA::awaitable<NSBM::results> CoreDBInterface::coRoutineExecuteSqlStatement(const std::string& query)
 {
-    NSBM::any_connection conn(co_await NSBA::this_coro::executor);
-
-    co_await conn.async_connect(dbConnectionParameters);
-    
-    NSBM::results selectResult;
-
     if (verboseOutput)
     {
         std::clog << "Running: \n\t" << query << "\n";
     }
 
-    co_await conn.async_execute(query, selectResult);
+    co_return co_await DBConnectionPool::getPool(dbConnectionParameters).asyncExecute(query);
+}
 
-    co_await conn.async_close();
+/*
+ * The statement is prepared the first time its key is used on the pooled connection,
+ * see DBConnectionPool::asyncExecutePrepared().
+ */
+NSBA::awaitable<NSBM::results> CoreDBInterface::coRoutineExecutePreparedStatement(const PreparedQuery& query)
+{
+    if (verboseOutput)
+    {
+        std::clog << "Running prepared " << query.statementKey << ": \n\t" << query.sqlText << "\n";
+    }
 
-    co_return selectResult;
+    co_return co_await DBConnectionPool::getPool(dbConnectionParameters).asyncExecutePrepared(query.statementKey,
+        query.sqlText, query.parameters);
 }
 
 NSBM::format_options CoreDBInterface::getConnectionFormatOptsAsync()
 {
-    NSBM::format_options options;
-    NSBA::io_context ctx;
+    return DBExecutionContext::instance().runAndWait(coRoutineGetFormatOptions());
+}
+
+NSBA::awaitable<NSBM::format_options> CoreDBInterface::coRoutineGetFormatOptions()
+{
+    co_return co_await DBConnectionPool::getPool(dbConnectionParameters).asyncGetFormatOptions();
+}
+
+
+
+std::vector<CoreDBInterface::BatchStatementResult> CoreDBInterface::runBatchAsync(
+    const std::vector<std::string>& statements)
+{
+    return DBExecutionContext::instance().runAndWait(coRoutineExecuteBatch(statements));
+}
+
+NSBA::awaitable<std::vector<CoreDBInterface::BatchStatementResult>> CoreDBInterface::coRoutineExecuteBatch(
+    const std::vector<std::string>& statements)
+{
+    std::vector<BatchStatementResult> batchResults;
+    batchResults.reserve(statements.size());
+
+    if (statements.empty())
+    {
+        co_return batchResults;
+    }
 
-    NSBA::co_spawn(ctx, coRoutineGetFormatOptions(),
-        [&options, this](std::exception_ptr ptr, NSBM::format_options result)
+    DBConnectionPool& pool = DBConnectionPool::getPool(dbConnectionParameters);
+    NSBM::pooled_connection conn = co_await pool.asyncGetConnection();
+    bool allSucceeded = true;
+
+    NSBM::pipeline_request request;
+    std::vector<NSBM::stage_response> responses;
+
+    for (std::size_t chunkStart = 0; chunkStart < statements.size(); chunkStart += MaxStatementsPerPipeline)
+    {
+        std::size_t chunkEnd = std::min(chunkStart + MaxStatementsPerPipeline, statements.size());
+
+        request.clear();
+        for (std::size_t statementIdx = chunkStart; statementIdx < chunkEnd; ++statementIdx)
+        {
+            if (verboseOutput)
+            {
+                std::clog << "Batching: \n\t" << statements[statementIdx] << "\n";
+            }
+            request.add_execute(statements[statementIdx]);
+        }
+
+/*
+ * Per statement errors are reported in the stage responses, the error returned by
+ * the pipeline itself is only fatal if it is a connection level error.
+ */
+        auto [pipelineError] = co_await conn->async_run_pipeline(request, responses,
+            NSBA::as_tuple(NSBA::use_awaitable));
+
+        for (const NSBM::stage_response& response: responses)
         {
-            if (ptr)
+            BatchStatementResult statementResult{true, 0, 0, ""};
+
+            if (response.has_error())
+            {
+                statementResult.succeeded = false;
+                statementResult.errorMessage = std::string(response.diag().server_message());
+                if (statementResult.errorMessage.empty())
+                {
+                    statementResult.errorMessage = response.error().message();
+                }
+                allSucceeded = false;
+            }
+            else
             {
-                std::rethrow_exception(ptr);
+                const NSBM::results& executeResults = response.get_results();
+                statementResult.affectedRows = executeResults.affected_rows();
+                statementResult.lastInsertID = executeResults.last_insert_id();
             }
-            options = std::move(result);
+
+            batchResults.push_back(std::move(statementResult));
+        }
+
+        if (pipelineError && DBConnectionPool::isConnectionLevelError(pipelineError))
+        {
+            pool.invalidateFormatOptions();
+            allSucceeded = false;
+            break;
         }
-    );
+    }
 
-    ctx.run();
+    // Statements that were never sent because the connection failed.
+    while (batchResults.size() < statements.size())
+    {
+        batchResults.push_back(BatchStatementResult{false, 0, 0, "Not executed, connection failed"});
+    }
 
-    return options;
+    if (allSucceeded)
+    {
+        pool.returnWithoutReset(conn);
+    }
+    else
+    {
+        pool.getStatementCache().forgetConnection(conn.get());
+    }
+
+    co_return batchResults;
 }
 
-NSBA::awaitable<NSBM::format_options> CoreDBInterface::coRoutineGetFormatOptions()
+std::vector<CoreDBInterface::BatchStatementResult> CoreDBInterface::runTransactionAsync(
+    const std::vector<std::string>& statements)
 {
-    NSBM::any_connection conn(co_await NSBA::this_coro::executor);
+    return DBExecutionContext::instance().runAndWait(coRoutineExecuteTransaction(statements));
+}
 
-    co_await conn.async_connect(dbConnectionParameters);
+/*
+ * A failed transaction is rolled back before the connection goes back to the pool
+ * with a session reset.
+ */
+NSBA::awaitable<std::vector<CoreDBInterface::BatchStatementResult>> CoreDBInterface::coRoutineExecuteTransaction(
+    const std::vector<std::string>& statements)
+{
+    DBConnectionPool& pool = DBConnectionPool::getPool(dbConnectionParameters);
+    NSBM::pooled_connection conn = co_await pool.asyncGetConnection();
 
-    NSBM::format_options options = conn.format_opts().value();
+    std::vector<BatchStatementResult> transactionResults;
+    transactionResults.reserve(statements.size());
+    std::exception_ptr failure;
+    bool connectionLost = false;
 
-    co_await conn.async_close();
+    try
+    {
+        NSBM::results statementResult;
+        co_await conn->async_execute("START TRANSACTION", statementResult);
 
-    co_return options;
-}
+        for (const std::string& statement: statements)
+        {
+            if (verboseOutput)
+            {
+                std::clog << "Running in transaction: \n\t" << statement << "\n";
+            }
+            co_await conn->async_execute(statement, statementResult);
+            transactionResults.push_back({true, statementResult.affected_rows(), statementResult.last_insert_id(), ""});
+        }
+
+        co_await conn->async_execute("COMMIT", statementResult);
+    }
 
+    catch (const NSBM::error_with_diagnostics& e)
+    {
+        connectionLost = DBConnectionPool::isConnectionLevelError(e.code());
+        failure = std::current_exception();
+    }
 
+    if (failure)
+    {
+        co_await pool.asyncAbandonTransaction(conn, connectionLost);
+        std::rethrow_exception(failure);
+    }
+
+    pool.returnWithoutReset(conn);
+
+    co_return transactionResults;
+}
@@ -3,10 +3,16 @@
 
 #include <boost/asio.hpp>
 #include <boost/mysql.hpp>
+#include <chrono>
 #include "CommandLineParser.h"
+#include <cstdint>
+#include "DBExecutionContext.h"
+#include <expected>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace NSBA = boost::asio;
 namespace NSBM = boost::mysql;
@@ -14,22 +20,156 @@ namespace NSBM = boost::mysql;
 class CoreDBInterface
 {
 public:
+/*
+ * Result of the coroutine interfaces, on failure it contains the error messages.
+ */
+    template<typename ValueType>
+    using DBResult = std::expected<ValueType, std::string>;
+
+/*
+ * The outcome of one statement of a batch.
+ */
+    struct BatchStatementResult
+    {
+        bool succeeded;
+        std::uint64_t affectedRows;
+        std::uint64_t lastInsertID;
+        std::string errorMessage;
+    };
+
+/*
+ * A statement with ? parameter markers that is prepared once per pooled connection
+ * and executed with bound parameters over the binary protocol. The SQL text must
+ * outlive the execution, the models use static text. The gateways run the prepared
+ * statements of the models.
+ */
+    struct PreparedQuery
+    {
+        std::string_view statementKey;
+        std::string_view sqlText;
+        std::vector<NSBM::field> parameters;
+    };
+
     CoreDBInterface();
     virtual ~CoreDBInterface() = default;
     std::string getAllErrorMessages() const noexcept { return errorMessages; };
 
 protected:
     void initFormatOptions();
+/*
+ * The format options are only fetched by the first query of this object, queries
+ * built from QueryTemplates don't need prepareForRunQueryAsync() for each call.
+ */
+    const NSBM::format_options& getFormatOptions()
+    {
+        if (!format_opts.has_value())
+        {
+            initFormatOptions();
+        }
+        return format_opts.value();
+    };
     void prepareForRunQueryAsync();
+    NSBA::awaitable<void> coRoutinePrepareForRunQuery();
+    std::unexpected<std::string> operationFailed(const std::string& newError)
+    {
+        appendErrorMessage(newError);
+        return std::unexpected(errorMessages);
+    };
+/*
+ * The blocking interfaces wait for their coroutine versions on the shared executor.
+ */
+    template<typename ResultType>
+    ResultType waitForCoRoutine(NSBA::awaitable<ResultType> work)
+    {
+        return DBExecutionContext::instance().runAndWait(std::move(work));
+    }
     void appendErrorMessage(const std::string& newError) { errorMessages.append(newError); errorMessages.append("\n");};
 /*
  * All calls to runQueryAsync and getConnectionFormatOptsAsync should be
  * implemented within try blocks.
  */
     NSBM::results runQueryAsync(const std::string& query);
+    NSBM::results runPreparedQueryAsync(const PreparedQuery& query);
     NSBM::format_options getConnectionFormatOptsAsync();
     NSBA::awaitable<NSBM::results> coRoutineExecuteSqlStatement(const std::string& query);
+    NSBA::awaitable<NSBM::results> coRoutineExecutePreparedStatement(const PreparedQuery& query);
     NSBA::awaitable<NSBM::format_options> coRoutineGetFormatOptions();
+/*
+ * Execute many independent statements on one pooled connection using the MySQL
+ * pipeline, up to MaxStatementsPerPipeline statements are sent in each round trip.
+ * A failed statement does not stop the statements after it, the results are in the
+ * same order as the statements.
+ */
+    std::vector<BatchStatementResult> runBatchAsync(const std::vector<std::string>& statements);
+    NSBA::awaitable<std::vector<BatchStatementResult>> coRoutineExecuteBatch(const std::vector<std::string>& statements);
+    static constexpr std::size_t MaxStatementsPerPipeline = 256;
+/*
+ * Execute the statements in order inside one transaction on one pooled connection.
+ * The transaction is committed when every statement succeeds, otherwise it is
+ * rolled back and the error is thrown.
+ */
+    std::vector<BatchStatementResult> runTransactionAsync(const std::vector<std::string>& statements);
+    NSBA::awaitable<std::vector<BatchStatementResult>> coRoutineExecuteTransaction(
+        const std::vector<std::string>& statements);
+
+/*
+ * Conversions between the std::chrono types used by the models and records and the
+ * MySQL types.
+ */
+    static NSBM::date stdchronoDateToBoostMySQLDate(const std::chrono::year_month_day& source) noexcept
+    {
+        std::chrono::sys_days tp = source;
+        return NSBM::date(tp);
+    };
+
+    static std::chrono::year_month_day boostMysqlDateToChronoDate(const NSBM::date& source) noexcept
+    {
+        const std::chrono::year year{source.year()};
+        const std::chrono::month month{source.month()};
+        const std::chrono::day day{source.day()};
+        return std::chrono::year_month_day{year, month, day};
+    };
+
+    static NSBM::datetime stdChronoTimePointToBoostDateTime(std::chrono::system_clock::time_point source) noexcept
+    {
+        return NSBM::datetime(std::chrono::time_point_cast<boost::mysql::datetime::time_point::duration>(source));
+    };
+
+    static std::chrono::system_clock::time_point boostMysqlDateTimeToChronoTimePoint(NSBM::datetime dbDateTime)
+    {
+        return std::chrono::time_point_cast<std::chrono::system_clock::time_point::duration>(dbDateTime.as_time_point());
+    }
+
+    static std::optional<NSBM::date> optionalDateConversion(std::optional<std::chrono::year_month_day> optDate)
+    {
+        std::optional<NSBM::date> mySqlDate;
+
+        if (optDate.has_value())
+        {
+            mySqlDate = stdchronoDateToBoostMySQLDate(optDate.value());
+        }
+        return mySqlDate;
+    };
+
+    static std::optional<NSBM::datetime> optionalDateTimeConversion(std::optional<std::chrono::system_clock::time_point> optDateTime)
+    {
+        std::optional<NSBM::datetime> timeStamp;
+
+        if (optDateTime.has_value())
+        {
+            timeStamp = stdChronoTimePointToBoostDateTime(optDateTime.value());
+        }
+        return timeStamp;
+    };
+
+/*
+ * Prepared statement parameters, an empty optional is bound as NULL.
+ */
+    template<typename ValueType>
+    static NSBM::field optionalToField(const std::optional<ValueType>& optionalValue)
+    {
+        return optionalValue.has_value()? NSBM::field(optionalValue.value()) : NSBM::field();
+    }
 
     std::string errorMessages;
     NSBM::connect_params dbConnectionParameters;
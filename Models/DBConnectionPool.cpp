@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <chrono>
+#include "CommandLineParser.h"
+#include "DBConnectionPool.h"
+#include "DBExecutionContext.h"
+#include <exception>
+#include <format>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+std::mutex DBConnectionPool::poolsMutex;
+
+static NSBM::pool_params buildPoolParams(const NSBM::connect_params& connectionParameters,
+    const DBConnectionPool::PoolLimits& limits)
+{
+    NSBM::pool_params params;
+
+    params.server_address = connectionParameters.server_address;
+    params.username = connectionParameters.username;
+    params.password = connectionParameters.password;
+    params.database = connectionParameters.database;
+    params.initial_size = limits.initialSize;
+    params.max_size = std::max(limits.maxSize, limits.initialSize);
+    params.ping_interval = limits.idlePingInterval;
+    params.connect_timeout = limits.connectTimeout;
+/*
+ * The execution context is a thread pool, connections are requested and returned
+ * from more than one thread.
+ */
+    params.thread_safe = true;
+
+    return params;
+}
+
+DBConnectionPool::DBConnectionPool(const NSBM::connect_params& connectionParameters, PoolLimits poolLimits)
+:   limits{poolLimits},
+    pool{DBExecutionContext::instance().getExecutor(), buildPoolParams(connectionParameters, poolLimits)},
+    connectionsRequested{0},
+    totalWaitMicroseconds{0},
+    maxWaitMicroseconds{0}
+{
+    poolName = std::format("{}@{}", connectionParameters.username, connectionParameters.database);
+
+    pool.async_run(NSBA::detached);
+}
+
+DBConnectionPool::~DBConnectionPool()
+{
+    pool.cancel();
+}
+
+DBConnectionPool& DBConnectionPool::getPool(const NSBM::connect_params& connectionParameters)
+{
+    PoolKey key = makePoolKey(connectionParameters);
+
+    std::lock_guard<std::mutex> guard(poolsMutex);
+    PoolMap& pools = allPools();
+
+    auto existingPool = pools.find(key);
+    if (existingPool != pools.end())
+    {
+        return *existingPool->second;
+    }
+
+    std::unique_ptr<DBConnectionPool> newPool(new DBConnectionPool(connectionParameters, limitsFromProgramOptions()));
+    DBConnectionPool& poolRef = *newPool;
+    pools.emplace(std::move(key), std::move(newPool));
+
+    return poolRef;
+}
+
+NSBM::connect_params DBConnectionPool::connectionParametersFromProgramOptions()
+{
+    NSBM::connect_params connectionParameters;
+
+    connectionParameters.server_address.emplace_host_and_port(programOptions.mySqlUrl, programOptions.mySqlPort);
+    connectionParameters.username = programOptions.mySqlUser;
+    connectionParameters.password = programOptions.mySqlPassword;
+    connectionParameters.database = programOptions.mySqlDBName;
+
+    return connectionParameters;
+}
+
+void DBConnectionPool::reportAllPoolStatistics(std::ostream& os)
+{
+    std::lock_guard<std::mutex> guard(poolsMutex);
+
+    for (const auto& [key, pool]: allPools())
+    {
+        pool->reportWaitStatistics(os);
+    }
+}
+
+NSBA::awaitable<NSBM::pooled_connection> DBConnectionPool::asyncGetConnection()
+{
+    std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+
+    NSBM::pooled_connection conn = co_await pool.async_get_connection();
+
+    recordWait(std::chrono::steady_clock::now() - waitStart);
+    statementCache.claimConnection(conn.get());
+
+    co_return conn;
+}
+
+void DBConnectionPool::returnWithoutReset(NSBM::pooled_connection& conn)
+{
+    statementCache.keepConnection(conn.get());
+    conn.return_without_reset();
+}
+
+NSBA::awaitable<NSBM::format_options> DBConnectionPool::asyncGetFormatOptions()
+{
+    std::optional<NSBM::format_options> cachedOptions = getCachedFormatOptions();
+    if (cachedOptions.has_value())
+    {
+        co_return cachedOptions.value();
+    }
+
+    NSBM::pooled_connection conn = co_await asyncGetConnection();
+    NSBM::format_options options = conn->format_opts().value();
+
+    {
+        std::lock_guard<std::mutex> guard(formatOptionsMutex);
+        formatOptions = options;
+    }
+
+    co_return options;
+}
+
+NSBA::awaitable<NSBM::results> DBConnectionPool::asyncExecute(const std::string& query)
+{
+    NSBM::pooled_connection conn = co_await asyncGetConnection();
+
+    NSBM::results selectResult;
+
+    try
+    {
+        co_await conn->async_execute(query, selectResult);
+    }
+
+    catch (const NSBM::error_with_diagnostics& e)
+    {
+        statementCache.forgetConnection(conn.get());
+        if (isConnectionLevelError(e.code()))
+        {
+            invalidateFormatOptions();
+        }
+        throw;
+    }
+
+    returnWithoutReset(conn);
+
+    co_return selectResult;
+}
+
+/*
+ * If the server no longer knows the statement the session was replaced, every
+ * statement cached for the connection is dropped, since their IDs may now belong to
+ * other statements, and the execution is retried once with a new statement.
+ */
+NSBA::awaitable<NSBM::results> DBConnectionPool::asyncExecutePrepared(std::string_view statementKey,
+    std::string_view sqlText, const std::vector<NSBM::field>& parameters)
+{
+    NSBM::pooled_connection conn = co_await asyncGetConnection();
+
+    NSBM::results statementResult;
+
+    constexpr int maxAttempts = 2;
+    for (int attempt = 1; attempt <= maxAttempts; ++attempt)
+    {
+        std::exception_ptr failure;
+        bool retry = false;
+
+        try
+        {
+            NSBM::statement stmt = co_await statementCache.asyncGetStatement(conn.get(), statementKey, sqlText);
+            co_await conn->async_execute(stmt.bind(parameters.begin(), parameters.end()), statementResult);
+        }
+
+        catch (const NSBM::error_with_diagnostics& e)
+        {
+            if (e.code() == NSBM::common_server_errc::er_unknown_stmt_handler && attempt < maxAttempts)
+            {
+                statementCache.forgetConnection(conn.get());
+                retry = true;
+            }
+            else
+            {
+                statementCache.forgetConnection(conn.get());
+                if (isConnectionLevelError(e.code()))
+                {
+                    invalidateFormatOptions();
+                }
+                failure = std::current_exception();
+            }
+        }
+
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+
+        if (!retry)
+        {
+            break;
+        }
+    }
+
+    returnWithoutReset(conn);
+
+    co_return statementResult;
+}
+
+NSBA::awaitable<void> DBConnectionPool::asyncAbandonTransaction(NSBM::pooled_connection& conn, bool connectionLost)
+{
+    statementCache.forgetConnection(conn.get());
+    if (connectionLost)
+    {
+        invalidateFormatOptions();
+        co_return;
+    }
+
+    // A failed rollback is covered by the session reset.
+    NSBM::results rollbackResult;
+    co_await conn->async_execute("ROLLBACK", rollbackResult, NSBA::as_tuple(NSBA::use_awaitable));
+}
+
+std::optional<NSBM::format_options> DBConnectionPool::getCachedFormatOptions() const
+{
+    std::lock_guard<std::mutex> guard(formatOptionsMutex);
+
+    return formatOptions;
+}
+
+void DBConnectionPool::invalidateFormatOptions() noexcept
+{
+    std::lock_guard<std::mutex> guard(formatOptionsMutex);
+
+    formatOptions.reset();
+}
+
+/*
+ * Errors reported by the server leave the connection usable, anything else (network,
+ * TLS, protocol) means the connection will be re-established by the pool.
+ */
+bool DBConnectionPool::isConnectionLevelError(const boost::system::error_code& errorCode) noexcept
+{
+    return errorCode.category() != NSBM::get_common_server_category() &&
+        errorCode.category() != NSBM::get_mysql_server_category() &&
+        errorCode.category() != NSBM::get_mariadb_server_category();
+}
+
+DBConnectionPool::WaitStatistics DBConnectionPool::getWaitStatistics() const noexcept
+{
+    WaitStatistics stats;
+
+    stats.connectionsRequested = connectionsRequested.load(std::memory_order_relaxed);
+    stats.totalWait = std::chrono::microseconds(totalWaitMicroseconds.load(std::memory_order_relaxed));
+    stats.maxWait = std::chrono::microseconds(maxWaitMicroseconds.load(std::memory_order_relaxed));
+
+    return stats;
+}
+
+void DBConnectionPool::reportWaitStatistics(std::ostream& os) const
+{
+    WaitStatistics stats = getWaitStatistics();
+
+    os << std::format("Connection pool {} (initial {}, max {}): {} connections requested, "
+        "average wait {}, maximum wait {}, total wait {}\n",
+        poolName, limits.initialSize, limits.maxSize, stats.connectionsRequested,
+        stats.averageWait(), stats.maxWait, stats.totalWait);
+}
+
+DBConnectionPool::PoolLimits DBConnectionPool::limitsFromProgramOptions() noexcept
+{
+    PoolLimits poolLimits;
+
+    poolLimits.initialSize = programOptions.dbPoolInitialSize;
+    poolLimits.maxSize = programOptions.dbPoolMaxSize;
+    poolLimits.idlePingInterval = std::chrono::seconds(programOptions.dbPoolIdlePingSeconds);
+    poolLimits.connectTimeout = std::chrono::seconds(20);
+
+    return poolLimits;
+}
+
+void DBConnectionPool::recordWait(std::chrono::steady_clock::duration waited) noexcept
+{
+    std::uint64_t waitedMicroseconds = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(waited).count());
+
+    connectionsRequested.fetch_add(1, std::memory_order_relaxed);
+    totalWaitMicroseconds.fetch_add(waitedMicroseconds, std::memory_order_relaxed);
+
+    std::uint64_t currentMax = maxWaitMicroseconds.load(std::memory_order_relaxed);
+    while (waitedMicroseconds > currentMax &&
+        !maxWaitMicroseconds.compare_exchange_weak(currentMax, waitedMicroseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+/*
+ * The execution context is created before the pool map so that the pools are
+ * destroyed (cancelled) before the threads that run them are stopped.
+ */
+DBConnectionPool::PoolMap& DBConnectionPool::allPools()
+{
+    DBExecutionContext::instance();
+    static PoolMap pools;
+
+    return pools;
+}
+
+DBConnectionPool::PoolKey DBConnectionPool::makePoolKey(const NSBM::connect_params& connectionParameters)
+{
+    const NSBM::any_address& address = connectionParameters.server_address;
+    std::string location;
+    unsigned short port = 0;
+
+    if (address.type() == NSBM::address_type::host_and_port)
+    {
+        location = address.hostname();
+        port = address.port();
+    }
+    else
+    {
+        location = address.unix_socket_path();
+    }
+
+    return PoolKey{location, port, connectionParameters.username, connectionParameters.password,
+        connectionParameters.database};
+}
+
@@ -0,0 +1,130 @@
+#ifndef DBCONNECTIONPOOL_H_
+#define DBCONNECTIONPOOL_H_
+
+#include <atomic>
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "PreparedStatementCache.h"
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace NSBA = boost::asio;
+namespace NSBM = boost::mysql;
+
+/*
+ * Process wide pool of authenticated MySQL connections.
+ *
+ * There is one pool for each set of connection parameters (server address, user,
+ * password and database). Every ModelDBInterface and ListDBInterface object with
+ * the same connection parameters shares the same pool, so the TCP/TLS handshake
+ * and authentication are paid once per connection rather than once per statement.
+ *
+ * A connection goes back to the pool when the NSBM::pooled_connection that holds
+ * it is destroyed. The pool resets the session state (COM_RESET_CONNECTION) before
+ * the connection is handed out again. A reset also deallocates the connection's
+ * prepared statements, so callers that know they left no session state behind
+ * (a single autocommit statement that succeeded) return the connection with
+ * returnWithoutReset() to keep the statements in the PreparedStatementCache.
+ *
+ * The pool opens its initial connections at startup and more as needed, up to the
+ * maximum. Connections are not closed when they become idle, a pool keeps every
+ * connection it opened until the connection fails.
+ *
+ * The pools run on the application wide DBExecutionContext.
+ *
+ * Each pool also caches the format options (character set and backslash escapes)
+ * of its server, they are read from the first connection and only read again after
+ * a connection level failure, when the server may have been restarted or replaced.
+ */
+class DBConnectionPool
+{
+public:
+    struct PoolLimits
+    {
+        std::size_t initialSize;                // Connections opened at startup.
+        std::size_t maxSize;                    // Upper limit of open connections.
+        std::chrono::seconds idlePingInterval;  // Idle connections are checked this often.
+        std::chrono::seconds connectTimeout;
+    };
+
+    struct WaitStatistics
+    {
+        std::uint64_t connectionsRequested;
+        std::chrono::microseconds totalWait;
+        std::chrono::microseconds maxWait;
+        std::chrono::microseconds averageWait() const noexcept
+        {
+            return connectionsRequested ? totalWait / connectionsRequested : std::chrono::microseconds{0};
+        };
+    };
+
+    ~DBConnectionPool();
+    DBConnectionPool(const DBConnectionPool&) = delete;
+    DBConnectionPool& operator=(const DBConnectionPool&) = delete;
+
+/*
+ * Returns the pool for the connection parameters, the pool is created on first use.
+ */
+    static DBConnectionPool& getPool(const NSBM::connect_params& connectionParameters);
+    static NSBM::connect_params connectionParametersFromProgramOptions();
+    static void reportAllPoolStatistics(std::ostream& os);
+
+    NSBA::awaitable<NSBM::pooled_connection> asyncGetConnection();
+    void returnWithoutReset(NSBM::pooled_connection& conn);
+    NSBA::awaitable<NSBM::format_options> asyncGetFormatOptions();
+    std::optional<NSBM::format_options> getCachedFormatOptions() const;
+    void invalidateFormatOptions() noexcept;
+    PreparedStatementCache& getStatementCache() noexcept { return statementCache; };
+    static bool isConnectionLevelError(const boost::system::error_code& errorCode) noexcept;
+    WaitStatistics getWaitStatistics() const noexcept;
+    void reportWaitStatistics(std::ostream& os) const;
+    PoolLimits getPoolLimits() const noexcept { return limits; };
+/*
+ * Run one statement on a pooled connection, a prepared statement is prepared the
+ * first time its key is used on the connection. Errors are thrown. A connection
+ * that fails a statement goes back to the pool with a session reset.
+ */
+    NSBA::awaitable<NSBM::results> asyncExecute(const std::string& query);
+    NSBA::awaitable<NSBM::results> asyncExecutePrepared(std::string_view statementKey, std::string_view sqlText,
+        const std::vector<NSBM::field>& parameters);
+/*
+ * Ends a transaction that failed on conn. A connection that is still up is rolled
+ * back, either way the connection goes back to the pool with a session reset.
+ */
+    NSBA::awaitable<void> asyncAbandonTransaction(NSBM::pooled_connection& conn, bool connectionLost);
+
+private:
+    DBConnectionPool(const NSBM::connect_params& connectionParameters, PoolLimits poolLimits);
+    static PoolLimits limitsFromProgramOptions() noexcept;
+    void recordWait(std::chrono::steady_clock::duration waited) noexcept;
+
+    using PoolKey = std::tuple<std::string, unsigned short, std::string, std::string, std::string>;
+    using PoolMap = std::map<PoolKey, std::unique_ptr<DBConnectionPool>>;
+    static PoolKey makePoolKey(const NSBM::connect_params& connectionParameters);
+    static PoolMap& allPools();
+
+    std::string poolName;
+    PoolLimits limits;
+    NSBM::connection_pool pool;
+    mutable std::mutex formatOptionsMutex;
+    std::optional<NSBM::format_options> formatOptions;
+    PreparedStatementCache statementCache;
+
+    std::atomic<std::uint64_t> connectionsRequested;
+    std::atomic<std::uint64_t> totalWaitMicroseconds;
+    std::atomic<std::uint64_t> maxWaitMicroseconds;
+
+    static std::mutex poolsMutex;
+};
+
+#endif // DBCONNECTIONPOOL_H_
+
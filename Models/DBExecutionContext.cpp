@@ -0,0 +1,21 @@
+#include <algorithm>
+#include <boost/asio.hpp>
+#include "CommandLineParser.h"
+#include "DBExecutionContext.h"
+
+DBExecutionContext::DBExecutionContext(std::size_t threadCountIn)
+:   threadCount{std::max<std::size_t>(threadCountIn, 1)},
+    threads{threadCount}
+{
+}
+
+/*
+ * Created on first use, the thread count is read from the program options.
+ */
+DBExecutionContext& DBExecutionContext::instance()
+{
+    static DBExecutionContext executionContext(programOptions.dbExecutorThreads);
+
+    return executionContext;
+}
+
@@ -0,0 +1,47 @@
+#ifndef DBEXECUTIONCONTEXT_H_
+#define DBEXECUTIONCONTEXT_H_
+
+#include <boost/asio.hpp>
+#include <cstddef>
+#include <utility>
+
+namespace NSBA = boost::asio;
+
+/*
+ * The single application wide execution context for all database work.
+ *
+ * An NSBA::thread_pool with a configurable number of threads runs every database
+ * coroutine, the connection pools and their timers. The blocking interfaces of
+ * the models and lists are thin waits on the futures returned by runAndWait(),
+ * so concurrent callers share the event loop rather than each building their own.
+ *
+ * runAndWait() must not be called from one of the execution context threads, the
+ * calling thread blocks until the coroutine completes.
+ */
+class DBExecutionContext
+{
+public:
+    ~DBExecutionContext() = default;
+    DBExecutionContext(const DBExecutionContext&) = delete;
+    DBExecutionContext& operator=(const DBExecutionContext&) = delete;
+
+    static DBExecutionContext& instance();
+
+    NSBA::any_io_executor getExecutor() noexcept { return threads.get_executor(); };
+    std::size_t getThreadCount() const noexcept { return threadCount; };
+
+    template<typename ResultType>
+    ResultType runAndWait(NSBA::awaitable<ResultType> work)
+    {
+        return NSBA::co_spawn(threads, std::move(work), NSBA::use_future).get();
+    }
+
+private:
+    explicit DBExecutionContext(std::size_t threadCountIn);
+
+    std::size_t threadCount;
+    NSBA::thread_pool threads;
+};
+
+#endif // DBEXECUTIONCONTEXT_H_
+
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <chrono>
+#include "DaySchedulePlan.h"
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+DaySchedulePlan::DaySchedulePlan(std::chrono::sys_days firstDayIn, std::size_t dayCount,
+    std::chrono::minutes dayStartIn, std::chrono::minutes dayEndIn)
+: firstDay{firstDayIn}, dayStart{dayStartIn}, dayEnd{std::max(dayStartIn, dayEndIn)},
+  busyByDay(dayCount), blocksByDay(dayCount)
+{
+}
+
+/*
+ * Only busy times inside the days of the plan are kept, call before schedule().
+ */
+void DaySchedulePlan::setBusyTimes(std::span<const BusyTime> busyTimes)
+{
+    busyByDay.assign(blocksByDay.size(), {});
+    for (const BusyTime& busy: busyTimes)
+    {
+        if (busy.day >= firstDay && dayIndex(busy.day) < busyByDay.size() && busy.start < busy.end)
+        {
+            busyByDay[dayIndex(busy.day)].emplace_back(busy.start, busy.end);
+        }
+    }
+
+    for (TimeRanges& busyDay: busyByDay)
+    {
+        std::ranges::sort(busyDay);
+    }
+}
+
+void DaySchedulePlan::schedule(std::vector<PlanTask> tasksIn)
+{
+    tasks = std::move(tasksIn);
+    std::ranges::stable_sort(tasks, isPlacedBefore);
+
+    RemainingEffort remaining = remainingBefore(0);
+    for (std::size_t day = 0; day < blocksByDay.size(); ++day)
+    {
+        placeDay(day, remaining);
+    }
+    lastRecomputedDayCount = blocksByDay.size();
+}
+
+/*
+ * Adds the task when it isn't in the plan.
+ */
+DaySchedulePlan::DayRange DaySchedulePlan::updateTask(const PlanTask& changedTask)
+{
+    if (std::ranges::find(tasks, changedTask) != tasks.end())
+    {
+        lastRecomputedDayCount = 0;
+        return {firstDay, firstDay};
+    }
+
+    const std::size_t newFirstDay = dayIndex(changedTask.scheduledStart);
+    const std::size_t startDay = std::min(firstBlockDay(changedTask.taskID), newFirstDay);
+    RemainingEffort previousRemaining = remainingBefore(startDay);
+
+    std::erase_if(tasks, [&changedTask](const PlanTask& task) { return task.taskID == changedTask.taskID; });
+    tasks.insert(std::ranges::upper_bound(tasks, changedTask, isPlacedBefore), changedTask);
+
+    return recomputeFrom(startDay, std::move(previousRemaining), changedTask.taskID);
+}
+
+DaySchedulePlan::DayRange DaySchedulePlan::removeTask(std::size_t taskID)
+{
+    if (!hasTask(taskID))
+    {
+        lastRecomputedDayCount = 0;
+        return {firstDay, firstDay};
+    }
+
+    const std::size_t startDay = firstBlockDay(taskID);
+    RemainingEffort previousRemaining = remainingBefore(startDay);
+    std::erase_if(tasks, [taskID](const PlanTask& task) { return task.taskID == taskID; });
+
+    return recomputeFrom(startDay, std::move(previousRemaining), taskID);
+}
+
+bool DaySchedulePlan::hasTask(std::size_t taskID) const
+{
+    return std::ranges::any_of(tasks, [taskID](const PlanTask& task) { return task.taskID == taskID; });
+}
+
+DaySchedulePlan::DayRange DaySchedulePlan::getTaskDays(std::size_t taskID) const
+{
+    const std::size_t firstTaskDay = firstBlockDay(taskID);
+    std::size_t lastTaskDay = firstTaskDay;
+    for (std::size_t day = firstTaskDay; day < blocksByDay.size(); ++day)
+    {
+        if (std::ranges::any_of(blocksByDay[day], [taskID](const TaskBlock& block) { return block.taskID == taskID; }))
+        {
+            lastTaskDay = day + 1;
+        }
+    }
+
+    return {firstDay + std::chrono::days(firstTaskDay), firstDay + std::chrono::days(lastTaskDay)};
+}
+
+std::span<const DaySchedulePlan::TaskBlock> DaySchedulePlan::getBlocks(std::chrono::sys_days day) const
+{
+    if (day < firstDay || dayIndex(day) >= blocksByDay.size())
+    {
+        return {};
+    }
+
+    return blocksByDay[dayIndex(day)];
+}
+
+std::vector<DaySchedulePlan::TaskBlock> DaySchedulePlan::getBlocks(DayRange days) const
+{
+    std::vector<TaskBlock> blocks;
+    for (std::chrono::sys_days day = days.first; day < days.last; day += std::chrono::days(1))
+    {
+        std::span<const TaskBlock> dayBlocks = getBlocks(day);
+        blocks.insert(blocks.end(), dayBlocks.begin(), dayBlocks.end());
+    }
+
+    return blocks;
+}
+
+std::vector<std::size_t> DaySchedulePlan::getLateTaskIDs() const
+{
+    RemainingEffort unplaced = remainingBefore(blocksByDay.size());
+    std::unordered_map<std::size_t, std::chrono::sys_days> lastDay;
+    for (const std::vector<TaskBlock>& dayBlocks: blocksByDay)
+    {
+        for (const TaskBlock& block: dayBlocks)
+        {
+            lastDay[block.taskID] = block.day;
+        }
+    }
+
+    std::vector<std::size_t> lateTaskIDs;
+    for (const PlanTask& task: tasks)
+    {
+        auto taskLastDay = lastDay.find(task.taskID);
+        if (unplaced.contains(task.taskID) ||
+            (taskLastDay != lastDay.end() && taskLastDay->second > task.requiredDelivery))
+        {
+            lateTaskIDs.push_back(task.taskID);
+        }
+    }
+
+    return lateTaskIDs;
+}
+
+bool DaySchedulePlan::isPlacedBefore(const PlanTask& first, const PlanTask& second) noexcept
+{
+    return std::tie(first.priorityGroup, first.priorityInGroup, first.requiredDelivery, first.remainingEffort,
+        first.taskID) < std::tie(second.priorityGroup, second.priorityInGroup, second.requiredDelivery,
+        second.remainingEffort, second.taskID);
+}
+
+/*
+ * Days before the plan are day 0, days after it are the day count.
+ */
+std::size_t DaySchedulePlan::dayIndex(std::chrono::sys_days day) const noexcept
+{
+    if (day <= firstDay)
+    {
+        return 0;
+    }
+
+    return std::min(static_cast<std::size_t>((day - firstDay).count()), blocksByDay.size());
+}
+
+std::size_t DaySchedulePlan::firstBlockDay(std::size_t taskID) const
+{
+    for (std::size_t day = 0; day < blocksByDay.size(); ++day)
+    {
+        if (std::ranges::any_of(blocksByDay[day], [taskID](const TaskBlock& block) { return block.taskID == taskID; }))
+        {
+            return day;
+        }
+    }
+
+    return blocksByDay.size();
+}
+
+DaySchedulePlan::TimeRanges DaySchedulePlan::freeTime(std::size_t day) const
+{
+    TimeRanges free;
+    std::chrono::minutes freeStart = dayStart;
+    for (const auto& [busyStart, busyEnd]: busyByDay[day])
+    {
+        if (busyStart > freeStart)
+        {
+            free.emplace_back(freeStart, std::min(busyStart, dayEnd));
+        }
+        freeStart = std::max(freeStart, busyEnd);
+        if (freeStart >= dayEnd)
+        {
+            break;
+        }
+    }
+    if (freeStart < dayEnd)
+    {
+        free.emplace_back(freeStart, dayEnd);
+    }
+
+    return free;
+}
+
+/*
+ * The effort of each task less its blocks before the day, tasks with no effort
+ * left are not in the map.
+ */
+DaySchedulePlan::RemainingEffort DaySchedulePlan::remainingBefore(std::size_t day) const
+{
+    RemainingEffort remaining;
+    for (const PlanTask& task: tasks)
+    {
+        if (task.remainingEffort > std::chrono::minutes(0))
+        {
+            remaining[task.taskID] = task.remainingEffort;
+        }
+    }
+
+    for (std::size_t earlierDay = 0; earlierDay < day; ++earlierDay)
+    {
+        subtractBlocks(blocksByDay[earlierDay], remaining);
+    }
+
+    return remaining;
+}
+
+void DaySchedulePlan::placeDay(std::size_t day, RemainingEffort& remaining)
+{
+    const std::chrono::sys_days date = firstDay + std::chrono::days(day);
+    std::vector<TaskBlock>& dayBlocks = blocksByDay[day];
+    dayBlocks.clear();
+    TimeRanges free = freeTime(day);
+
+    for (const PlanTask& task: tasks)
+    {
+        auto taskEffort = remaining.find(task.taskID);
+        if (taskEffort == remaining.end() || dayIndex(task.scheduledStart) > day)
+        {
+            continue;
+        }
+
+        for (auto& [freeStart, freeEnd]: free)
+        {
+            std::chrono::minutes length = freeEnd - freeStart;
+            if (length <= std::chrono::minutes(0) || (length < MinimumBlock && length < taskEffort->second))
+            {
+                continue;
+            }
+
+            std::chrono::minutes taken = std::min(length, taskEffort->second);
+            dayBlocks.push_back({task.taskID, date, freeStart, freeStart + taken});
+            freeStart += taken;
+            taskEffort->second -= taken;
+            if (taskEffort->second <= std::chrono::minutes(0))
+            {
+                break;
+            }
+        }
+
+        if (taskEffort->second <= std::chrono::minutes(0))
+        {
+            remaining.erase(taskEffort);
+        }
+    }
+
+    std::ranges::sort(dayBlocks, {}, &TaskBlock::start);
+}
+
+void DaySchedulePlan::subtractBlocks(const std::vector<TaskBlock>& blocks, RemainingEffort& remaining)
+{
+    for (const TaskBlock& block: blocks)
+    {
+        auto taskEffort = remaining.find(block.taskID);
+        if (taskEffort == remaining.end())
+        {
+            continue;
+        }
+        taskEffort->second -= block.end - block.start;
+        if (taskEffort->second <= std::chrono::minutes(0))
+        {
+            remaining.erase(taskEffort);
+        }
+    }
+}
+
+/*
+ * previousRemaining is the effort left at the start of startDay before the change.
+ * Each day is placed again until the effort left at the end of a day is the same
+ * as before, the days after it would be placed as they already are unless the
+ * changed task, which can now be placed in a different order, still has effort left.
+ */
+DaySchedulePlan::DayRange DaySchedulePlan::recomputeFrom(std::size_t startDay, RemainingEffort previousRemaining,
+    std::size_t changedTaskID)
+{
+    RemainingEffort remaining = remainingBefore(startDay);
+    std::size_t day = startDay;
+    while (day < blocksByDay.size())
+    {
+        subtractBlocks(blocksByDay[day], previousRemaining);
+        placeDay(day, remaining);
+        ++day;
+        if (remaining == previousRemaining && !remaining.contains(changedTaskID))
+        {
+            break;
+        }
+    }
+
+    lastRecomputedDayCount = day - startDay;
+    return {firstDay + std::chrono::days(startDay), firstDay + std::chrono::days(day)};
+}
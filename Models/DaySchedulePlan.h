@@ -0,0 +1,129 @@
+#ifndef DAYSCHEDULEPLAN_H_
+#define DAYSCHEDULEPLAN_H_
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+ * Places the remaining effort of a user's tasks into the working hours of a range
+ * of days, around the times that are already taken by other schedule items.
+ *
+ * The days are filled in order. On each day the tasks are placed in priority
+ * order, SchedulePriorityGroup then PriorityInGroup, then the earliest
+ * RequiredDelivery, then the least remaining effort, each task taking the
+ * earliest free time from its ScheduledStart on. A task is not given a gap shorter
+ * than MinimumBlock unless the gap finishes the task.
+ *
+ * Because each day only depends on the effort left at the end of the day before,
+ * a change to one task only changes the days from the first day the task had or
+ * can have time, and only until the effort left at the end of a day is the same
+ * as it was before the change and the changed task has no effort left.
+ * updateTask() and removeTask() recompute those days and return them.
+ */
+class DaySchedulePlan
+{
+public:
+    struct PlanTask
+    {
+        std::size_t taskID;
+        unsigned int priorityGroup;
+        unsigned int priorityInGroup;
+        std::chrono::sys_days requiredDelivery;
+        std::chrono::sys_days scheduledStart;
+        std::chrono::minutes remainingEffort;
+
+        bool operator==(const PlanTask& other) const = default;
+    };
+
+/*
+ * Times are minutes from the start of the day.
+ */
+    struct BusyTime
+    {
+        std::chrono::sys_days day;
+        std::chrono::minutes start;
+        std::chrono::minutes end;
+    };
+
+    struct TaskBlock
+    {
+        std::size_t taskID;
+        std::chrono::sys_days day;
+        std::chrono::minutes start;
+        std::chrono::minutes end;
+
+        bool operator==(const TaskBlock& other) const = default;
+    };
+
+/*
+ * The days [first, last), empty when nothing changed.
+ */
+    struct DayRange
+    {
+        std::chrono::sys_days first;
+        std::chrono::sys_days last;
+
+        bool empty() const noexcept { return first >= last; };
+    };
+
+    static constexpr std::chrono::minutes MinimumBlock{15};
+
+    DaySchedulePlan() = default;
+    DaySchedulePlan(std::chrono::sys_days firstDayIn, std::size_t dayCount, std::chrono::minutes dayStartIn,
+        std::chrono::minutes dayEndIn);
+    ~DaySchedulePlan() = default;
+
+    void setBusyTimes(std::span<const BusyTime> busyTimes);
+/*
+ * Replaces the tasks and schedules every day.
+ */
+    void schedule(std::vector<PlanTask> tasksIn);
+    DayRange updateTask(const PlanTask& changedTask);
+    DayRange removeTask(std::size_t taskID);
+
+    std::chrono::sys_days getFirstDay() const noexcept { return firstDay; };
+    std::size_t getDayCount() const noexcept { return blocksByDay.size(); };
+    DayRange getAllDays() const noexcept { return {firstDay, firstDay + std::chrono::days(getDayCount())}; };
+    std::chrono::minutes getDayStart() const noexcept { return dayStart; };
+    std::chrono::minutes getDayEnd() const noexcept { return dayEnd; };
+    bool hasTask(std::size_t taskID) const;
+/*
+ * The first to the last day that has a block of the task, empty when the task has
+ * no blocks.
+ */
+    DayRange getTaskDays(std::size_t taskID) const;
+    std::span<const TaskBlock> getBlocks(std::chrono::sys_days day) const;
+    std::vector<TaskBlock> getBlocks(DayRange days) const;
+/*
+ * Tasks that end after their RequiredDelivery or that don't fit in the days.
+ */
+    std::vector<std::size_t> getLateTaskIDs() const;
+    std::size_t getLastRecomputedDayCount() const noexcept { return lastRecomputedDayCount; };
+
+private:
+    using TimeRanges = std::vector<std::pair<std::chrono::minutes, std::chrono::minutes>>;
+    using RemainingEffort = std::unordered_map<std::size_t, std::chrono::minutes>;
+
+    static bool isPlacedBefore(const PlanTask& first, const PlanTask& second) noexcept;
+    std::size_t dayIndex(std::chrono::sys_days day) const noexcept;
+    std::size_t firstBlockDay(std::size_t taskID) const;
+    TimeRanges freeTime(std::size_t day) const;
+    RemainingEffort remainingBefore(std::size_t day) const;
+    void placeDay(std::size_t day, RemainingEffort& remaining);
+    static void subtractBlocks(const std::vector<TaskBlock>& blocks, RemainingEffort& remaining);
+    DayRange recomputeFrom(std::size_t startDay, RemainingEffort previousRemaining, std::size_t changedTaskID);
+
+    std::chrono::sys_days firstDay;
+    std::chrono::minutes dayStart{0};
+    std::chrono::minutes dayEnd{0};
+    std::vector<PlanTask> tasks;
+    std::vector<TimeRanges> busyByDay;
+    std::vector<std::vector<TaskBlock>> blocksByDay;
+    std::size_t lastRecomputedDayCount = 0;
+};
+
+#endif // DAYSCHEDULEPLAN_H_
@@ -0,0 +1,426 @@
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include "CoreDBInterface.h"
+#include "DaySchedulePlan.h"
+#include "DayScheduler.h"
+#include <exception>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include <utility>
+#include <vector>
+#include "UserModel.h"
+
+DayScheduler::DayScheduler()
+: CoreDBInterface()
+{
+}
+
+bool DayScheduler::scheduleUser(const UserModel& user, const TaskListValues& openTasks,
+    std::chrono::year_month_day firstDay, std::size_t dayCount)
+{
+    errorMessages.clear();
+
+    if (!setUser(user))
+    {
+        return false;
+    }
+
+    return waitForCoRoutine(coRoutineScheduleDays(openTasks, firstDay, dayCount)).has_value();
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<void>> DayScheduler::asyncScheduleUser(UserModel_shp user,
+    TaskListValues openTasks, std::chrono::year_month_day firstDay, std::size_t dayCount)
+{
+    errorMessages.clear();
+
+    if (!user || !setUser(*user))
+    {
+        co_return operationFailed("In DayScheduler::scheduleUser : no user to schedule");
+    }
+
+    co_return co_await coRoutineScheduleDays(std::move(openTasks), firstDay, dayCount);
+}
+
+bool DayScheduler::rescheduleTask(const TaskModel& changedTask)
+{
+    errorMessages.clear();
+
+    if (plan.getDayCount() == 0)
+    {
+        appendErrorMessage("In DayScheduler::rescheduleTask : scheduleUser() has not been called");
+        return false;
+    }
+
+    return waitForCoRoutine(coRoutineWriteDays(replanTask(changedTask))).has_value();
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<DaySchedulePlan::DayRange>> DayScheduler::asyncRescheduleTask(
+    TaskModel_shp changedTask)
+{
+    errorMessages.clear();
+
+    if (plan.getDayCount() == 0 || !changedTask)
+    {
+        co_return operationFailed("In DayScheduler::rescheduleTask : scheduleUser() has not been called");
+    }
+
+    DaySchedulePlan::DayRange changedDays = replanTask(*changedTask);
+    DBResult<void> written = co_await coRoutineWriteDays(changedDays);
+    if (!written)
+    {
+        co_return std::unexpected(written.error());
+    }
+
+    co_return changedDays;
+}
+
+std::optional<std::chrono::minutes> DayScheduler::parseTimeOfDay(std::string_view timeOfDay)
+{
+    unsigned int hours = 0;
+    unsigned int minutes = 0;
+    const char* position = timeOfDay.data();
+    const char* end = timeOfDay.data() + timeOfDay.size();
+
+    auto [hoursEnd, hoursError] = std::from_chars(position, end, hours);
+    if (hoursError != std::errc() || hoursEnd == end || *hoursEnd != ':')
+    {
+        return std::nullopt;
+    }
+    auto [minutesEnd, minutesError] = std::from_chars(hoursEnd + 1, end, minutes);
+    if (minutesError != std::errc() || minutesEnd - hoursEnd != 3 || minutes > 59)
+    {
+        return std::nullopt;
+    }
+
+    std::string_view suffix(minutesEnd, end);
+    while (!suffix.empty() && suffix.front() == ' ')
+    {
+        suffix.remove_prefix(1);
+    }
+
+    if (suffix.empty())
+    {
+        if (hours > 23)
+        {
+            return std::nullopt;
+        }
+    }
+    else
+    {
+        if (suffix.size() != 2 || std::toupper(static_cast<unsigned char>(suffix[1])) != 'M' || hours < 1 ||
+            hours > 12)
+        {
+            return std::nullopt;
+        }
+        char meridiem = static_cast<char>(std::toupper(static_cast<unsigned char>(suffix[0])));
+        if (meridiem != 'A' && meridiem != 'P')
+        {
+            return std::nullopt;
+        }
+        hours = (hours % 12) + (meridiem == 'P'? 12 : 0);
+    }
+
+    return std::chrono::hours(hours) + std::chrono::minutes(minutes);
+}
+
+bool DayScheduler::setUser(const UserModel& user)
+{
+    std::optional<std::chrono::minutes> startOfDay = parseTimeOfDay(user.getStartTime());
+    std::optional<std::chrono::minutes> endOfDay = parseTimeOfDay(user.getEndTime());
+    if (!startOfDay.has_value() || !endOfDay.has_value() || startOfDay.value() >= endOfDay.value())
+    {
+        appendErrorMessage(std::format("In DayScheduler::scheduleUser : invalid working hours {} to {}",
+            user.getStartTime(), user.getEndTime()));
+        return false;
+    }
+
+    userID = user.getUserID();
+    dayStart = startOfDay.value();
+    dayEnd = endOfDay.value();
+    includePriority = user.isPriorityInSchedule();
+    includeMinorPriority = user.isMinorPriorityInSchedule();
+    usingLettersForMajorPriority = user.isUsingLettersForMaorPriority();
+    separatingPriorityWithDot = user.isSeparatingPriorityWithDot();
+
+    return true;
+}
+
+bool DayScheduler::isSchedulable(const TaskModel& task) const
+{
+    return task.getAssignToID() == userID && task.getStatus() != TaskModel::TaskStatus::Complete &&
+        task.getStatus() != TaskModel::TaskStatus::On_Hold &&
+        makePlanTask(task).remainingEffort > std::chrono::minutes(0);
+}
+
+/*
+ * The effort is in hours, the remaining effort is rounded up to whole minutes.
+ */
+DaySchedulePlan::PlanTask DayScheduler::makePlanTask(const TaskModel& task)
+{
+    double remainingHours = std::max(0.0,
+        static_cast<double>(task.getEstimatedEffort()) - task.getactualEffortToDate());
+
+    return {
+        task.getTaskID(),
+        task.getPriorityGroup(),
+        task.getPriority(),
+        std::chrono::sys_days(task.getDueDate()),
+        std::chrono::sys_days(task.getScheduledStart()),
+        std::chrono::minutes(static_cast<std::chrono::minutes::rep>(std::ceil(remainingHours * 60.0)))
+    };
+}
+
+/*
+ * The priority prefix follows the user's preferences, the major priority is a
+ * letter only for groups 1 to 26. The title is cut to the Title column without
+ * splitting a UTF-8 character.
+ */
+std::string DayScheduler::formatTitle(const TaskModel& task) const
+{
+    std::string title;
+
+    if (includePriority)
+    {
+        unsigned int group = task.getPriorityGroup();
+        if (usingLettersForMajorPriority && group >= 1 && group <= 26)
+        {
+            title.push_back(static_cast<char>('A' + group - 1));
+        }
+        else
+        {
+            title.append(std::to_string(group));
+        }
+        if (includeMinorPriority)
+        {
+            if (separatingPriorityWithDot)
+            {
+                title.push_back('.');
+            }
+            title.append(std::to_string(task.getPriority()));
+        }
+        title.push_back(' ');
+    }
+    title.append(task.getDescription());
+
+    if (title.size() > MaxTitleBytes)
+    {
+        std::size_t cut = MaxTitleBytes;
+        while (cut > 0 && (static_cast<unsigned char>(title[cut]) & 0xC0) == 0x80)
+        {
+            --cut;
+        }
+        title.resize(cut);
+    }
+
+    return title;
+}
+
+DaySchedulePlan::DayRange DayScheduler::replanTask(const TaskModel& changedTask)
+{
+    if (!isSchedulable(changedTask))
+    {
+        titles.erase(changedTask.getTaskID());
+        return plan.removeTask(changedTask.getTaskID());
+    }
+
+    std::string newTitle = formatTitle(changedTask);
+    std::string& title = titles[changedTask.getTaskID()];
+    const bool titleChanged = title != newTitle;
+    title = std::move(newTitle);
+
+    DaySchedulePlan::DayRange changedDays = plan.updateTask(makePlanTask(changedTask));
+
+    // A new title has to be written on every day that has a block of the task.
+    if (titleChanged)
+    {
+        DaySchedulePlan::DayRange taskDays = plan.getTaskDays(changedTask.getTaskID());
+        if (changedDays.empty())
+        {
+            return taskDays;
+        }
+        if (!taskDays.empty())
+        {
+            changedDays = {std::min(changedDays.first, taskDays.first), std::max(changedDays.last, taskDays.last)};
+        }
+    }
+
+    return changedDays;
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<void>> DayScheduler::coRoutineScheduleDays(TaskListValues openTasks,
+    std::chrono::year_month_day firstDay, std::size_t dayCount)
+{
+    std::vector<DaySchedulePlan::PlanTask> planTasks;
+    titles.clear();
+    for (const TaskModel_shp& task: openTasks)
+    {
+        if (task && isSchedulable(*task))
+        {
+            planTasks.push_back(makePlanTask(*task));
+            titles[task->getTaskID()] = formatTitle(*task);
+        }
+    }
+
+    plan = DaySchedulePlan(std::chrono::sys_days(firstDay), dayCount, dayStart, dayEnd);
+
+    std::string failure;
+    try
+    {
+        std::vector<DaySchedulePlan::BusyTime> busyTimes = co_await coRoutineLoadBusyTimes();
+        plan.setBusyTimes(busyTimes);
+    }
+
+    catch (const std::exception& e)
+    {
+        failure = std::format("In DayScheduler::scheduleUser : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return operationFailed(failure);
+    }
+
+    plan.schedule(std::move(planTasks));
+
+    co_return co_await coRoutineWriteDays(plan.getAllDays());
+}
+
+/*
+ * All the other items of the user's days are busy time, including Task Execution
+ * items the user entered without a TaskID. An item that crosses midnight is split
+ * between the days.
+ */
+NSBA::awaitable<std::vector<DaySchedulePlan::BusyTime>> DayScheduler::coRoutineLoadBusyTimes()
+{
+    const std::chrono::sys_days firstDay = plan.getFirstDay();
+    const std::chrono::sys_days lastDay = plan.getAllDays().last;
+
+    NSBM::format_options formatOptions = co_await coRoutineGetFormatOptions();
+    std::string selectBusyQuery = NSBM::format_sql(formatOptions,
+        "SELECT StartDateTime, EndDateTime FROM UserScheduleItem WHERE UserID = {} AND StartDateTime < {}"
+        " AND EndDateTime > {} AND (ItemType <> {} OR TaskID IS NULL)",
+        userID, toDateTime(lastDay, std::chrono::minutes(0)), toDateTime(firstDay, std::chrono::minutes(0)),
+        TaskExecutionItemType);
+
+    NSBM::results busyItems = co_await coRoutineExecuteSqlStatement(selectBusyQuery);
+
+    std::vector<DaySchedulePlan::BusyTime> busyTimes;
+    for (auto row: busyItems.rows())
+    {
+        auto itemStart = std::chrono::floor<std::chrono::minutes>(
+            boostMysqlDateTimeToChronoTimePoint(row.at(0).as_datetime()));
+        auto itemEnd = std::chrono::ceil<std::chrono::minutes>(
+            boostMysqlDateTimeToChronoTimePoint(row.at(1).as_datetime()));
+
+        for (std::chrono::sys_days day = std::max(std::chrono::floor<std::chrono::days>(itemStart), firstDay);
+            day < lastDay && day < itemEnd; day += std::chrono::days(1))
+        {
+            busyTimes.push_back({day, std::max(itemStart, std::chrono::sys_time<std::chrono::minutes>(day)) - day,
+                std::min(itemEnd, std::chrono::sys_time<std::chrono::minutes>(day + std::chrono::days(1))) - day});
+        }
+    }
+
+    co_return busyTimes;
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<void>> DayScheduler::coRoutineWriteDays(DaySchedulePlan::DayRange days)
+{
+    if (days.empty())
+    {
+        co_return DBResult<void>{};
+    }
+
+    std::string failure;
+    try
+    {
+        NSBM::format_options formatOptions = co_await coRoutineGetFormatOptions();
+        co_await coRoutineExecuteTransaction(formatWriteDayStatements(formatOptions, days));
+    }
+
+    catch (const std::exception& e)
+    {
+        failure = std::format("In DayScheduler::writeDays : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return operationFailed(failure);
+    }
+
+    co_return DBResult<void>{};
+}
+
+/*
+ * Deletes the generated items of the days, inserts the new blocks MaxItemsPerInsert
+ * rows at a time and inserts or updates the UserDaySchedule rows.
+ */
+std::vector<std::string> DayScheduler::formatWriteDayStatements(const NSBM::format_options& formatOptions,
+    DaySchedulePlan::DayRange days) const
+{
+    std::vector<std::string> statements;
+
+    statements.push_back(NSBM::format_sql(formatOptions,
+        "DELETE FROM UserScheduleItem WHERE UserID = {} AND StartDateTime >= {} AND StartDateTime < {}"
+        " AND ItemType = {} AND TaskID IS NOT NULL",
+        userID, toDateTime(days.first, std::chrono::minutes(0)), toDateTime(days.last, std::chrono::minutes(0)),
+        TaskExecutionItemType));
+
+    std::vector<DaySchedulePlan::TaskBlock> blocks = plan.getBlocks(days);
+    std::span<const DaySchedulePlan::TaskBlock> allBlocks(blocks);
+    for (std::size_t chunkStart = 0; chunkStart < allBlocks.size(); chunkStart += MaxItemsPerInsert)
+    {
+        std::span<const DaySchedulePlan::TaskBlock> chunk = allBlocks.subspan(chunkStart,
+            std::min(MaxItemsPerInsert, allBlocks.size() - chunkStart));
+
+        NSBM::format_context fctx(formatOptions);
+        NSBM::format_sql_to(fctx,
+            "INSERT INTO UserScheduleItem (UserID, StartDateTime, EndDateTime, ItemType, Title, TaskID) VALUES ");
+        for (std::size_t blockIdx = 0; blockIdx < chunk.size(); ++blockIdx)
+        {
+            if (blockIdx > 0)
+            {
+                NSBM::format_sql_to(fctx, ", ");
+            }
+
+            const DaySchedulePlan::TaskBlock& block = chunk[blockIdx];
+            auto title = titles.find(block.taskID);
+            NSBM::format_sql_to(fctx, "({}, {}, {}, {}, {}, {})", userID,
+                toDateTime(block.day, block.start), toDateTime(block.day, block.end), TaskExecutionItemType,
+                title == titles.end()? std::string_view() : std::string_view(title->second), block.taskID);
+        }
+        statements.push_back(std::move(fctx).get().value());
+    }
+
+    NSBM::format_context fctx(formatOptions);
+    NSBM::format_sql_to(fctx, "INSERT INTO UserDaySchedule (UserID, DateOfSchedule, StartOfDay, EndOfDay) VALUES ");
+    const std::string startOfDay = std::format("{:02}:{:02}:00", dayStart.count() / 60, dayStart.count() % 60);
+    const std::string endOfDay = std::format("{:02}:{:02}:00", dayEnd.count() / 60, dayEnd.count() % 60);
+    for (std::chrono::sys_days day = days.first; day < days.last; day += std::chrono::days(1))
+    {
+        if (day > days.first)
+        {
+            NSBM::format_sql_to(fctx, ", ");
+        }
+        NSBM::format_sql_to(fctx, "({}, {}, {}, {})", userID, NSBM::date(day), startOfDay, endOfDay);
+    }
+    NSBM::format_sql_to(fctx,
+        " AS newDay ON DUPLICATE KEY UPDATE StartOfDay = newDay.StartOfDay, EndOfDay = newDay.EndOfDay");
+    statements.push_back(std::move(fctx).get().value());
+
+    return statements;
+}
+
+NSBM::datetime DayScheduler::toDateTime(std::chrono::sys_days day, std::chrono::minutes timeOfDay)
+{
+    return stdChronoTimePointToBoostDateTime(day + timeOfDay);
+}
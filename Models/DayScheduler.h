@@ -0,0 +1,90 @@
+#ifndef DAYSCHEDULER_H_
+#define DAYSCHEDULER_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <chrono>
+#include "CoreDBInterface.h"
+#include "DaySchedulePlan.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include <unordered_map>
+#include <vector>
+#include "UserModel.h"
+
+/*
+ * Generates a user's day schedules from their open tasks. The remaining effort of
+ * each task is placed into the user's working hours by a DaySchedulePlan, around
+ * the UserScheduleItems already in those days, and written as Task Execution items
+ * with the TaskID of the task. A UserDaySchedule row is written for each day.
+ *
+ * scheduleUser() replaces the generated items of every day in the range. After a
+ * task changes rescheduleTask() rewrites only the days the change moved, the
+ * other schedule items of the user are not reloaded for it. If a write fails the
+ * plan no longer matches the database, call scheduleUser() again.
+ */
+class DayScheduler : public CoreDBInterface
+{
+public:
+    static constexpr std::size_t DefaultDayCount = 14;
+    static constexpr unsigned int TaskExecutionItemType = 3;
+
+    DayScheduler();
+    ~DayScheduler() = default;
+
+/*
+ * Tasks that are complete, on hold, have no effort left or are assigned to
+ * another user are not scheduled.
+ */
+    bool scheduleUser(const UserModel& user, const TaskListValues& openTasks, std::chrono::year_month_day firstDay,
+        std::size_t dayCount = DefaultDayCount);
+    NSBA::awaitable<DBResult<void>> asyncScheduleUser(UserModel_shp user, TaskListValues openTasks,
+        std::chrono::year_month_day firstDay, std::size_t dayCount = DefaultDayCount);
+
+/*
+ * Places the changed task again, a task that can no longer be scheduled is
+ * removed from the plan. The days of the task are also rewritten when only its
+ * title changed. The async version returns the days that were rewritten.
+ */
+    bool rescheduleTask(const TaskModel& changedTask);
+    NSBA::awaitable<DBResult<DaySchedulePlan::DayRange>> asyncRescheduleTask(TaskModel_shp changedTask);
+
+    const DaySchedulePlan& getPlan() const noexcept { return plan; };
+
+/*
+ * Accepts "8:30 AM", "5:00 pm" and "17:00", returns minutes from midnight.
+ */
+    static std::optional<std::chrono::minutes> parseTimeOfDay(std::string_view timeOfDay);
+
+private:
+    static constexpr std::size_t MaxItemsPerInsert = 500;
+    static constexpr std::size_t MaxTitleBytes = 128;
+
+    bool setUser(const UserModel& user);
+    bool isSchedulable(const TaskModel& task) const;
+    static DaySchedulePlan::PlanTask makePlanTask(const TaskModel& task);
+    std::string formatTitle(const TaskModel& task) const;
+    DaySchedulePlan::DayRange replanTask(const TaskModel& changedTask);
+    NSBA::awaitable<DBResult<void>> coRoutineScheduleDays(TaskListValues openTasks,
+        std::chrono::year_month_day firstDay, std::size_t dayCount);
+    NSBA::awaitable<DBResult<void>> coRoutineWriteDays(DaySchedulePlan::DayRange days);
+    NSBA::awaitable<std::vector<DaySchedulePlan::BusyTime>> coRoutineLoadBusyTimes();
+    std::vector<std::string> formatWriteDayStatements(const NSBM::format_options& formatOptions,
+        DaySchedulePlan::DayRange days) const;
+    static NSBM::datetime toDateTime(std::chrono::sys_days day, std::chrono::minutes timeOfDay);
+
+    std::size_t userID = 0;
+    std::chrono::minutes dayStart{0};
+    std::chrono::minutes dayEnd{0};
+    bool includePriority = false;
+    bool includeMinorPriority = false;
+    bool usingLettersForMajorPriority = false;
+    bool separatingPriorityWithDot = false;
+    std::unordered_map<std::size_t, std::string> titles;
+    DaySchedulePlan plan;
+};
+
+#endif // DAYSCHEDULER_H_
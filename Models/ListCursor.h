@@ -0,0 +1,223 @@
+#ifndef LISTCURSOR_H_
+#define LISTCURSOR_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <concepts>
+#include "CoreDBInterface.h"
+#include <cstddef>
+#include "DBConnectionPool.h"
+#include <exception>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include "ModelDBInterface.h"
+#include <string>
+#include <vector>
+
+/*
+ * Streams the rows of a model select query rather than materializing them in one
+ * NSBM::results. The query is started with start_execution and the rows are read
+ * with read_some_rows, each read returns the rows that fit in the connection's
+ * buffer, so memory stays bounded however many rows the query returns.
+ *
+ * The cursor holds one pooled connection from the first read until the last row
+ * has been read. A cursor that is destroyed before the end of the rows returns
+ * the connection with a session reset.
+ *
+ * The related rows of each chunk (such as task dependencies) are loaded on another
+ * pooled connection before the chunk is returned, a cursor needs a pool of at least
+ * two connections.
+ *
+ * Chunks of models can be read with asyncNextChunk() from a coroutine, or with
+ * nextChunk() from blocking code; an empty chunk means there are no more rows.
+ * A range-for over the cursor visits every model one chunk at a time.
+ */
+template<typename ListType>
+requires std::is_base_of<ModelDBInterface, ListType>::value
+class ListCursor : public CoreDBInterface
+{
+public:
+    using ModelChunk = std::vector<std::shared_ptr<ListType>>;
+
+    explicit ListCursor(std::string selectQuery)
+    : CoreDBInterface(),
+      cursorName{std::string(ListType().getModelName()) + "Cursor"},
+      query{std::move(selectQuery)},
+      started{false},
+      complete{false}
+    {
+    }
+    virtual ~ListCursor() { releaseConnection(); };
+    ListCursor(const ListCursor&) = delete;
+    ListCursor& operator=(const ListCursor&) = delete;
+
+    bool isComplete() const noexcept { return complete; };
+
+    ModelChunk nextChunk()
+    {
+        DBResult<ModelChunk> chunk = waitForCoRoutine(asyncNextChunk());
+
+        return chunk.has_value()? std::move(chunk.value()) : ModelChunk();
+    };
+
+    NSBA::awaitable<DBResult<ModelChunk>> asyncNextChunk()
+    {
+        ModelChunk chunk;
+
+        if (complete)
+        {
+            co_return chunk;
+        }
+
+        if (query.empty())
+        {
+            complete = true;
+            co_return operationFailed(std::format("In {} : no query to run", cursorName));
+        }
+
+        DBConnectionPool& pool = DBConnectionPool::getPool(dbConnectionParameters);
+        std::string failure;
+
+        try
+        {
+            if (!started)
+            {
+                errorMessages.clear();
+                started = true;
+                conn = co_await pool.asyncGetConnection();
+                if (verboseOutput)
+                {
+                    std::clog << "Streaming: \n\t" << query << "\n";
+                }
+                co_await conn->async_start_execution(query, executionState);
+            }
+
+            while (chunk.empty() && executionState.should_read_rows())
+            {
+                NSBM::rows_view rows = co_await conn->async_read_some_rows(executionState);
+                chunk.reserve(rows.size());
+                for (auto row: rows)
+                {
+                    std::shared_ptr<ListType> newModel = std::make_shared<ListType>();
+                    newModel->loadFromResultRow(row);
+                    chunk.push_back(newModel);
+                }
+            }
+
+            if (executionState.complete())
+            {
+                complete = true;
+                pool.returnWithoutReset(conn);
+            }
+
+            // The related rows are read on another pooled connection.
+            if (!chunk.empty())
+            {
+                std::vector<ModelDBInterface*> chunkModels;
+                chunkModels.reserve(chunk.size());
+                for (auto model: chunk)
+                {
+                    chunkModels.push_back(model.get());
+                }
+                co_await chunk.front()->coRoutineLoadRelatedRows(chunkModels);
+            }
+        }
+
+        catch (const NSBM::error_with_diagnostics& e)
+        {
+            if (DBConnectionPool::isConnectionLevelError(e.code()))
+            {
+                pool.invalidateFormatOptions();
+            }
+            failure = std::format("In {} : {}", cursorName, e.what());
+        }
+
+        catch (const std::exception& e)
+        {
+            failure = std::format("In {} : {}", cursorName, e.what());
+        }
+
+        if (!failure.empty())
+        {
+            complete = true;
+            releaseConnection();
+            co_return operationFailed(failure);
+        }
+
+        co_return chunk;
+    };
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::shared_ptr<ListType>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        iterator() = default;
+        explicit iterator(ListCursor* cursorIn)
+        : cursor{cursorIn}
+        {
+            fetchChunk();
+        }
+
+        reference operator*() const { return cursor->currentChunk[position]; };
+        pointer operator->() const { return &cursor->currentChunk[position]; };
+        iterator& operator++()
+        {
+            if (++position >= cursor->currentChunk.size())
+            {
+                fetchChunk();
+            }
+            return *this;
+        };
+        void operator++(int) { ++*this; };
+        bool operator==(const iterator& other) const noexcept { return cursor == other.cursor; };
+
+    private:
+        void fetchChunk()
+        {
+            position = 0;
+            cursor->currentChunk = cursor->nextChunk();
+            if (cursor->currentChunk.empty())
+            {
+                cursor = nullptr;
+            }
+        };
+
+        ListCursor* cursor = nullptr;
+        std::size_t position = 0;
+    };
+
+    iterator begin() { return iterator(this); };
+    iterator end() { return iterator(); };
+
+private:
+/*
+ * Unread rows or an error leave session state behind, the connection is returned
+ * with a reset and its prepared statements are forgotten.
+ */
+    void releaseConnection() noexcept
+    {
+        if (conn.valid())
+        {
+            DBConnectionPool::getPool(dbConnectionParameters).getStatementCache().forgetConnection(conn.get());
+            conn = NSBM::pooled_connection();
+        }
+    };
+
+    std::string cursorName;
+    std::string query;
+    bool started;
+    bool complete;
+    NSBM::pooled_connection conn;
+    NSBM::execution_state executionState;
+    ModelChunk currentChunk;
+};
+
+#endif // LISTCURSOR_H_
+
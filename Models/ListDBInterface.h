@@ -5,28 +5,32 @@
 #include <boost/mysql.hpp>
 #include <concepts>
 #include "CoreDBInterface.h"
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include "ModelDBInterface.h"
+#include "ModelRowCache.h"
 #include <string>
 #include <string_view>
+#include "UnitOfWork.h"
 #include <vector>
 
 /*
  * Templated Class to handle model select queries with multiple results.
  * 
- * The model itself is used to create the select statement. The first query will
- * only return the primary key of each instance of the model that matches the
- * search parameters of the query. Once the list of primary keys is established
- * the model will be used to select the object by primary key for the full data.
+ * The model itself is used to create the select statement. The list query
+ * returns the full row of each instance of the model that matches the search
+ * parameters of the query, and each row is decoded by the model. The whole list
+ * costs one query and one pooled connection, rather than one query per model.
  * 
- * This is done primarily to keep the table related information for a model in
- * the model. A second reason for this design is that the is a maximum size that
- * a boost::mysql::results class can reach; to reduce the possiblity of reaching
- * that maximum queries that can return a large amount of data will be reduced
- * to returning only the primary keys of the data.
+ * The rows of every list are added to the model's row cache when the cache is
+ * enabled, so the models of the list can later be selected by primary key without
+ * a query.
  * 
- * This design may be revisited if there is too much a performance degradation.
+ * There is a maximum size that a boost::mysql::results object can reach (the
+ * connection's maximum buffer size). Models that can be selected by a large
+ * number of primary keys select them in chunks, see TaskModel::selectByTaskIDs().
  */
 template<typename ListType>
 requires std::is_base_of<ModelDBInterface, ListType>::value
@@ -48,50 +52,240 @@ public:
     {
         prepareForRunQueryAsync();
 
+        return waitForCoRoutine(coRoutineRunFirstQuery());
+    };
+
+/*
+ * Does not clear the error messages, the calling list query has already done that.
+ */
+    NSBA::awaitable<bool> coRoutineRunFirstQuery()
+    {
+        std::string failure;
+
+        try
+        {
+            listResults.clear();
+            std::uint64_t cacheGeneration = queryGenerator.getRowCache().getGeneration();
+            NSBM::results localResult = co_await coRoutineExecuteSqlStatement(firstFormattedQuery);
+            processFirstQueryResults(localResult, cacheGeneration);
+            co_await coRoutineLoadRelatedRows(listResults);
+        }
+
+        catch(const std::exception& e)
+        {
+            failure = std::format("In {}List.runFirstQuery() : {}", queryGenerator.getModelName(), e.what());
+        }
+
+        if (!failure.empty())
+        {
+            appendErrorMessage(failure);
+            co_return false;
+        }
+
+        co_return listResults.size() > 0;
+    };
+
+/*
+ * Send the updates of all the modified models that are already in the database
+ * as one batch, the models that are updated successfully are no longer modified.
+ */
+    bool updateAll(std::vector<std::shared_ptr<ListType>>& models)
+    {
+        prepareForRunQueryAsync();
+        const NSBM::format_options& formatOptions = getFormatOptions();
+
+        std::vector<std::shared_ptr<ListType>> modelsToUpdate;
+        std::vector<std::size_t> statementsPerModel;
+        std::vector<std::string> updateStatements;
+
+        for (auto model: models)
+        {
+            if (!model->isInDataBase() || !model->isModified())
+            {
+                continue;
+            }
+
+            std::size_t firstModelStatement = updateStatements.size();
+            if (model->hasDirtyColumns())
+            {
+                updateStatements.push_back(model->formatBatchUpdateStatement(formatOptions));
+            }
+            std::vector<std::string> relatedStatements = model->formatRelatedRowStatements(formatOptions);
+            updateStatements.insert(updateStatements.end(), relatedStatements.begin(), relatedStatements.end());
+
+            if (updateStatements.size() > firstModelStatement)
+            {
+                modelsToUpdate.push_back(model);
+                statementsPerModel.push_back(updateStatements.size() - firstModelStatement);
+            }
+            else
+            {
+                model->clearModified();
+            }
+        }
+
         try
         {
-            primaryKeyResults.clear();
-            NSBM::results localResult = runQueryAsync(firstFormattedQuery);
-            primaryKeyResults = processFirstQueryResults(localResult);
+            std::vector<BatchStatementResult> batchResults = runBatchAsync(updateStatements);
+            bool allUpdated = true;
+            std::size_t statementIdx = 0;
+
+            for (std::size_t modelIdx = 0; modelIdx < modelsToUpdate.size(); ++modelIdx)
+            {
+                bool modelUpdated = true;
+                for (std::size_t modelStatement = 0; modelStatement < statementsPerModel[modelIdx]; ++modelStatement)
+                {
+                    if (!batchResults[statementIdx].succeeded)
+                    {
+                        appendErrorMessage(std::format("In {}.updateAll() : {}", listTypeName,
+                            batchResults[statementIdx].errorMessage));
+                        modelUpdated = false;
+                    }
+                    ++statementIdx;
+                }
+
+                modelsToUpdate[modelIdx]->invalidateCachedRow();
+                if (modelUpdated)
+                {
+                    modelsToUpdate[modelIdx]->clearRelatedRowChanges();
+                    modelsToUpdate[modelIdx]->clearModified();
+                }
+                else
+                {
+                    allUpdated = false;
+                }
+            }
 
-            return primaryKeyResults.size() > 0;
+            return allUpdated;
         }
 
         catch(const std::exception& e)
         {
-            appendErrorMessage(std::format("In {}List.runFirstQuery() : {}",
-                queryGenerator.getModelName(), e.what()));
+            appendErrorMessage(std::format("In {}.updateAll() : {}", listTypeName, e.what()));
             return false;
         }
     };
 
+/*
+ * Insert all the new models with multi-row INSERT statements in one transaction,
+ * the models get their primary keys once the transaction has committed. The keys
+ * use the auto-increment step read inside that transaction, on its connection.
+ * Nothing is inserted if any model is missing required values. The related rows of
+ * the models are written in the same transaction, see UnitOfWork.
+ */
+    bool insertAll(std::vector<std::shared_ptr<ListType>>& models)
+    {
+        errorMessages.clear();
+
+        UnitOfWork insertWork;
+
+        for (auto model: models)
+        {
+            if (model->isInDataBase() || !model->isModified())
+            {
+                continue;
+            }
+
+            if (!model->hasRequiredValues())
+            {
+                model->reportMissingFields();
+                appendErrorMessage(std::format("In {}.insertAll() : {} is missing required values!\n{}",
+                    listTypeName, model->getModelName(), model->getAllErrorMessages()));
+                return false;
+            }
+
+            insertWork.registerModel(model);
+        }
+
+        if (!insertWork.commit())
+        {
+            appendErrorMessage(std::format("In {}.insertAll() : {}", listTypeName, insertWork.getAllErrorMessages()));
+            return false;
+        }
+
+        return true;
+    };
+
 protected:
+/*
+ * List coroutines get the format options from the pool cache with co_await, they
+ * must not wait for them on the shared executor. Returns false if the query could
+ * not be formatted.
+ */
+    using FormatFirstQuery = std::function<std::string(const NSBM::format_options&)>;
+    NSBA::awaitable<bool> coRoutineFormatFirstQuery(FormatFirstQuery formatQuery)
+    {
+        std::string failure;
+        firstFormattedQuery.clear();
+
+        try
+        {
+            NSBM::format_options formatOptions = co_await coRoutineGetFormatOptions();
+            firstFormattedQuery = formatQuery(formatOptions);
+        }
+
+        catch(const std::exception& e)
+        {
+            failure = std::format("In {}.formatFirstQuery() : {}", listTypeName, e.what());
+        }
+
+        if (!failure.empty())
+        {
+            appendErrorMessage(failure);
+            co_return false;
+        }
+
+        co_return !firstFormattedQuery.empty();
+    };
+
     void setFirstQuery(std::string formattedQueryStatement) noexcept
     {
         firstFormattedQuery = formattedQueryStatement;
     }
     
-    virtual std::vector<std::size_t> processFirstQueryResults(NSBM::results& results)
+    NSBA::awaitable<void> coRoutineLoadRelatedRows(std::vector<std::shared_ptr<ListType>>& models)
+    {
+        std::vector<ModelDBInterface*> listModels;
+        listModels.reserve(models.size());
+        for (auto model: models)
+        {
+            listModels.push_back(model.get());
+        }
+
+        co_await queryGenerator.coRoutineLoadRelatedRows(listModels);
+    }
+
+/*
+ * The rows are only cached if they were not invalidated after cacheGeneration.
+ */
+    virtual void processFirstQueryResults(NSBM::results& results, std::uint64_t cacheGeneration)
     {
         if (results.rows().empty())
         {
             appendErrorMessage(std::format("No {}s found!", queryGenerator.getModelName()));
-            return primaryKeyResults;
+            return;
         }
 
+        ModelRowCache& rowCache = queryGenerator.getRowCache();
+        bool cacheRows = rowCache.isEnabled();
+
+        listResults.reserve(results.rows().size());
         for (auto row: results.rows())
         {
-            primaryKeyResults.push_back(row.at(0).as_uint64());
-    
+            std::shared_ptr<ListType> newModel = std::make_shared<ListType>();
+            newModel->loadFromResultRow(row);
+            if (cacheRows)
+            {
+                rowCache.store(row.at(0).as_uint64(), row, cacheGeneration);
+            }
+            listResults.push_back(newModel);
         }
-        return primaryKeyResults;
     }
 
     ListType queryGenerator;
-    std::string_view listTypeName;
+    std::string listTypeName;
     std::string firstFormattedQuery;
-    std::vector<std::size_t> primaryKeyResults;
-    std::vector<std::shared_ptr<ListType>> returnType;
+    std::vector<std::shared_ptr<ListType>> listResults;
 };
 
 #endif // LISTDBINTERFACECORE_H_
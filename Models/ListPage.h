@@ -0,0 +1,25 @@
+#ifndef LISTPAGE_H_
+#define LISTPAGE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+/*
+ * One page of a list query. Pages are found by the key of the last row of the
+ * previous page rather than by OFFSET, so every page costs the same as the first.
+ *
+ * Lists ordered by primary key seek past afterKey. Lists ordered by date seek past
+ * the (afterDate, afterKey) pair, the first page of these lists has no afterDate.
+ * A pageSize of 0 returns the whole list, unordered, as it did before pages.
+ */
+struct ListPage
+{
+    std::size_t pageSize = 0;
+    std::size_t afterKey = 0;
+    std::optional<std::chrono::year_month_day> afterDate;
+
+    bool isPaged() const noexcept { return pageSize > 0; };
+};
+
+#endif // LISTPAGE_H_
@@ -1,11 +1,17 @@
 #include <boost/asio.hpp>
 #include <boost/mysql.hpp>
 #include <chrono>
+#include <cstdint>
 #include "ModelDBInterface.h"
+#include "ModelRowCache.h"
+#include <format>
 #include <iostream>
-#include <sstream>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 ModelDBInterface::ModelDBInterface(std::string_view modelNameIn)
@@ -18,141 +24,229 @@ ModelDBInterface::ModelDBInterface(std::string_view modelNameIn)
 }
 
 bool ModelDBInterface::save()
+{
+    return waitForCoRoutine(asyncSave()).has_value();
+}
+
+bool ModelDBInterface::insert()
+{
+    return waitForCoRoutine(asyncInsert()).has_value();
+}
+
+bool ModelDBInterface::update()
+{
+    return waitForCoRoutine(asyncUpdate()).has_value();
+}
+
+bool ModelDBInterface::retrieve()
+{
+    return waitForCoRoutine(asyncRetrieve()).has_value();
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<void>> ModelDBInterface::asyncSave()
 {
     if (!isModified())
     {
-        appendErrorMessage(std::format("{} not modified, no changes to save", modelName));
-        return false;
+        co_return operationFailed(std::format("{} not modified, no changes to save", modelName));
     }
 
     if (isInDataBase())
     {
-        return update();
+        co_return co_await asyncUpdate();
     }
     else
     {
-        return insert();
+        co_return co_await asyncInsert();
     }
 }
 
-bool ModelDBInterface::insert()
+NSBA::awaitable<CoreDBInterface::DBResult<void>> ModelDBInterface::asyncInsert()
 {
     errorMessages.clear();
 
     if (isInDataBase())
     {
-        appendErrorMessage(std::format("{} already in Database, use Update!", modelName));
-        return false;
+        co_return operationFailed(std::format("{} already in Database, use Update!", modelName));
     }
 
     if (!isModified())
     {
-        appendErrorMessage(std::format("{} not modified!", modelName));
-        return false;
+        co_return operationFailed(std::format("{} not modified!", modelName));
     }
 
     if (!hasRequiredValues())
     {
         appendErrorMessage(std::format("{} is missing required values!", modelName));
         reportMissingFields();
-        return false;
+        co_return std::unexpected(errorMessages);
     }
 
-    prepareForRunQueryAsync();
+    std::string failure;
 
     try
     {
-        NSBM::results localResult = runQueryAsync(formatInsertStatement());
-        primaryKey = localResult.last_insert_id();
-        modified = false;
+        if (hasRelatedRowChanges())
+        {
+            format_opts = co_await coRoutineGetFormatOptions();
+            std::vector<std::string> statements{formatInsertStatement()};
+            std::vector<std::string> relatedStatements = formatRelatedRows();
+            statements.insert(statements.end(), relatedStatements.begin(), relatedStatements.end());
+
+            std::vector<BatchStatementResult> insertResults = co_await coRoutineExecuteTransaction(statements);
+            primaryKey = insertResults.front().lastInsertID;
+            clearRelatedRowChanges();
+        }
+        else
+        {
+            NSBM::results localResult = co_await coRoutineExecutePreparedStatement(buildPreparedInsert());
+            primaryKey = localResult.last_insert_id();
+        }
+        clearModified();
     }
 
     catch(const std::exception& e)
     {
-        appendErrorMessage(std::format("In {}.insert : {}", modelName, e.what()));
-        return false;
+        failure = std::format("In {}.insert : {}", modelName, e.what());
     }
 
-    return true;
+    if (!failure.empty())
+    {
+        co_return operationFailed(failure);
+    }
+
+    co_return DBResult<void>{};
 }
 
-bool ModelDBInterface::update()
+NSBA::awaitable<CoreDBInterface::DBResult<void>> ModelDBInterface::asyncUpdate()
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     if (!isInDataBase())
     {
-        appendErrorMessage(std::format("{} not in Database, use Insert!", modelName));
-        return false;
+        co_return operationFailed(std::format("{} not in Database, use Insert!", modelName));
     }
 
     if (!isModified())
     {
-        appendErrorMessage(std::format("{} not modified!", modelName));
-        return false;
+        co_return operationFailed(std::format("{} not modified!", modelName));
     }
 
-    try
+    // Only the primary key was set, or every setter kept the current value.
+    if (!hasDirtyColumns() && !hasRelatedRowChanges())
     {
+        clearModified();
+        co_return DBResult<void>{};
+    }
+
+    std::string failure;
 
-        NSBM::results localResult = runQueryAsync(formatUpdateStatement());
-        modified = false;
-            
-        return true;
+    try
+    {
+        if (hasRelatedRowChanges())
+        {
+            format_opts = co_await coRoutineGetFormatOptions();
+            std::vector<std::string> statements;
+            if (hasDirtyColumns())
+            {
+                statements.push_back(formatUpdateStatement());
+            }
+            std::vector<std::string> relatedStatements = formatRelatedRows();
+            statements.insert(statements.end(), relatedStatements.begin(), relatedStatements.end());
+
+            co_await coRoutineExecuteTransaction(statements);
+            clearRelatedRowChanges();
+        }
+        else
+        {
+            co_await coRoutineExecutePreparedStatement(buildPreparedUpdate());
+        }
+        invalidateCachedRow();
+        clearModified();
     }
 
     catch(const std::exception& e)
     {
-        appendErrorMessage(std::format("In {}.update : {}", modelName, e.what()));
-        return false;
+        failure = std::format("In {}.update : {}", modelName, e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return operationFailed(failure);
     }
+
+    co_return DBResult<void>{};
 }
 
-bool ModelDBInterface::retrieve()
+NSBA::awaitable<CoreDBInterface::DBResult<void>> ModelDBInterface::asyncRetrieve()
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
+
+    co_return co_await coRoutineSelectSingleModel(buildPreparedSelect(), "retrieve()", primaryKey);
+}
+
+/*
+ * Used by retrieve and the model specific select by ID coroutines, the select by ID
+ * coroutines provide the primary key so the model can be found in the row cache.
+ */
+NSBA::awaitable<CoreDBInterface::DBResult<void>> ModelDBInterface::coRoutineSelectSingleModel(
+    PreparedQuery selectQuery, std::string caller, std::size_t cachedPrimaryKey)
+{
+    std::string failure;
+    bool found = false;
 
     try
     {
-        NSBM::results localResult = runQueryAsync(formatSelectStatement());
+        found = cachedPrimaryKey > 0 && loadFromRowCache(cachedPrimaryKey);
+        if (!found)
+        {
+            std::uint64_t cacheGeneration = getRowCache().getGeneration();
+            NSBM::results localResult = co_await coRoutineExecutePreparedStatement(selectQuery);
+            found = processResult(localResult);
+            if (found)
+            {
+                getRowCache().store(primaryKey, localResult.rows().at(0), cacheGeneration);
+            }
+        }
 
-        return processResult(localResult);
+        if (found)
+        {
+            ModelDBInterface* selectedModel = this;
+            co_await coRoutineLoadRelatedRows(std::span<ModelDBInterface* const>(&selectedModel, 1));
+        }
     }
 
     catch(const std::exception& e)
     {
-        appendErrorMessage(std::format("In {}.retrieve() : {}", modelName, e.what()));
-        return false;
+        failure = std::format("In {}.{} : {}", modelName, caller, e.what());
     }
-}
 
-bool ModelDBInterface::hasRequiredValues()
-{
-    initRequiredFields();
-    for (auto fieldTest: missingRequiredFieldsTests)
+    if (!failure.empty())
     {
-        if (fieldTest.errorCondition())
-        {
-            return false;
-        }
+        co_return operationFailed(failure);
     }
-    
-    return true;
+
+    if (!found)
+    {
+        co_return std::unexpected(errorMessages);
+    }
+
+    co_return DBResult<void>{};
 }
 
 /*
- * Assumes that ModelDBInterface::hasRequiredValues() was called previously and that
- * initRequiredFields() has been called.
+ * Loads the model from the row cache, returns false when the row is not cached
+ * or the cache is disabled.
  */
-void ModelDBInterface::reportMissingFields() noexcept
+bool ModelDBInterface::loadFromRowCache(std::size_t cachedPrimaryKey)
 {
-    for (auto testAndReport: missingRequiredFieldsTests)
+    std::optional<NSBM::row> cachedRow = getRowCache().find(cachedPrimaryKey);
+    if (!cachedRow.has_value())
     {
-        if (testAndReport.errorCondition())
-        {
-            appendErrorMessage(std::format("Missing {} required {}!\n", modelName, testAndReport.fieldName));
-        }
+        return false;
     }
+
+    loadFromResultRow(cachedRow.value());
+    return true;
 }
 
 bool ModelDBInterface::processResult(NSBM::results& results)
@@ -171,33 +265,155 @@ bool ModelDBInterface::processResult(NSBM::results& results)
 
     NSBM::row_view rv = results.rows().at(0);
     processResultRow(rv);
+    clearModified();
 
     return true;
 }
 
-std::vector<std::string> ModelDBInterface::explodeTextField(std::string const& textField) noexcept
+/*
+ * The prepared statement text and key for each set of dirty columns of each table
+ * are built once and shared by all models, the cache holds one entry for each
+ * combination of columns that has been updated. Every pooled connection prepares
+ * each statement it runs, so the combinations of one table are limited to
+ * MaxPartialUpdatesPerTable to stay well below the server's max_prepared_stmt_count.
+ * Once a table reaches the limit any new combination updates every column.
+ */
+struct PartialUpdateStatement
+{
+    std::string statementKey;
+    std::string sqlText;
+    unsigned long columnMask;
+};
+
+static constexpr std::size_t MaxPartialUpdatesPerTable = 64;
+
+static const PartialUpdateStatement& getPartialUpdateStatement(std::string_view tableName,
+    std::span<const std::string_view> columnNames, unsigned long dirtyMask)
 {
-    std::vector<std::string> subFields;
-    std::istringstream iss(textField);
+    static std::mutex statementsMutex;
+    static std::unordered_map<std::string, PartialUpdateStatement> statements;
+    static std::unordered_map<std::string, std::size_t> statementsPerTable;
+
+    std::string statementKey = std::format("{}.update.{:x}", tableName, dirtyMask);
+
+    std::lock_guard<std::mutex> guard(statementsMutex);
+    auto found = statements.find(statementKey);
+    if (found != statements.end())
+    {
+        return found->second;
+    }
 
-    for (std::string token; std::getline(iss, token, delimiter); )
+    std::size_t& tableStatements = statementsPerTable[std::string(tableName)];
+    const unsigned long allColumnsMask = ((1UL << columnNames.size()) - 1) & ~1UL;
+    if (tableStatements >= MaxPartialUpdatesPerTable && dirtyMask != allColumnsMask)
     {
-        subFields.push_back(std::move(token));
+        dirtyMask = allColumnsMask;
+        statementKey = std::format("{}.update.{:x}", tableName, dirtyMask);
+        found = statements.find(statementKey);
+        if (found != statements.end())
+        {
+            return found->second;
+        }
+    }
+    ++tableStatements;
+
+    std::string sqlText = std::format("UPDATE {} SET", tableName);
+    const char* separator = " ";
+    for (std::size_t columnIdx = 1; columnIdx < columnNames.size(); ++columnIdx)
+    {
+        if (dirtyMask & (1UL << columnIdx))
+        {
+            sqlText += std::format("{}{} = ?", separator, columnNames[columnIdx]);
+            separator = ", ";
+        }
     }
-    return subFields;
+    sqlText += std::format(" WHERE {} = ?", columnNames[0]);
+
+    auto inserted = statements.emplace(statementKey,
+        PartialUpdateStatement{statementKey, std::move(sqlText), dirtyMask});
+    return inserted.first->second;
 }
 
-std::string ModelDBInterface::implodeTextField(std::vector<std::string> &fields) noexcept
+CoreDBInterface::PreparedQuery ModelDBInterface::buildPreparedUpdate()
 {
-    std::string textField;
+    UpdateColumns updateColumns = getUpdateColumns();
+    const PartialUpdateStatement& statement = getPartialUpdateStatement(updateColumns.tableName,
+        updateColumns.columnNames, dirtyColumns.to_ulong());
+
+    std::vector<NSBM::field> columnValues = buildPreparedInsert().parameters;
+    PreparedQuery updateQuery{statement.statementKey, statement.sqlText, {}};
 
-    for (auto field: fields)
+    for (std::size_t columnIdx = 1; columnIdx < updateColumns.columnNames.size(); ++columnIdx)
     {
-        textField.append(field);
-        textField += delimiter;
+        if (statement.columnMask & (1UL << columnIdx))
+        {
+            updateQuery.parameters.push_back(std::move(columnValues[columnIdx - 1]));
+        }
     }
+    updateQuery.parameters.emplace_back(primaryKey);
 
-    return textField;
+    return updateQuery;
 }
 
+std::string ModelDBInterface::formatUpdateStatement()
+{
+    UpdateColumns updateColumns = getUpdateColumns();
+    std::vector<NSBM::field> columnValues = buildPreparedInsert().parameters;
+
+    NSBM::format_context fctx(format_opts.value());
+    NSBM::format_sql_to(fctx, "UPDATE {:i} SET ", updateColumns.tableName);
 
+    bool firstColumn = true;
+    for (std::size_t columnIdx = 1; columnIdx < updateColumns.columnNames.size(); ++columnIdx)
+    {
+        if (dirtyColumns.test(columnIdx))
+        {
+            if (!firstColumn)
+            {
+                NSBM::format_sql_to(fctx, ", ");
+            }
+            NSBM::format_sql_to(fctx, "{:i} = {}", updateColumns.columnNames[columnIdx], columnValues[columnIdx - 1]);
+            firstColumn = false;
+        }
+    }
+    NSBM::format_sql_to(fctx, " WHERE {:i} = {}", updateColumns.columnNames[0], primaryKey);
+
+    return std::move(fctx).get().value();
+}
+
+
+void ModelDBInterface::appendListPage(NSBM::format_context& fctx, const ListPage& page, bool queryHasWhere,
+    std::string_view dateColumn) const
+{
+    if (!page.isPaged())
+    {
+        return;
+    }
+
+    std::string_view keyColumn = getUpdateColumns().columnNames[0];
+    std::string_view seekPrefix = queryHasWhere? " AND" : " WHERE";
+
+    if (dateColumn.empty())
+    {
+        if (page.afterKey > 0)
+        {
+            NSBM::format_sql_to(fctx, NSBM::runtime(seekPrefix));
+            NSBM::format_sql_to(fctx, " {:i} > {}", keyColumn, page.afterKey);
+        }
+        NSBM::format_sql_to(fctx, " ORDER BY {:i} LIMIT {}", keyColumn, page.pageSize);
+        return;
+    }
+
+/*
+ * The OR is written out rather than as a row comparison so the range can use the
+ * (date, key) order of the index.
+ */
+    if (page.afterDate.has_value())
+    {
+        NSBM::date afterDate = stdchronoDateToBoostMySQLDate(page.afterDate.value());
+        NSBM::format_sql_to(fctx, NSBM::runtime(seekPrefix));
+        NSBM::format_sql_to(fctx, " ({:i} > {} OR ({:i} = {} AND {:i} > {}))", dateColumn, afterDate, dateColumn,
+            afterDate, keyColumn, page.afterKey);
+    }
+    NSBM::format_sql_to(fctx, " ORDER BY {:i}, {:i} LIMIT {}", dateColumn, keyColumn, page.pageSize);
+}
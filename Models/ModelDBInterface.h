@@ -1,13 +1,20 @@
 #ifndef MODELDBINTERFACECORE_H_
 #define MODELDBINTERFACECORE_H_
 
+#include <array>
+#include <bitset>
 #include <boost/asio.hpp>
 #include <boost/mysql.hpp>
 #include <chrono>
 #include "CoreDBInterface.h"
-#include <functional>
+#include <cstdint>
+#include <format>
 #include <iostream>
+#include "ListPage.h"
+#include "ModelRowCache.h"
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -21,96 +28,306 @@ public:
     bool insert();
     bool update();
     bool retrieve();    // Only select object by object ID.
+/*
+ * Coroutine versions of save, insert, update and retrieve. The blocking versions
+ * above wait for these on the shared DBExecutionContext. Many model operations can
+ * be in flight at the same time as long as each model object is only used by one
+ * of them.
+ */
+    NSBA::awaitable<DBResult<void>> asyncSave();
+    NSBA::awaitable<DBResult<void>> asyncInsert();
+    NSBA::awaitable<DBResult<void>> asyncUpdate();
+    NSBA::awaitable<DBResult<void>> asyncRetrieve();
     bool isInDataBase() const noexcept { return (primaryKey > 0); };
     bool isModified() const noexcept { return modified; };
-    void clearModified() { modified = false; };
-    bool hasRequiredValues();
-    void reportMissingFields() noexcept;
+    bool hasDirtyColumns() const noexcept { return dirtyColumns.any(); };
+    void clearModified() { modified = false; dirtyColumns.reset(); };
+    virtual bool hasRequiredValues() const = 0;
+    virtual void reportMissingFields() noexcept = 0;
     std::string_view getModelName() const { return modelName; };
-
-protected:
 /*
- * Each model will have 1 or more required fields, the model must specify what those
- * fields are.
+ * The text UPDATE statement for this model, used when lists batch many updates
+ * into a single pipeline. Only valid when the model has dirty columns. The batch
+ * statements take the format options from the caller, a coroutine gets them with
+ * coRoutineGetFormatOptions() rather than waiting for them.
  */
-    virtual void initRequiredFields() = 0;
+    std::string formatBatchUpdateStatement(const NSBM::format_options& formatOptions)
+    {
+        format_opts = formatOptions;
+        return formatUpdateStatement();
+    };
 /*
- * Each model must provide formating for Insert, Update and Select by object ID.
- * Additional select statements will be handled by each model as necessary.
+ * Multi-row inserts, a list joins the values of many models after the model's
+ * INSERT ... VALUES prefix. The values are the parameters of the prepared insert.
  */
-    virtual std::string formatInsertStatement() = 0;
-    virtual std::string formatUpdateStatement() = 0;
-    virtual std::string formatSelectStatement() = 0;
-    virtual bool processResult(NSBM::results& results);
+    virtual std::string_view getBulkInsertPrefix() const = 0;
+    std::string formatBulkInsertValues(const NSBM::format_options& formatOptions)
+    {
+        return NSBM::format_sql(formatOptions, "({})", buildPreparedInsert().parameters);
+    };
+    void setPrimaryKeyFromBulkInsert(std::size_t newPrimaryKey) noexcept
+    {
+        primaryKey = newPrimaryKey;
+        clearModified();
+    };
 /*
- * Each model must provide the process by which the database information will
- * be translated into the specific model.
+ * Undo setPrimaryKeyFromBulkInsert() when the transaction that inserted the model
+ * is rolled back.
  */
-    virtual void processResultRow(NSBM::row_view rv) = 0;
+    void forgetBulkInsert() noexcept
+    {
+        primaryKey = 0;
+        modified = true;
+    };
 
 /*
- * To process TEXT fields that contain model fields.
+ * Multi-row INSERT statements for models that share a bulk insert prefix. Each
+ * statement holds at most MaxRowsPerBulkInsert rows and MaxBulkInsertSize bytes.
  */
-    std::vector<std::string> explodeTextField(std::string const& textField) noexcept;
-    std::string implodeTextField(std::vector<std::string>& fields) noexcept;
-
-    NSBM::date stdchronoDateToBoostMySQLDate(const std::chrono::year_month_day& source) noexcept
+    struct BulkInsertStatements
     {
-        std::chrono::sys_days tp = source;
-        return NSBM::date(tp);
+        std::vector<std::string> statements;
+        std::vector<std::size_t> rowsPerStatement;
     };
+    static constexpr std::size_t MaxRowsPerBulkInsert = 1000;
+    static constexpr std::size_t MaxBulkInsertSize = 1024 * 1024;   // Well below the default max_allowed_packet.
+
+    template<typename ModelPtr>
+    static BulkInsertStatements formatBulkInsertStatements(const NSBM::format_options& formatOptions,
+        const std::vector<ModelPtr>& models)
+    {
+        BulkInsertStatements bulkInserts;
+        std::string insertStatement;
+        std::size_t rowsInStatement = 0;
 
-    std::chrono::year_month_day boostMysqlDateToChronoDate(const NSBM::date& source) noexcept
+        auto finishStatement = [&]()
+        {
+            bulkInserts.statements.push_back(std::move(insertStatement));
+            bulkInserts.rowsPerStatement.push_back(rowsInStatement);
+            insertStatement.clear();
+            rowsInStatement = 0;
+        };
+
+        for (auto model: models)
+        {
+            std::string rowValues = model->formatBulkInsertValues(formatOptions);
+            if (rowsInStatement > 0 && insertStatement.size() + rowValues.size() + 1 > MaxBulkInsertSize)
+            {
+                finishStatement();
+            }
+
+            if (rowsInStatement > 0)
+            {
+                insertStatement += ',';
+            }
+            else
+            {
+                insertStatement.append(model->getBulkInsertPrefix());
+            }
+            insertStatement.append(rowValues);
+            ++rowsInStatement;
+
+            if (rowsInStatement == MaxRowsPerBulkInsert)
+            {
+                finishStatement();
+            }
+        }
+
+        if (rowsInStatement > 0)
+        {
+            finishStatement();
+        }
+
+        return bulkInserts;
+    }
+
+/*
+ * InnoDB gives the rows of a multi-row INSERT consecutive auto-increment values,
+ * autoIncrementStep apart, starting at the statement's last_insert_id().
+ */
+    template<typename ModelPtr>
+    static void assignBulkInsertKeys(const std::vector<ModelPtr>& models, const BulkInsertStatements& bulkInserts,
+        const std::vector<std::uint64_t>& firstInsertedIDs, std::uint64_t autoIncrementStep)
+    {
+        std::size_t modelIdx = 0;
+        for (std::size_t statementIdx = 0; statementIdx < firstInsertedIDs.size(); ++statementIdx)
+        {
+            for (std::size_t rowIdx = 0; rowIdx < bulkInserts.rowsPerStatement[statementIdx]; ++rowIdx)
+            {
+                models[modelIdx++]->setPrimaryKeyFromBulkInsert(
+                    firstInsertedIDs[statementIdx] + (rowIdx * autoIncrementStep));
+            }
+        }
+    }
+
+/*
+ * Models that other models reference by foreign key are written first when many
+ * models are saved together, lower flush orders are written first.
+ */
+    virtual unsigned int getFlushOrder() const noexcept { return 0; };
+/*
+ * Fill the model from a row of its own base select statement, used when one query
+ * returns many models.
+ */
+    void loadFromResultRow(NSBM::row_view rv)
+    {
+        processResultRow(rv);
+        clearModified();
+    };
+/*
+ * Each model type has one row cache for its table, see ModelRowCache. Any code
+ * that writes a model must invalidate its cached row.
+ */
+    virtual ModelRowCache& getRowCache() const = 0;
+    void invalidateCachedRow()
+    {
+        if (isInDataBase())
+        {
+            getRowCache().invalidate(primaryKey);
+        }
+    };
+/*
+ * Rows of other tables that belong to the model, such as the dependencies of a task.
+ * Changes to the related rows are written with the model's own row, in the same
+ * transaction, and are kept until clearRelatedRowChanges(). The related rows of
+ * many models of the same type are loaded together, the models are loaded from
+ * their own rows first.
+ */
+    virtual bool hasRelatedRowChanges() const { return false; };
+    std::vector<std::string> formatRelatedRowStatements(const NSBM::format_options& formatOptions)
     {
-        const std::chrono::year year{source.year()};
-        const std::chrono::month month{source.month()};
-        const std::chrono::day day{source.day()};
-        return std::chrono::year_month_day{year, month, day};
+        format_opts = formatOptions;
+        return formatRelatedRows();
     };
+    virtual void clearRelatedRowChanges() {};
+    virtual NSBA::awaitable<void> coRoutineLoadRelatedRows(std::span<ModelDBInterface* const>) { co_return; };
 
-    NSBM::datetime stdChronoTimePointToBoostDateTime(std::chrono::system_clock::time_point source) noexcept
+protected:
+/*
+ * Each model will have 1 or more required fields. A model lists them once in a
+ * static constexpr table of RequiredField and implements hasRequiredValues() and
+ * reportMissingFields() with the two functions below, checking the fields costs
+ * no allocations.
+ */
+    template<typename ModelType>
+    struct RequiredField
     {
-        return NSBM::datetime(std::chrono::time_point_cast<boost::mysql::datetime::time_point::duration>(source));
+        bool (ModelType::*isMissing)() const;
+        std::string_view fieldName;
     };
 
-    std::chrono::system_clock::time_point boostMysqlDateTimeToChronoTimePoint(NSBM::datetime dbDateTime)
+    template<typename ModelType, std::size_t FieldCount>
+    bool requiredFieldsPresent(const std::array<RequiredField<ModelType>, FieldCount>& requiredFields) const
     {
-        return std::chrono::time_point_cast<std::chrono::system_clock::time_point::duration>(dbDateTime.as_time_point());
+        const ModelType& model = static_cast<const ModelType&>(*this);
+        for (const RequiredField<ModelType>& requiredField: requiredFields)
+        {
+            if ((model.*requiredField.isMissing)())
+            {
+                return false;
+            }
+        }
+
+        return true;
     }
 
-    std::optional<NSBM::date> optionalDateConversion(std::optional<std::chrono::year_month_day> optDate)
+    template<typename ModelType, std::size_t FieldCount>
+    void reportMissingRequiredFields(const std::array<RequiredField<ModelType>, FieldCount>& requiredFields) noexcept
     {
-        std::optional<NSBM::date> mySqlDate;
+        const ModelType& model = static_cast<const ModelType&>(*this);
+        for (const RequiredField<ModelType>& requiredField: requiredFields)
+        {
+            if ((model.*requiredField.isMissing)())
+            {
+                appendErrorMessage(std::format("Missing {} required {}!\n", modelName, requiredField.fieldName));
+            }
+        }
+    }
 
-        if (optDate.has_value())
+/*
+ * Each model must provide formating for Insert.
+ * Additional select statements will be handled by each model as necessary.
+ */
+    virtual std::string formatInsertStatement() = 0;
+/*
+ * The same Insert and Select by object ID as prepared statements, these are the
+ * statements used by insert() and retrieve().
+ */
+    virtual PreparedQuery buildPreparedInsert() = 0;
+    virtual PreparedQuery buildPreparedSelect() = 0;
+/*
+ * Updates only write the dirty columns. Each model describes its table, the column
+ * names are indexed by the column indexes of the model's base select statement,
+ * index 0 is the primary key. The prepared insert parameters must be in the same
+ * order as the select columns that follow the primary key.
+ */
+    struct UpdateColumns
+    {
+        std::string_view tableName;
+        std::span<const std::string_view> columnNames;
+    };
+    virtual UpdateColumns getUpdateColumns() const = 0;
+/*
+ * Appends the seek condition, ORDER BY and LIMIT of a page to a list query, nothing
+ * is appended when the page is the whole list. The seek condition starts with AND
+ * when the query already has a WHERE clause. Lists ordered by date pass the date
+ * column, the primary key breaks ties between rows with the same date.
+ */
+    void appendListPage(NSBM::format_context& fctx, const ListPage& page, bool queryHasWhere,
+        std::string_view dateColumn = {}) const;
+    std::string formatUpdateStatement();
+    PreparedQuery buildPreparedUpdate();
+/*
+ * The statements that write the related row changes, a model that is not yet in the
+ * database refers to itself as LAST_INSERT_ID().
+ */
+    virtual std::vector<std::string> formatRelatedRows() { return {}; };
+/*
+ * Setters only mark a column dirty when the value changes.
+ */
+    template<typename MemberType, typename ValueType>
+    void setColumnValue(MemberType& member, const ValueType& newValue, std::size_t columnIdx)
+    {
+        if (!(member == newValue))
         {
-            mySqlDate = stdchronoDateToBoostMySQLDate(optDate.value());
+            member = newValue;
+            markColumnDirty(columnIdx);
         }
-        return mySqlDate;
+    }
+    void markColumnDirty(std::size_t columnIdx)
+    {
+        dirtyColumns.set(columnIdx);
+        modified = true;
     };
-
-    std::optional<NSBM::datetime> optionalDateTimeConversion(std::optional<std::chrono::system_clock::time_point> optDateTime)
+    virtual bool processResult(NSBM::results& results);
+    bool loadFromRowCache(std::size_t cachedPrimaryKey);
+    NSBA::awaitable<DBResult<void>> coRoutineSelectSingleModel(PreparedQuery selectQuery, std::string caller,
+        std::size_t cachedPrimaryKey = 0);
+/*
+ * Each model must provide the process by which the database information will
+ * be translated into the specific model.
+ */
+    virtual void processResultRow(NSBM::row_view rv) = 0;
+/*
+ * Models decode rows by schema column index without bounds checks, the row is
+ * checked once against the number of columns in the schema.
+ */
+    void checkRowColumnCount(NSBM::row_view rv, std::size_t schemaColumnCount) const
     {
-        std::optional<NSBM::datetime> timeStamp;
-
-        if (optDateTime.has_value())
+        if (rv.size() != schemaColumnCount)
         {
-            timeStamp = stdChronoTimePointToBoostDateTime(optDateTime.value());
+            throw std::runtime_error(std::format("{} row has {} columns, expected {}", modelName, rv.size(),
+                schemaColumnCount));
         }
-        return timeStamp;
     };
 
 protected:
     std::size_t primaryKey;
     std::string_view modelName;
     bool modified;
-    char delimiter;
-    struct RequireField
-    {
-        std::function<bool(void)>errorCondition;
-        std::string fieldName;
-    };
-    std::vector<RequireField> missingRequiredFieldsTests;
+    static constexpr std::size_t MaxModelColumns = 32;
+    std::bitset<MaxModelColumns> dirtyColumns;
+    char delimiter;         // Of TEXT fields that hold a list of values, see DelimitedTextCodec.
 };
 
 #endif // MODELDBINTERFACECORE_H_
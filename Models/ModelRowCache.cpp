@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <array>
+#include <boost/mysql.hpp>
+#include <format>
+#include <iostream>
+#include <list>
+#include "ModelRowCache.h"
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+std::mutex ModelRowCache::cachesMutex;
+
+ModelRowCache::ModelRowCache(std::string_view tableNameIn, std::size_t capacityIn)
+: tableName{tableNameIn},
+  capacity{capacityIn},
+  generation{0},
+  clearedGeneration{0},
+  invalidatedGenerations{},
+  hits{0},
+  misses{0},
+  evictions{0},
+  invalidations{0}
+{
+    std::lock_guard<std::mutex> guard(cachesMutex);
+    allCaches().push_back(this);
+}
+
+ModelRowCache::~ModelRowCache()
+{
+    std::lock_guard<std::mutex> guard(cachesMutex);
+    std::vector<ModelRowCache*>& caches = allCaches();
+    caches.erase(std::remove(caches.begin(), caches.end(), this), caches.end());
+}
+
+std::vector<ModelRowCache*>& ModelRowCache::allCaches()
+{
+    static std::vector<ModelRowCache*> caches;
+    return caches;
+}
+
+bool ModelRowCache::isEnabled() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return capacity > 0;
+}
+
+void ModelRowCache::setCapacity(std::size_t newCapacity)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    capacity = newCapacity;
+    evictToCapacity();
+}
+
+std::optional<NSBM::row> ModelRowCache::find(std::size_t primaryKey)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    if (capacity == 0)
+    {
+        return std::nullopt;
+    }
+
+    auto found = rowsByKey.find(primaryKey);
+    if (found == rowsByKey.end())
+    {
+        ++misses;
+        return std::nullopt;
+    }
+
+    ++hits;
+    rowsByUse.splice(rowsByUse.begin(), rowsByUse, found->second);
+    return found->second->row;
+}
+
+std::uint64_t ModelRowCache::getGeneration() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return generation;
+}
+
+void ModelRowCache::store(std::size_t primaryKey, NSBM::row_view row, std::uint64_t readGeneration)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    if (capacity == 0 || invalidatedSince(primaryKey, readGeneration))
+    {
+        return;
+    }
+
+    auto found = rowsByKey.find(primaryKey);
+    if (found != rowsByKey.end())
+    {
+        found->second->row = NSBM::row(row);
+        rowsByUse.splice(rowsByUse.begin(), rowsByUse, found->second);
+        return;
+    }
+
+    rowsByUse.push_front(CachedRow{primaryKey, NSBM::row(row), std::nullopt});
+    rowsByKey.emplace(primaryKey, rowsByUse.begin());
+    evictToCapacity();
+}
+
+/*
+ * Finding the related IDs does not count as a lookup, the row was already counted.
+ */
+std::optional<std::vector<std::size_t>> ModelRowCache::findRelatedIDs(std::size_t primaryKey)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    auto found = rowsByKey.find(primaryKey);
+    if (found == rowsByKey.end())
+    {
+        return std::nullopt;
+    }
+
+    return found->second->relatedIDs;
+}
+
+/*
+ * The related IDs are only stored with a cached row.
+ */
+void ModelRowCache::storeRelatedIDs(std::size_t primaryKey, std::vector<std::size_t> relatedIDs,
+    std::uint64_t readGeneration)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    auto found = rowsByKey.find(primaryKey);
+    if (found == rowsByKey.end() || invalidatedSince(primaryKey, readGeneration))
+    {
+        return;
+    }
+
+    found->second->relatedIDs = std::move(relatedIDs);
+}
+
+void ModelRowCache::invalidate(std::size_t primaryKey)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    invalidatedGenerations[primaryKey % InvalidationSlots] = ++generation;
+
+    auto found = rowsByKey.find(primaryKey);
+    if (found != rowsByKey.end())
+    {
+        rowsByUse.erase(found->second);
+        rowsByKey.erase(found);
+        ++invalidations;
+    }
+}
+
+void ModelRowCache::clear()
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    clearedGeneration = ++generation;
+    rowsByUse.clear();
+    rowsByKey.clear();
+}
+
+ModelRowCache::Statistics ModelRowCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    return Statistics{hits, misses, evictions, invalidations, rowsByKey.size(), capacity};
+}
+
+void ModelRowCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+    invalidations = 0;
+}
+
+void ModelRowCache::reportStatistics(std::ostream& os) const
+{
+    Statistics statistics = getStatistics();
+
+    os << std::format("{} row cache: {} of {} rows, {} hits, {} misses ({:.1f}% hit), {} evictions, {} invalidations\n",
+        tableName, statistics.size, statistics.capacity, statistics.hits, statistics.misses,
+        statistics.hitRatio() * 100.0, statistics.evictions, statistics.invalidations);
+}
+
+void ModelRowCache::reportAllCacheStatistics(std::ostream& os)
+{
+    std::lock_guard<std::mutex> guard(cachesMutex);
+
+    for (const ModelRowCache* cache: allCaches())
+    {
+        if (cache->getStatistics().capacity > 0)
+        {
+            cache->reportStatistics(os);
+        }
+    }
+}
+
+/*
+ * The caller holds the cache mutex.
+ */
+void ModelRowCache::evictToCapacity()
+{
+    while (rowsByKey.size() > capacity)
+    {
+        rowsByKey.erase(rowsByUse.back().primaryKey);
+        rowsByUse.pop_back();
+        ++evictions;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef MODELROWCACHE_H_
+#define MODELROWCACHE_H_
+
+#include <array>
+#include <boost/mysql.hpp>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace NSBM = boost::mysql;
+
+/*
+ * Process wide cache of the rows of one table, keyed by primary key.
+ *
+ * The cache holds the base select row of each model rather than the model object,
+ * a model that is found in the cache is loaded from the row exactly as if it had
+ * been selected, so every caller still gets its own model and changes to one model
+ * are never seen through another.
+ *
+ * The cache is opt in, a capacity of 0 (the default) disables it. When the cache
+ * is full the least recently used row is evicted. A model's row is removed when the
+ * model is saved, the cache does not see changes made by other processes, only
+ * enable it when this process is the only writer of the table.
+ *
+ * A cached row can also hold the IDs of the model's related rows, such as the
+ * dependencies of a task. They are only kept while the row is cached and are
+ * invalidated with it, so a model's related rows must be written together with
+ * the invalidation of its row.
+ *
+ * A row read from the database may already be stale when it is stored, if the row
+ * was invalidated while the select was running. Readers take getGeneration() before
+ * the select and pass it to store(), a row invalidated since then is not stored.
+ */
+class ModelRowCache
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+        std::uint64_t invalidations;
+        std::size_t size;
+        std::size_t capacity;
+        double hitRatio() const noexcept
+        {
+            std::uint64_t lookups = hits + misses;
+            return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+        };
+    };
+
+    ModelRowCache(std::string_view tableNameIn, std::size_t capacityIn);
+    ~ModelRowCache();
+    ModelRowCache(const ModelRowCache&) = delete;
+    ModelRowCache& operator=(const ModelRowCache&) = delete;
+
+    bool isEnabled() const;
+/*
+ * Changing the capacity evicts rows until the cache fits, 0 empties and disables
+ * the cache.
+ */
+    void setCapacity(std::size_t newCapacity);
+    std::optional<NSBM::row> find(std::size_t primaryKey);
+    std::uint64_t getGeneration() const;
+    void store(std::size_t primaryKey, NSBM::row_view row, std::uint64_t readGeneration);
+    std::optional<std::vector<std::size_t>> findRelatedIDs(std::size_t primaryKey);
+    void storeRelatedIDs(std::size_t primaryKey, std::vector<std::size_t> relatedIDs,
+        std::uint64_t readGeneration);
+    void invalidate(std::size_t primaryKey);
+    void clear();
+    Statistics getStatistics() const;
+    void resetStatistics();
+    void reportStatistics(std::ostream& os) const;
+    static void reportAllCacheStatistics(std::ostream& os);
+
+private:
+    struct CachedRow
+    {
+        std::size_t primaryKey;
+        NSBM::row row;
+        std::optional<std::vector<std::size_t>> relatedIDs;
+    };
+    using LRUList = std::list<CachedRow>;
+/*
+ * The generation of the last invalidation of each group of primary keys, keys that
+ * share a slot only cost an extra select.
+ */
+    static constexpr std::size_t InvalidationSlots = 1024;
+
+    bool invalidatedSince(std::size_t primaryKey, std::uint64_t readGeneration) const noexcept
+    {
+        return clearedGeneration > readGeneration ||
+            invalidatedGenerations[primaryKey % InvalidationSlots] > readGeneration;
+    };
+    void evictToCapacity();
+    static std::vector<ModelRowCache*>& allCaches();
+
+    std::string tableName;
+    std::size_t capacity;
+    mutable std::mutex cacheMutex;
+    LRUList rowsByUse;      // Most recently used first.
+    std::unordered_map<std::size_t, LRUList::iterator> rowsByKey;
+    std::uint64_t generation;
+    std::uint64_t clearedGeneration;
+    std::array<std::uint64_t, InvalidationSlots> invalidatedGenerations;
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t evictions;
+    std::uint64_t invalidations;
+
+    static std::mutex cachesMutex;
+};
+
+#endif // MODELROWCACHE_H_
+
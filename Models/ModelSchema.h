@@ -0,0 +1,166 @@
+#ifndef MODELSCHEMA_H_
+#define MODELSCHEMA_H_
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/*
+ * Compile time description of the table behind a model. The columns are listed
+ * in the order of the model's base select statement, column 0 is the primary key
+ * and the remaining columns are the insert columns in the same order.
+ *
+ * The select, insert and update text and the column indexes used to decode a row
+ * are all generated from the one list of column names, so they can't get out of
+ * order. A column name that is not in the schema is a compile error.
+ */
+enum class SchemaStatement
+{
+    Select,
+    InsertPrefix,
+    Insert,
+    UpdateAll
+};
+
+template<std::size_t ColumnCount>
+struct ModelSchema
+{
+    static_assert(ColumnCount > 1, "A model schema needs a primary key and at least one column");
+
+    std::string_view tableName;
+    std::array<std::string_view, ColumnCount> columnNames;
+
+    static constexpr std::size_t columnCount = ColumnCount;
+    static constexpr std::size_t parameterCount = ColumnCount - 1;
+
+    consteval std::size_t columnIdx(std::string_view columnName) const
+    {
+        for (std::size_t idx = 0; idx < ColumnCount; ++idx)
+        {
+            if (columnNames[idx] == columnName)
+            {
+                return idx;
+            }
+        }
+
+        throw "column name is not in the model schema";
+    }
+
+/*
+ * The position of a column in the insert parameters, which don't include the
+ * primary key.
+ */
+    static constexpr std::size_t parameterIdx(std::size_t columnIdx) noexcept
+    {
+        return columnIdx - 1;
+    }
+
+    template<typename Text>
+    constexpr void writeStatement(SchemaStatement statement, Text& text) const
+    {
+        if (statement == SchemaStatement::Select)
+        {
+            text.append("SELECT ");
+            writeColumnList(0, text);
+            text.append(" FROM ");
+            text.append(tableName);
+            text.append(" ");
+            return;
+        }
+
+        if (statement == SchemaStatement::UpdateAll)
+        {
+            text.append("UPDATE ");
+            text.append(tableName);
+            text.append(" SET ");
+            for (std::size_t idx = 1; idx < ColumnCount; ++idx)
+            {
+                text.append(idx > 1 ? ", " : "");
+                text.append(columnNames[idx]);
+                text.append(" = ?");
+            }
+            text.append(" WHERE ");
+            text.append(columnNames[0]);
+            text.append(" = ?");
+            return;
+        }
+
+        text.append("INSERT INTO ");
+        text.append(tableName);
+        text.append(" (");
+        writeColumnList(1, text);
+        text.append(") VALUES ");
+        if (statement == SchemaStatement::Insert)
+        {
+            text.append("(");
+            for (std::size_t parameter = 0; parameter < parameterCount; ++parameter)
+            {
+                text.append(parameter ? ", ?" : "?");
+            }
+            text.append(")");
+        }
+    }
+
+private:
+    template<typename Text>
+    constexpr void writeColumnList(std::size_t firstColumn, Text& text) const
+    {
+        for (std::size_t idx = firstColumn; idx < ColumnCount; ++idx)
+        {
+            if (idx > firstColumn)
+            {
+                text.append(", ");
+            }
+            text.append(columnNames[idx]);
+        }
+    }
+};
+
+struct SchemaTextLength
+{
+    std::size_t length = 0;
+    constexpr void append(std::string_view text) noexcept { length += text.size(); }
+};
+
+template<std::size_t Length>
+struct SchemaText
+{
+    std::array<char, Length> characters{};
+    std::size_t length = 0;
+    constexpr void append(std::string_view text) noexcept
+    {
+        for (char character: text)
+        {
+            characters[length++] = character;
+        }
+    }
+    constexpr std::string_view view() const noexcept { return std::string_view(characters.data(), length); }
+};
+
+template<const auto& Schema, SchemaStatement Statement>
+consteval std::size_t schemaStatementLength()
+{
+    SchemaTextLength counter;
+    Schema.writeStatement(Statement, counter);
+    return counter.length;
+}
+
+template<const auto& Schema, SchemaStatement Statement>
+consteval SchemaText<schemaStatementLength<Schema, Statement>()> buildSchemaStatement()
+{
+    SchemaText<schemaStatementLength<Schema, Statement>()> text;
+    Schema.writeStatement(Statement, text);
+    return text;
+}
+
+template<const auto& Schema, SchemaStatement Statement>
+inline constexpr SchemaText<schemaStatementLength<Schema, Statement>()> schemaStatementStorage =
+    buildSchemaStatement<Schema, Statement>();
+
+/*
+ * The generated statement text, for example schemaStatement<taskSchema, SchemaStatement::Select>.
+ */
+template<const auto& Schema, SchemaStatement Statement>
+inline constexpr std::string_view schemaStatement = schemaStatementStorage<Schema, Statement>.view();
+
+#endif // MODELSCHEMA_H_
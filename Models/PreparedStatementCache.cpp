@@ -0,0 +1,74 @@
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include "PreparedStatementCache.h"
+#include <string>
+#include <string_view>
+
+NSBA::awaitable<NSBM::statement> PreparedStatementCache::asyncGetStatement(NSBM::any_connection& conn,
+    std::string_view statementKey, std::string_view sqlText)
+{
+    std::optional<NSBM::statement> cachedStatement;
+
+    {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        StatementMap& statements = statementsByConnection[&conn].statements;
+        auto found = statements.find(std::string(statementKey));
+        if (found != statements.end())
+        {
+            cachedStatement = found->second;
+        }
+    }
+
+    if (cachedStatement.has_value())
+    {
+        co_return cachedStatement.value();
+    }
+
+/*
+ * The connection is owned by the caller for the duration of the call, no other
+ * coroutine can prepare a statement on it at the same time.
+ */
+    NSBM::statement newStatement = co_await conn.async_prepare_statement(sqlText);
+
+    {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        statementsByConnection[&conn].statements.insert_or_assign(std::string(statementKey), newStatement);
+    }
+
+    co_return newStatement;
+}
+
+void PreparedStatementCache::forgetConnection(const NSBM::any_connection& conn)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    statementsByConnection.erase(&conn);
+}
+
+/*
+ * The connection is in use until it is returned, a connection destroyed by the
+ * pool without keepConnection() is assumed to have been reset.
+ */
+void PreparedStatementCache::claimConnection(const NSBM::any_connection& conn)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    ConnectionStatements& connectionStatements = statementsByConnection[&conn];
+    std::optional<std::uint32_t> sessionID = conn.connection_id();
+    if (!connectionStatements.keptWithoutReset || connectionStatements.sessionID != sessionID)
+    {
+        connectionStatements.statements.clear();
+        connectionStatements.sessionID = sessionID;
+    }
+    connectionStatements.keptWithoutReset = false;
+}
+
+void PreparedStatementCache::keepConnection(const NSBM::any_connection& conn)
+{
+    std::lock_guard<std::mutex> guard(cacheMutex);
+
+    statementsByConnection[&conn].keptWithoutReset = true;
+}
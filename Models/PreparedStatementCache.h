@@ -0,0 +1,58 @@
+#ifndef PREPAREDSTATEMENTCACHE_H_
+#define PREPAREDSTATEMENTCACHE_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace NSBA = boost::asio;
+namespace NSBM = boost::mysql;
+
+/*
+ * Prepared statements belong to the connection that prepared them. Each pooled
+ * connection has its own set of statements, keyed by the statement key the model
+ * provides. A statement is prepared the first time a key is used on a connection
+ * and reused by every later execution on that connection.
+ *
+ * A session reset (COM_RESET_CONNECTION) or a reconnect deallocates the statements
+ * on the server while the connection object, and so its key here, stays the same.
+ * The pool calls claimConnection() each time it hands out a connection, the
+ * statements are only kept if the connection was last returned through
+ * keepConnection() without a reset and the server session is the same one the
+ * statements were prepared in.
+ */
+class PreparedStatementCache
+{
+public:
+    PreparedStatementCache() = default;
+    ~PreparedStatementCache() = default;
+    PreparedStatementCache(const PreparedStatementCache&) = delete;
+    PreparedStatementCache& operator=(const PreparedStatementCache&) = delete;
+
+    NSBA::awaitable<NSBM::statement> asyncGetStatement(NSBM::any_connection& conn,
+        std::string_view statementKey, std::string_view sqlText);
+    void forgetConnection(const NSBM::any_connection& conn);
+    void claimConnection(const NSBM::any_connection& conn);
+    void keepConnection(const NSBM::any_connection& conn);
+
+private:
+    using StatementMap = std::unordered_map<std::string, NSBM::statement>;
+
+    struct ConnectionStatements
+    {
+        std::optional<std::uint32_t> sessionID;
+        bool keptWithoutReset = false;
+        StatementMap statements;
+    };
+
+    std::mutex cacheMutex;
+    std::unordered_map<const NSBM::any_connection*, ConnectionStatements> statementsByConnection;
+};
+
+#endif // PREPAREDSTATEMENTCACHE_H_
+
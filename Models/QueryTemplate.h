@@ -0,0 +1,67 @@
+#ifndef QUERYTEMPLATE_H_
+#define QUERYTEMPLATE_H_
+
+#include <algorithm>
+#include <boost/mysql.hpp>
+#include <string>
+#include <string_view>
+
+/*
+ * A named text protocol query whose static part is rendered once. The prefix is
+ * the select statement and the WHERE clause up to the first parameter, only the
+ * rest of the WHERE clause is formatted for each call.
+ *
+ * Each query is built in one allocation, reserved for the prefix and
+ * ParameterReserve characters of parameters, and is returned by value so it can be
+ * kept across co_await. The prefix holds no values, so it does not depend on the
+ * format options of the connection.
+ */
+class QueryTemplate
+{
+public:
+    QueryTemplate(std::string_view selectStatement, NSBM::constant_string_view whereFormat)
+    {
+        std::string_view whereText = whereFormat.get();
+        std::size_t firstParameter = std::min(whereText.find('{'), whereText.size());
+        prefix = selectStatement;
+        prefix.append(whereText.substr(0, firstParameter));
+        parameterFormat = whereText.substr(firstParameter);
+    }
+    ~QueryTemplate() = default;
+
+    template<NSBM::formattable... ParameterTypes>
+    std::string format(const NSBM::format_options& options, const ParameterTypes&... parameters) const
+    {
+        return finish(start(options, parameters...));
+    }
+
+/*
+ * For queries that add to the end of the template, such as the ORDER BY and LIMIT
+ * of a list page.
+ */
+    template<NSBM::formattable... ParameterTypes>
+    NSBM::format_context start(const NSBM::format_options& options, const ParameterTypes&... parameters) const
+    {
+        std::string query;
+        query.reserve(prefix.size() + ParameterReserve);
+
+        NSBM::format_context fctx(options, std::move(query));
+        fctx.append_raw(NSBM::runtime(prefix));
+        NSBM::format_sql_to(fctx, NSBM::runtime(parameterFormat), parameters...);
+
+        return fctx;
+    }
+
+    static std::string finish(NSBM::format_context&& fctx)
+    {
+        return std::move(fctx).get().value();
+    }
+
+private:
+    static constexpr std::size_t ParameterReserve = 128;   // Room for the parameters, ORDER BY and LIMIT.
+
+    std::string prefix;
+    std::string_view parameterFormat;
+};
+
+#endif // QUERYTEMPLATE_H_
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include "DBConnectionPool.h"
+#include <exception>
+#include <format>
+#include "ModelRowCache.h"
+#include "ReadyTaskTracker.h"
+#include <span>
+#include <string>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include <vector>
+
+ReadyTaskTracker::ReadyTaskTracker()
+: CoreDBInterface()
+{
+}
+
+ReadyTaskTracker::ReadyTaskTracker(const TaskListValues& tasksIn)
+: CoreDBInterface(), tasks{tasksIn}
+{
+    std::erase(tasks, nullptr);
+    std::ranges::sort(tasks, {}, &TaskModel::getTaskID);
+    auto duplicates = std::ranges::unique(tasks, {}, &TaskModel::getTaskID);
+    tasks.erase(duplicates.begin(), duplicates.end());
+
+    for (const TaskModel_shp& task: tasks)
+    {
+        taskIDs.push_back(task->getTaskID());
+        completed.push_back(task->getStatus() == TaskModel::TaskStatus::Complete);
+    }
+
+/*
+ * The dependents of each task in one array with an offset per task, counted
+ * first and then filled.
+ */
+    unmetDependencies.assign(tasks.size(), 0);
+    dependentOffsets.assign(tasks.size() + 1, 0);
+    std::vector<std::vector<std::size_t>> dependencies(tasks.size());
+    for (std::size_t task = 0; task < tasks.size(); ++task)
+    {
+        dependencies[task] = tasks[task]->getDependencies();
+        for (std::size_t dependsOn: dependencies[task])
+        {
+            if (TaskIndex dependency = findIndex(dependsOn); dependency != NoTask)
+            {
+                ++dependentOffsets[dependency + 1];
+                unmetDependencies[task] += completed[dependency]? 0 : 1;
+            }
+        }
+    }
+    for (std::size_t task = 0; task < tasks.size(); ++task)
+    {
+        dependentOffsets[task + 1] += dependentOffsets[task];
+    }
+
+    dependents.resize(dependentOffsets.back());
+    std::vector<std::size_t> nextDependent(dependentOffsets.begin(), dependentOffsets.end() - 1);
+    for (std::size_t task = 0; task < tasks.size(); ++task)
+    {
+        for (std::size_t dependsOn: dependencies[task])
+        {
+            if (TaskIndex dependency = findIndex(dependsOn); dependency != NoTask)
+            {
+                dependents[nextDependent[dependency]++] = static_cast<TaskIndex>(task);
+            }
+        }
+    }
+
+/*
+ * Tasks still waiting when their dependencies were already complete.
+ */
+    TaskListValues alreadyReady;
+    for (std::size_t task = 0; task < tasks.size(); ++task)
+    {
+        if (!completed[task] && unmetDependencies[task] == 0)
+        {
+            becameReady(static_cast<TaskIndex>(task), alreadyReady);
+        }
+    }
+}
+
+TaskListValues ReadyTaskTracker::completeTask(std::size_t taskID)
+{
+    TaskListValues readyTasks;
+    TaskIndex task = findIndex(taskID);
+    if (task == NoTask || completed[task])
+    {
+        return readyTasks;
+    }
+
+    completed[task] = 1;
+    if (tasks[task]->getStatus() != TaskModel::TaskStatus::Complete)
+    {
+        tasks[task]->markComplete();
+    }
+
+    for (std::size_t dependent = dependentOffsets[task]; dependent < dependentOffsets[task + 1]; ++dependent)
+    {
+        TaskIndex waitingTask = dependents[dependent];
+        if (--unmetDependencies[waitingTask] == 0 && !completed[waitingTask])
+        {
+            becameReady(waitingTask, readyTasks);
+        }
+    }
+
+    return readyTasks;
+}
+
+TaskListValues ReadyTaskTracker::getReadyTasks() const
+{
+    TaskListValues readyTasks;
+    for (std::size_t task = 0; task < tasks.size(); ++task)
+    {
+        if (!completed[task] && unmetDependencies[task] == 0)
+        {
+            readyTasks.push_back(tasks[task]);
+        }
+    }
+
+    return readyTasks;
+}
+
+bool ReadyTaskTracker::isReady(std::size_t taskID) const
+{
+    TaskIndex task = findIndex(taskID);
+
+    return task != NoTask && !completed[task] && unmetDependencies[task] == 0;
+}
+
+std::size_t ReadyTaskTracker::getUnmetDependencyCount(std::size_t taskID) const
+{
+    TaskIndex task = findIndex(taskID);
+
+    return task == NoTask? 0 : unmetDependencies[task];
+}
+
+bool ReadyTaskTracker::flushStatusChanges()
+{
+    return waitForCoRoutine(asyncFlushStatusChanges()).has_value();
+}
+
+/*
+ * Tasks completed or given another status since they were queued are dropped. The
+ * rows still Waiting_for_Dependency are locked with SELECT ... FOR UPDATE and only
+ * those are updated, all in one transaction, so only their models get the new
+ * status. A queued task whose row someone else changed is reported in the error
+ * messages and its model is left alone. The UPDATE is written directly rather than
+ * through the models, so the cached rows of the tasks are invalidated here. A model
+ * that had no other changes is left unmodified, its status now matches the
+ * database.
+ */
+NSBA::awaitable<CoreDBInterface::DBResult<std::uint64_t>> ReadyTaskTracker::asyncFlushStatusChanges()
+{
+    errorMessages.clear();
+
+    std::erase_if(pendingStatusChanges, [this](TaskIndex task) {
+        return completed[task] || tasks[task]->getStatus() != TaskModel::TaskStatus::Waiting_for_Dependency;
+    });
+
+    if (pendingStatusChanges.empty())
+    {
+        co_return 0;
+    }
+
+    std::vector<std::size_t> queuedTaskIDs;
+    for (TaskIndex task: pendingStatusChanges)
+    {
+        queuedTaskIDs.push_back(taskIDs[task]);
+    }
+
+    constexpr unsigned int notStarted = static_cast<unsigned int>(TaskModel::TaskStatus::Not_Started);
+    constexpr unsigned int waiting = static_cast<unsigned int>(TaskModel::TaskStatus::Waiting_for_Dependency);
+
+    DBConnectionPool& pool = DBConnectionPool::getPool(dbConnectionParameters);
+    NSBM::pooled_connection conn = co_await pool.asyncGetConnection();
+    std::vector<std::size_t> changedTaskIDs;
+    std::string failure;
+    bool connectionLost = false;
+
+    try
+    {
+        NSBM::format_options formatOptions = conn->format_opts().value();
+        std::span<const std::size_t> allTaskIDs(queuedTaskIDs);
+        NSBM::results statementResult;
+        co_await conn->async_execute("START TRANSACTION", statementResult);
+
+        for (std::size_t chunkStart = 0; chunkStart < allTaskIDs.size(); chunkStart += MaxTaskIDsPerUpdate)
+        {
+            std::span<const std::size_t> chunk = allTaskIDs.subspan(chunkStart,
+                std::min(MaxTaskIDsPerUpdate, allTaskIDs.size() - chunkStart));
+
+            co_await conn->async_execute(NSBM::format_sql(formatOptions,
+                "SELECT TaskID FROM Tasks WHERE Status = {} AND TaskID IN ({}) FOR UPDATE", waiting, chunk),
+                statementResult);
+
+            std::vector<std::size_t> waitingTaskIDs;
+            for (auto row: statementResult.rows())
+            {
+                waitingTaskIDs.push_back(row.at(0).as_uint64());
+            }
+            if (waitingTaskIDs.empty())
+            {
+                continue;
+            }
+
+            co_await conn->async_execute(NSBM::format_sql(formatOptions,
+                "UPDATE Tasks SET Status = {} WHERE TaskID IN ({})", notStarted, waitingTaskIDs), statementResult);
+            changedTaskIDs.insert(changedTaskIDs.end(), waitingTaskIDs.begin(), waitingTaskIDs.end());
+        }
+
+        co_await conn->async_execute("COMMIT", statementResult);
+    }
+
+    catch (const NSBM::error_with_diagnostics& e)
+    {
+        connectionLost = DBConnectionPool::isConnectionLevelError(e.code());
+        failure = std::format("In ReadyTaskTracker::flushStatusChanges : {}", e.what());
+    }
+
+    catch (const std::exception& e)
+    {
+        failure = std::format("In ReadyTaskTracker::flushStatusChanges : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_await pool.asyncAbandonTransaction(conn, connectionLost);
+
+        co_return operationFailed(failure);
+    }
+
+    pool.returnWithoutReset(conn);
+
+    std::ranges::sort(changedTaskIDs);
+    ModelRowCache& rowCache = TaskModel::taskRowCache();
+    for (TaskIndex task: pendingStatusChanges)
+    {
+        rowCache.invalidate(taskIDs[task]);
+        if (!std::ranges::binary_search(changedTaskIDs, taskIDs[task]))
+        {
+            appendErrorMessage(std::format("Task {} is no longer waiting for a dependency, status not changed",
+                taskIDs[task]));
+            continue;
+        }
+
+        TaskModel_shp changedTask = tasks[task];
+        bool hadChanges = changedTask->isModified();
+        changedTask->setStatus(TaskModel::TaskStatus::Not_Started);
+        if (!hadChanges)
+        {
+            changedTask->clearModified();
+        }
+    }
+    pendingStatusChanges.clear();
+
+    co_return changedTaskIDs.size();
+}
+
+ReadyTaskTracker::TaskIndex ReadyTaskTracker::findIndex(std::size_t taskID) const
+{
+    auto found = std::ranges::lower_bound(taskIDs, taskID);
+    if (found == taskIDs.end() || *found != taskID)
+    {
+        return NoTask;
+    }
+
+    return static_cast<TaskIndex>(found - taskIDs.begin());
+}
+
+void ReadyTaskTracker::becameReady(TaskIndex task, TaskListValues& readyTasks)
+{
+    readyTasks.push_back(tasks[task]);
+    if (tasks[task]->getStatus() == TaskModel::TaskStatus::Waiting_for_Dependency)
+    {
+        pendingStatusChanges.push_back(task);
+    }
+}
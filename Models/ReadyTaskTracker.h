@@ -0,0 +1,73 @@
+#ifndef READYTASKTRACKER_H_
+#define READYTASKTRACKER_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include <cstdint>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include <vector>
+
+/*
+ * Tracks which tasks of a list can start, a task is ready when it is not complete
+ * and every task it depends on is complete. Each task keeps a count of its unmet
+ * dependencies, completing a task decrements the counts of the tasks that depend
+ * on it, so a completion costs the number of its dependents rather than a reload
+ * of the list. Dependencies on tasks that are not in the list are treated as met,
+ * load the list with the tasks it depends on.
+ *
+ * Tasks that become ready while their status is Waiting_for_Dependency are queued
+ * to go back to Not_Started. The queued changes are written by
+ * flushStatusChanges() in one transaction, with one SELECT ... FOR UPDATE and one
+ * UPDATE per MaxTaskIDsPerUpdate tasks, callers that manage the status themselves
+ * don't call it.
+ */
+class ReadyTaskTracker : public CoreDBInterface
+{
+public:
+    ReadyTaskTracker();
+    explicit ReadyTaskTracker(const TaskListValues& tasks);
+    ~ReadyTaskTracker() = default;
+
+/*
+ * Marks the task complete, calling TaskModel::markComplete() if its status is not
+ * already Complete, saving the task is left to the caller. Returns the tasks that
+ * became ready, empty when the task is not tracked or was already complete.
+ */
+    TaskListValues completeTask(std::size_t taskID);
+    TaskListValues getReadyTasks() const;
+    bool isReady(std::size_t taskID) const;
+    std::size_t getUnmetDependencyCount(std::size_t taskID) const;
+    std::size_t getTaskCount() const noexcept { return taskIDs.size(); };
+    std::size_t getPendingStatusChangeCount() const noexcept { return pendingStatusChanges.size(); };
+
+/*
+ * Writes the queued Waiting_for_Dependency to Not_Started changes and sets the
+ * status of the models whose rows were changed. A row whose status was changed by
+ * someone else since the list was loaded is left alone, as is its model, and is
+ * reported in the error messages. flushStatusChanges() returns false if the changes
+ * could not be written, asyncFlushStatusChanges() returns the number of rows
+ * changed.
+ */
+    bool flushStatusChanges();
+    NSBA::awaitable<DBResult<std::uint64_t>> asyncFlushStatusChanges();
+
+private:
+    using TaskIndex = std::uint32_t;
+    static constexpr TaskIndex NoTask = static_cast<TaskIndex>(-1);
+    static constexpr std::size_t MaxTaskIDsPerUpdate = 500;
+
+    TaskIndex findIndex(std::size_t taskID) const;
+    void becameReady(TaskIndex task, TaskListValues& readyTasks);
+
+    TaskListValues tasks;
+    std::vector<std::size_t> taskIDs;
+    std::vector<std::uint32_t> unmetDependencies;
+    std::vector<std::uint8_t> completed;
+    std::vector<std::size_t> dependentOffsets;
+    std::vector<TaskIndex> dependents;
+    std::vector<TaskIndex> pendingStatusChanges;
+};
+
+#endif // READYTASKTRACKER_H_
@@ -0,0 +1,566 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include "TaskDependencyGraph.h"
+#include "TaskList.h"
+#include "TaskModel.h"
+#include <utility>
+#include <vector>
+
+/*
+ * An edge is stored as one 64 bit key, the from task in the high half.
+ */
+static std::uint64_t edgeKey(std::uint32_t from, std::uint32_t to) noexcept
+{
+    return (static_cast<std::uint64_t>(from) << 32) | to;
+}
+
+static std::uint32_t edgeFrom(std::uint64_t key) noexcept
+{
+    return static_cast<std::uint32_t>(key >> 32);
+}
+
+static std::uint32_t edgeTo(std::uint64_t key) noexcept
+{
+    return static_cast<std::uint32_t>(key);
+}
+
+static std::vector<std::size_t> taskIDsOf(const TaskListValues& tasks)
+{
+    std::vector<std::size_t> ids;
+    ids.reserve(tasks.size());
+    for (const TaskModel_shp& task: tasks)
+    {
+        ids.push_back(task->getTaskID());
+    }
+
+    return ids;
+}
+
+static std::vector<double> remainingHoursOf(const TaskListValues& tasks)
+{
+    std::vector<double> hours;
+    hours.reserve(tasks.size());
+    for (const TaskModel_shp& task: tasks)
+    {
+        hours.push_back(std::max(0.0, task->getEstimatedEffort() - task->getactualEffortToDate()));
+    }
+
+    return hours;
+}
+
+static std::vector<TaskDependencyGraph::Dependency> dependenciesOf(const TaskListValues& tasks)
+{
+    std::vector<TaskDependencyGraph::Dependency> dependencies;
+    for (const TaskModel_shp& task: tasks)
+    {
+        for (std::size_t dependsOn: task->getDependencies())
+        {
+            dependencies.push_back({task->getTaskID(), dependsOn});
+        }
+    }
+
+    return dependencies;
+}
+
+TaskDependencyGraph::TaskDependencyGraph(const TaskListValues& tasks)
+: TaskDependencyGraph(taskIDsOf(tasks), remainingHoursOf(tasks), dependenciesOf(tasks))
+{
+}
+
+TaskDependencyGraph::TaskDependencyGraph(std::span<const std::size_t> taskIDsIn,
+    std::span<const double> remainingHoursIn, std::span<const Dependency> dependencies)
+{
+    if (taskIDsIn.size() != remainingHoursIn.size())
+    {
+        throw std::invalid_argument("TaskDependencyGraph: there must be remaining hours for each task");
+    }
+    if (taskIDsIn.size() >= NoTask)
+    {
+        throw std::length_error("TaskDependencyGraph: too many tasks");
+    }
+
+    std::vector<std::pair<std::size_t, double>> tasks;
+    tasks.reserve(taskIDsIn.size());
+    for (std::size_t taskIdx = 0; taskIdx < taskIDsIn.size(); ++taskIdx)
+    {
+        tasks.emplace_back(taskIDsIn[taskIdx], remainingHoursIn[taskIdx]);
+    }
+    std::ranges::sort(tasks, {}, &std::pair<std::size_t, double>::first);
+    auto duplicates = std::ranges::unique(tasks, {}, &std::pair<std::size_t, double>::first);
+    tasks.erase(duplicates.begin(), duplicates.end());
+
+    taskIDs.reserve(tasks.size());
+    remainingHours.reserve(tasks.size());
+    for (const auto& [taskID, hours]: tasks)
+    {
+        taskIDs.push_back(taskID);
+        remainingHours.push_back(hours);
+    }
+
+/*
+ * TaskIDs are AUTO_INCREMENT values, when they are close together a table indexed
+ * by TaskID replaces the binary search.
+ */
+    if (!taskIDs.empty() && taskIDs.back() - taskIDs.front() < DenseTaskIDFactor * taskIDs.size())
+    {
+        firstTaskID = taskIDs.front();
+        indexByTaskID.assign(taskIDs.back() - firstTaskID + 1, NoTask);
+        for (std::size_t node = 0; node < taskIDs.size(); ++node)
+        {
+            indexByTaskID[taskIDs[node] - firstTaskID] = static_cast<NodeIndex>(node);
+        }
+    }
+
+    std::vector<std::uint64_t> edgeKeys;
+    edgeKeys.reserve(dependencies.size());
+    for (const Dependency& dependency: dependencies)
+    {
+        NodeIndex from = findIndex(dependency.dependsOn);
+        NodeIndex to = findIndex(dependency.taskID);
+        if (from != NoTask && to != NoTask)
+        {
+            edgeKeys.push_back(edgeKey(from, to));
+        }
+    }
+    buildAdjacency(std::move(edgeKeys));
+
+    std::vector<NodeIndex> order = kahnOrder();
+    cyclic = order.size() != taskIDs.size();
+    if (!cyclic)
+    {
+        taskAtPosition = std::move(order);
+        topologicalPosition.resize(taskIDs.size());
+        for (std::size_t position = 0; position < taskAtPosition.size(); ++position)
+        {
+            topologicalPosition[taskAtPosition[position]] = static_cast<NodeIndex>(position);
+        }
+    }
+    visitMarks.assign(taskIDs.size(), 0);
+}
+
+bool TaskDependencyGraph::addDependency(std::size_t taskID, std::size_t dependsOn)
+{
+    NodeIndex from = findIndex(dependsOn);
+    NodeIndex to = findIndex(taskID);
+    if (from == NoTask || to == NoTask || from == to)
+    {
+        return false;
+    }
+
+    if (hasSuccessor(from, to))
+    {
+        return true;
+    }
+
+    if (!cyclic && topologicalPosition[from] > topologicalPosition[to] && !reorderForEdge(from, to))
+    {
+        return false;
+    }
+
+    if (addedSuccessors.empty())
+    {
+        addedSuccessors.resize(taskIDs.size());
+        addedPredecessors.resize(taskIDs.size());
+    }
+    addedSuccessors[from].push_back(to);
+    addedPredecessors[to].push_back(from);
+    ++addedEdgeCount;
+
+    if (addedEdgeCount >= std::max(MinimumEdgesToMerge, successors.size() / 4))
+    {
+        mergeAddedEdges();
+    }
+
+    return true;
+}
+
+std::vector<std::size_t> TaskDependencyGraph::getTopologicalOrder() const
+{
+    std::vector<std::size_t> order;
+    if (cyclic)
+    {
+        return order;
+    }
+
+    order.reserve(taskAtPosition.size());
+    for (NodeIndex node: taskAtPosition)
+    {
+        order.push_back(taskIDs[node]);
+    }
+
+    return order;
+}
+
+/*
+ * Every task left over by Kahn's algorithm has a predecessor that is also left
+ * over, so following predecessors from any of them must come back to a task
+ * already seen. The tasks from that task on are a cycle.
+ */
+std::vector<std::size_t> TaskDependencyGraph::findCycle() const
+{
+    std::vector<std::size_t> cycle;
+    if (!cyclic)
+    {
+        return cycle;
+    }
+
+    std::vector<std::uint8_t> ordered(taskIDs.size(), 0);
+    for (NodeIndex node: kahnOrder())
+    {
+        ordered[node] = 1;
+    }
+
+    NodeIndex current = static_cast<NodeIndex>(std::ranges::find(ordered, 0) - ordered.begin());
+    std::vector<std::size_t> stepFound(taskIDs.size(), std::numeric_limits<std::size_t>::max());
+    std::vector<NodeIndex> walk;
+    while (stepFound[current] == std::numeric_limits<std::size_t>::max())
+    {
+        stepFound[current] = walk.size();
+        walk.push_back(current);
+        NodeIndex next = NoTask;
+        forEachPredecessor(current, [&](NodeIndex predecessor) {
+            if (next == NoTask && !ordered[predecessor])
+            {
+                next = predecessor;
+            }
+        });
+        current = next;
+    }
+
+/*
+ * The walk follows predecessors, reversed it is in the order the tasks must be done.
+ */
+    for (std::size_t step = walk.size(); step > stepFound[current]; --step)
+    {
+        cycle.push_back(taskIDs[walk[step - 1]]);
+    }
+
+    return cycle;
+}
+
+std::vector<TaskDependencyGraph::TaskTiming> TaskDependencyGraph::computeTimings() const
+{
+    std::vector<TaskTiming> timings;
+    if (cyclic)
+    {
+        return timings;
+    }
+
+    std::vector<double> earliestStarts;
+    std::vector<double> latestStarts;
+    computeStartTimes(earliestStarts, latestStarts);
+
+    timings.reserve(taskIDs.size());
+    for (std::size_t node = 0; node < taskIDs.size(); ++node)
+    {
+        timings.push_back({taskIDs[node], remainingHours[node], earliestStarts[node], latestStarts[node]});
+    }
+
+    return timings;
+}
+
+/*
+ * A critical task that starts at 0 starts a chain as long as the whole schedule,
+ * each next task is a critical successor that starts when the current one ends.
+ */
+std::vector<std::size_t> TaskDependencyGraph::getCriticalPath() const
+{
+    std::vector<std::size_t> criticalPath;
+    if (cyclic || taskIDs.empty())
+    {
+        return criticalPath;
+    }
+
+    std::vector<double> earliestStarts;
+    std::vector<double> latestStarts;
+    computeStartTimes(earliestStarts, latestStarts);
+    auto isCritical = [&](NodeIndex node) { return latestStarts[node] - earliestStarts[node] < CriticalSlackHours; };
+
+    NodeIndex current = NoTask;
+    for (NodeIndex node: taskAtPosition)
+    {
+        if (earliestStarts[node] < CriticalSlackHours && isCritical(node))
+        {
+            current = node;
+            break;
+        }
+    }
+
+    while (current != NoTask)
+    {
+        criticalPath.push_back(taskIDs[current]);
+        const double currentFinish = earliestStarts[current] + remainingHours[current];
+        NodeIndex next = NoTask;
+        forEachSuccessor(current, [&](NodeIndex successor) {
+            if (isCritical(successor) && earliestStarts[successor] - currentFinish < CriticalSlackHours &&
+                (next == NoTask || successor < next))
+            {
+                next = successor;
+            }
+        });
+        current = next;
+    }
+
+    return criticalPath;
+}
+
+double TaskDependencyGraph::getRemainingHours(std::size_t taskID) const
+{
+    NodeIndex node = findIndex(taskID);
+
+    return node == NoTask? 0.0 : remainingHours[node];
+}
+
+TaskDependencyGraph::NodeIndex TaskDependencyGraph::findIndex(std::size_t taskID) const
+{
+    if (!indexByTaskID.empty())
+    {
+        return taskID >= firstTaskID && taskID - firstTaskID < indexByTaskID.size()?
+            indexByTaskID[taskID - firstTaskID] : NoTask;
+    }
+
+    auto found = std::ranges::lower_bound(taskIDs, taskID);
+    if (found == taskIDs.end() || *found != taskID)
+    {
+        return NoTask;
+    }
+
+    return static_cast<NodeIndex>(found - taskIDs.begin());
+}
+
+/*
+ * A counting sort of the edges by from task gives the successor array, each row is
+ * then sorted and its duplicates removed. Walking the rows in order fills the
+ * predecessor rows in from task order.
+ */
+void TaskDependencyGraph::buildAdjacency(std::vector<std::uint64_t> edgeKeys)
+{
+    const std::size_t nodeCount = taskIDs.size();
+    successorOffsets.assign(nodeCount + 1, 0);
+    for (std::uint64_t key: edgeKeys)
+    {
+        ++successorOffsets[edgeFrom(key) + 1];
+    }
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        successorOffsets[node + 1] += successorOffsets[node];
+    }
+
+    successors.resize(edgeKeys.size());
+    std::vector<std::size_t> nextSuccessor(successorOffsets.begin(), successorOffsets.end() - 1);
+    for (std::uint64_t key: edgeKeys)
+    {
+        successors[nextSuccessor[edgeFrom(key)]++] = edgeTo(key);
+    }
+
+    std::size_t edgeCount = 0;
+    std::size_t rowStart = 0;
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        auto first = successors.begin() + static_cast<std::ptrdiff_t>(rowStart);
+        auto last = successors.begin() + static_cast<std::ptrdiff_t>(successorOffsets[node + 1]);
+        std::sort(first, last);
+        last = std::unique(first, last);
+        rowStart = successorOffsets[node + 1];
+        successorOffsets[node + 1] = static_cast<std::size_t>(std::copy(first, last,
+            successors.begin() + static_cast<std::ptrdiff_t>(edgeCount)) - successors.begin());
+        edgeCount = successorOffsets[node + 1];
+    }
+    successors.resize(edgeCount);
+
+    predecessorOffsets.assign(nodeCount + 1, 0);
+    for (NodeIndex successor: successors)
+    {
+        ++predecessorOffsets[successor + 1];
+    }
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        predecessorOffsets[node + 1] += predecessorOffsets[node];
+    }
+
+    predecessors.resize(edgeCount);
+    std::vector<std::size_t> nextPredecessor(predecessorOffsets.begin(), predecessorOffsets.end() - 1);
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        for (std::size_t edge = successorOffsets[node]; edge < successorOffsets[node + 1]; ++edge)
+        {
+            predecessors[nextPredecessor[successors[edge]]++] = static_cast<NodeIndex>(node);
+        }
+    }
+
+    addedSuccessors.clear();
+    addedPredecessors.clear();
+    addedEdgeCount = 0;
+}
+
+/*
+ * Kahn's algorithm, the tasks that are in or after a cycle are left out.
+ */
+std::vector<TaskDependencyGraph::NodeIndex> TaskDependencyGraph::kahnOrder() const
+{
+    std::vector<NodeIndex> waitingFor(taskIDs.size(), 0);
+    for (std::size_t node = 0; node < taskIDs.size(); ++node)
+    {
+        forEachSuccessor(static_cast<NodeIndex>(node), [&](NodeIndex successor) { ++waitingFor[successor]; });
+    }
+
+    std::vector<NodeIndex> order;
+    order.reserve(taskIDs.size());
+    for (std::size_t node = 0; node < taskIDs.size(); ++node)
+    {
+        if (waitingFor[node] == 0)
+        {
+            order.push_back(static_cast<NodeIndex>(node));
+        }
+    }
+
+    for (std::size_t next = 0; next < order.size(); ++next)
+    {
+        forEachSuccessor(order[next], [&](NodeIndex successor) {
+            if (--waitingFor[successor] == 0)
+            {
+                order.push_back(successor);
+            }
+        });
+    }
+
+    return order;
+}
+
+void TaskDependencyGraph::mergeAddedEdges()
+{
+    std::vector<std::uint64_t> edgeKeys;
+    edgeKeys.reserve(dependencyCount());
+    for (std::size_t node = 0; node < taskIDs.size(); ++node)
+    {
+        forEachSuccessor(static_cast<NodeIndex>(node), [&](NodeIndex successor) {
+            edgeKeys.push_back(edgeKey(static_cast<NodeIndex>(node), successor));
+        });
+    }
+
+    buildAdjacency(std::move(edgeKeys));
+}
+
+bool TaskDependencyGraph::hasSuccessor(NodeIndex from, NodeIndex to) const
+{
+    auto first = successors.begin() + static_cast<std::ptrdiff_t>(successorOffsets[from]);
+    auto last = successors.begin() + static_cast<std::ptrdiff_t>(successorOffsets[from + 1]);
+    if (std::binary_search(first, last, to))
+    {
+        return true;
+    }
+
+    return !addedSuccessors.empty() && std::ranges::find(addedSuccessors[from], to) != addedSuccessors[from].end();
+}
+
+/*
+ * Pearce-Kelly. The new edge from -> to has to is before from in the order. The
+ * tasks after to that are not after from, and the tasks before from that are not
+ * before to, are the only ones that can be out of order. The tasks that lead to
+ * from are given the lowest of their positions, followed by the tasks reached from
+ * to. Reaching from while searching forward from to means the edge makes a cycle.
+ */
+bool TaskDependencyGraph::reorderForEdge(NodeIndex from, NodeIndex to)
+{
+    const NodeIndex lowerBound = topologicalPosition[to];
+    const NodeIndex upperBound = topologicalPosition[from];
+
+    auto search = [this](NodeIndex start, std::vector<NodeIndex>& found, auto&& forEachNext, auto&& inRange) {
+        std::vector<NodeIndex> pending{start};
+        visitMarks[start] = 1;
+        while (!pending.empty())
+        {
+            NodeIndex node = pending.back();
+            pending.pop_back();
+            found.push_back(node);
+            forEachNext(node, [&](NodeIndex next) {
+                if (!visitMarks[next] && inRange(topologicalPosition[next]))
+                {
+                    visitMarks[next] = 1;
+                    pending.push_back(next);
+                }
+            });
+        }
+    };
+
+    std::vector<NodeIndex> forwardTasks;
+    search(to, forwardTasks,
+        [this](NodeIndex node, auto&& visit) { forEachSuccessor(node, visit); },
+        [upperBound](NodeIndex position) { return position <= upperBound; });
+
+    const bool makesCycle = visitMarks[from] != 0;
+    std::vector<NodeIndex> backwardTasks;
+    if (!makesCycle)
+    {
+        search(from, backwardTasks,
+            [this](NodeIndex node, auto&& visit) { forEachPredecessor(node, visit); },
+            [lowerBound](NodeIndex position) { return position >= lowerBound; });
+    }
+
+    for (NodeIndex node: forwardTasks)
+    {
+        visitMarks[node] = 0;
+    }
+    for (NodeIndex node: backwardTasks)
+    {
+        visitMarks[node] = 0;
+    }
+    if (makesCycle)
+    {
+        return false;
+    }
+
+    auto byPosition = [this](NodeIndex node) { return topologicalPosition[node]; };
+    std::ranges::sort(backwardTasks, {}, byPosition);
+    std::ranges::sort(forwardTasks, {}, byPosition);
+
+    std::vector<NodeIndex> movedTasks(backwardTasks);
+    movedTasks.insert(movedTasks.end(), forwardTasks.begin(), forwardTasks.end());
+    std::vector<NodeIndex> positions;
+    positions.reserve(movedTasks.size());
+    for (NodeIndex node: movedTasks)
+    {
+        positions.push_back(topologicalPosition[node]);
+    }
+    std::ranges::sort(positions);
+
+    for (std::size_t moved = 0; moved < movedTasks.size(); ++moved)
+    {
+        topologicalPosition[movedTasks[moved]] = positions[moved];
+        taskAtPosition[positions[moved]] = movedTasks[moved];
+    }
+
+    return true;
+}
+
+/*
+ * The forward pass finds the earliest start of each task from the tasks before it
+ * in the order, the backward pass the latest start that doesn't delay the end.
+ */
+void TaskDependencyGraph::computeStartTimes(std::vector<double>& earliestStarts,
+    std::vector<double>& latestStarts) const
+{
+    earliestStarts.assign(taskIDs.size(), 0.0);
+    double scheduleEnd = 0.0;
+    for (NodeIndex node: taskAtPosition)
+    {
+        const double finish = earliestStarts[node] + remainingHours[node];
+        scheduleEnd = std::max(scheduleEnd, finish);
+        forEachSuccessor(node, [&](NodeIndex successor) {
+            earliestStarts[successor] = std::max(earliestStarts[successor], finish);
+        });
+    }
+
+    latestStarts.assign(taskIDs.size(), 0.0);
+    for (auto position = taskAtPosition.rbegin(); position != taskAtPosition.rend(); ++position)
+    {
+        double latestFinish = scheduleEnd;
+        forEachSuccessor(*position, [&](NodeIndex successor) {
+            latestFinish = std::min(latestFinish, latestStarts[successor]);
+        });
+        latestStarts[*position] = latestFinish - remainingHours[*position];
+    }
+}
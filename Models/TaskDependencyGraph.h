@@ -0,0 +1,150 @@
+#ifndef TASKDEPENDENCYGRAPH_H_
+#define TASKDEPENDENCYGRAPH_H_
+
+#include <cstdint>
+#include <span>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include <vector>
+
+/*
+ * The dependencies of a set of tasks as a directed graph, an edge runs from a task
+ * to each task that depends on it. The edges are stored in compressed sparse row
+ * form, the successors of every task in one array with an offset per task, and
+ * the same again for the predecessors. Dependencies on tasks outside the set are
+ * ignored.
+ *
+ * The graph keeps a topological order. Dependencies added after the graph is built
+ * are checked and ordered with the Pearce-Kelly algorithm, which only reorders the
+ * tasks between the two ends of the new edge, and are kept in per task lists until
+ * there are enough of them to be worth merging into the compressed arrays.
+ *
+ * The schedule is in hours from the start of the work, the duration of each task
+ * is the estimated effort less the effort to date.
+ */
+class TaskDependencyGraph
+{
+public:
+    struct Dependency
+    {
+        std::size_t taskID;
+        std::size_t dependsOn;
+    };
+
+    struct TaskTiming
+    {
+        std::size_t taskID;
+        double remainingHours;
+        double earliestStart;
+        double latestStart;
+
+        double slack() const noexcept { return latestStart - earliestStart; };
+        bool isCritical() const noexcept { return slack() < CriticalSlackHours; };
+    };
+
+    TaskDependencyGraph() = default;
+    explicit TaskDependencyGraph(const TaskListValues& tasks);
+    TaskDependencyGraph(std::span<const std::size_t> taskIDsIn, std::span<const double> remainingHoursIn,
+        std::span<const Dependency> dependencies);
+    ~TaskDependencyGraph() = default;
+
+    std::size_t taskCount() const noexcept { return taskIDs.size(); };
+    std::size_t dependencyCount() const noexcept { return successors.size() + addedEdgeCount; };
+    bool contains(std::size_t taskID) const { return findIndex(taskID) != NoTask; };
+    bool hasCycle() const noexcept { return cyclic; };
+
+/*
+ * Returns false without adding the dependency when either task is not in the
+ * graph or when the dependency would make a cycle. A dependency that is already
+ * in the graph is not added again. When the graph was built with a cycle the
+ * dependency is added without checking.
+ */
+    bool addDependency(std::size_t taskID, std::size_t dependsOn);
+
+/*
+ * The TaskIDs with every task after the tasks it depends on, empty when the graph
+ * has a cycle.
+ */
+    std::vector<std::size_t> getTopologicalOrder() const;
+/*
+ * The TaskIDs of one cycle, each task must be done before the task after it and
+ * the last before the first. Empty when the graph has no cycle.
+ */
+    std::vector<std::size_t> findCycle() const;
+/*
+ * The timings in TaskID order, empty when the graph has a cycle.
+ */
+    std::vector<TaskTiming> computeTimings() const;
+/*
+ * The TaskIDs of the longest chain of dependent tasks by remaining hours, in the
+ * order they must be done.
+ */
+    std::vector<std::size_t> getCriticalPath() const;
+    double getRemainingHours(std::size_t taskID) const;
+
+    static constexpr double CriticalSlackHours = 1.0e-6;
+
+private:
+    using NodeIndex = std::uint32_t;
+    static constexpr NodeIndex NoTask = static_cast<NodeIndex>(-1);
+    static constexpr std::size_t MinimumEdgesToMerge = 1024;
+    static constexpr std::size_t DenseTaskIDFactor = 4;
+
+    NodeIndex findIndex(std::size_t taskID) const;
+    void buildAdjacency(std::vector<std::uint64_t> edgeKeys);
+    std::vector<NodeIndex> kahnOrder() const;
+    void mergeAddedEdges();
+    bool hasSuccessor(NodeIndex from, NodeIndex to) const;
+    bool reorderForEdge(NodeIndex from, NodeIndex to);
+    void computeStartTimes(std::vector<double>& earliestStarts, std::vector<double>& latestStarts) const;
+
+    template<typename Visitor>
+    void forEachSuccessor(NodeIndex node, Visitor&& visit) const
+    {
+        for (std::size_t edge = successorOffsets[node]; edge < successorOffsets[node + 1]; ++edge)
+        {
+            visit(successors[edge]);
+        }
+        if (!addedSuccessors.empty())
+        {
+            for (NodeIndex successor: addedSuccessors[node])
+            {
+                visit(successor);
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void forEachPredecessor(NodeIndex node, Visitor&& visit) const
+    {
+        for (std::size_t edge = predecessorOffsets[node]; edge < predecessorOffsets[node + 1]; ++edge)
+        {
+            visit(predecessors[edge]);
+        }
+        if (!addedPredecessors.empty())
+        {
+            for (NodeIndex predecessor: addedPredecessors[node])
+            {
+                visit(predecessor);
+            }
+        }
+    }
+
+    std::vector<std::size_t> taskIDs;
+    std::vector<double> remainingHours;
+    std::vector<NodeIndex> indexByTaskID;
+    std::size_t firstTaskID = 0;
+    std::vector<std::size_t> successorOffsets;
+    std::vector<NodeIndex> successors;
+    std::vector<std::size_t> predecessorOffsets;
+    std::vector<NodeIndex> predecessors;
+    std::vector<std::vector<NodeIndex>> addedSuccessors;
+    std::vector<std::vector<NodeIndex>> addedPredecessors;
+    std::size_t addedEdgeCount = 0;
+    std::vector<NodeIndex> topologicalPosition;
+    std::vector<NodeIndex> taskAtPosition;
+    std::vector<std::uint8_t> visitMarks;
+    bool cyclic = false;
+};
+
+#endif // TASKDEPENDENCYGRAPH_H_
@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <cstdint>
+#include "DBExecutionContext.h"
+#include <exception>
+#include <format>
+#include <iterator>
+#include "ModelRowCache.h"
+#include <optional>
+#include <span>
+#include <string>
+#include "TaskGateway.h"
+#include "TaskModel.h"
+#include "TaskRecord.h"
+#include <utility>
+#include <vector>
+
+TaskGateway::TaskGateway()
+: pool{DBConnectionPool::getPool(DBConnectionPool::connectionParametersFromProgramOptions())}
+{
+}
+
+TaskGateway::DBResult<TaskRecord> TaskGateway::selectByTaskID(std::size_t taskID) const
+{
+    return DBExecutionContext::instance().runAndWait(asyncSelectByTaskID(taskID));
+}
+
+TaskGateway::DBResult<TaskRecords> TaskGateway::selectByTaskIDs(std::span<const std::size_t> taskIDs) const
+{
+    return DBExecutionContext::instance().runAndWait(
+        asyncSelectByTaskIDs(std::vector<std::size_t>(taskIDs.begin(), taskIDs.end())));
+}
+
+TaskGateway::DBResult<TaskRecords> TaskGateway::selectByAssignedUser(std::size_t assignedUserID) const
+{
+    return DBExecutionContext::instance().runAndWait(asyncSelectByAssignedUser(assignedUserID));
+}
+
+TaskGateway::DBResult<void> TaskGateway::insert(TaskRecord& task) const
+{
+    DBResult<std::uint32_t> taskID = DBExecutionContext::instance().runAndWait(asyncInsert(task));
+    if (!taskID.has_value())
+    {
+        return std::unexpected(taskID.error());
+    }
+
+    task.taskID = taskID.value();
+    return {};
+}
+
+TaskGateway::DBResult<void> TaskGateway::update(const TaskRecord& task) const
+{
+    return DBExecutionContext::instance().runAndWait(asyncUpdate(task));
+}
+
+NSBA::awaitable<TaskGateway::DBResult<TaskRecord>> TaskGateway::asyncSelectByTaskID(std::size_t taskID) const
+{
+    ModelRowCache& rowCache = TaskModel::taskRowCache();
+    std::optional<TaskRecord> task;
+    std::string failure;
+
+    try
+    {
+        if (std::optional<NSBM::row> cachedRow = rowCache.find(taskID); cachedRow.has_value())
+        {
+            task = TaskModel::recordFromRow(cachedRow.value());
+        }
+        else
+        {
+            std::uint64_t cacheGeneration = rowCache.getGeneration();
+            CoreDBInterface::PreparedQuery selectQuery = TaskModel::buildPreparedSelectByTaskID(taskID);
+            NSBM::results localResult = co_await pool.asyncExecutePrepared(selectQuery.statementKey,
+                selectQuery.sqlText, selectQuery.parameters);
+            if (!localResult.rows().empty())
+            {
+                task = TaskModel::recordFromRow(localResult.rows()[0]);
+                rowCache.store(taskID, localResult.rows()[0], cacheGeneration);
+            }
+        }
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In TaskGateway::selectByTaskID({}) : {}", taskID, e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    if (!task.has_value())
+    {
+        co_return std::unexpected(std::format("Task {} not found!", taskID));
+    }
+
+    co_return std::move(task.value());
+}
+
+/*
+ * One query per TaskModel::MaxTaskIDsPerSelect IDs, the records are in TaskID order.
+ */
+NSBA::awaitable<TaskGateway::DBResult<TaskRecords>> TaskGateway::asyncSelectByTaskIDs(
+    std::vector<std::size_t> taskIDs) const
+{
+    TaskRecords tasks;
+    tasks.reserve(taskIDs.size());
+    std::string failure;
+
+    try
+    {
+        NSBM::format_options formatOptions = co_await pool.asyncGetFormatOptions();
+        std::span<const std::size_t> allTaskIDs(taskIDs);
+
+        for (std::size_t chunkStart = 0; chunkStart < allTaskIDs.size(); chunkStart += TaskModel::MaxTaskIDsPerSelect)
+        {
+            std::span<const std::size_t> chunk = allTaskIDs.subspan(chunkStart,
+                std::min(TaskModel::MaxTaskIDsPerSelect, allTaskIDs.size() - chunkStart));
+
+            TaskRecords chunkTasks = co_await coRoutineSelectRecords(TaskModel::formatSelectByTaskIDs(formatOptions,
+                chunk));
+            std::move(chunkTasks.begin(), chunkTasks.end(), std::back_inserter(tasks));
+        }
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In TaskGateway::selectByTaskIDs : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    std::sort(tasks.begin(), tasks.end(),
+        [](const TaskRecord& first, const TaskRecord& second) { return first.taskID < second.taskID; });
+
+    co_return tasks;
+}
+
+NSBA::awaitable<TaskGateway::DBResult<TaskRecords>> TaskGateway::asyncSelectByAssignedUser(
+    std::size_t assignedUserID) const
+{
+    TaskRecords tasks;
+    std::string failure;
+
+    try
+    {
+        NSBM::format_options formatOptions = co_await pool.asyncGetFormatOptions();
+
+        tasks = co_await coRoutineSelectRecords(TaskModel::formatSelectByAssignedUser(formatOptions, assignedUserID));
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In TaskGateway::selectByAssignedUser({}) : {}", assignedUserID, e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    co_return tasks;
+}
+
+NSBA::awaitable<TaskGateway::DBResult<std::uint32_t>> TaskGateway::asyncInsert(TaskRecord task) const
+{
+    if (task.taskID != 0)
+    {
+        co_return std::unexpected(std::format("Task {} already in Database, use Update!", task.taskID));
+    }
+
+    if (!task.hasRequiredValues())
+    {
+        co_return std::unexpected(std::format("Task \"{}\" is missing required values!", task.description));
+    }
+
+    std::uint32_t taskID = 0;
+    std::string failure;
+
+    try
+    {
+        CoreDBInterface::PreparedQuery insertQuery = TaskModel::buildRecordInsert(std::move(task));
+        NSBM::results localResult = co_await pool.asyncExecutePrepared(insertQuery.statementKey,
+            insertQuery.sqlText, insertQuery.parameters);
+        taskID = static_cast<std::uint32_t>(localResult.last_insert_id());
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In TaskGateway::insert : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    co_return taskID;
+}
+
+/*
+ * Writes every column, the record does not track which columns changed.
+ */
+NSBA::awaitable<TaskGateway::DBResult<void>> TaskGateway::asyncUpdate(TaskRecord task) const
+{
+    if (task.taskID == 0)
+    {
+        co_return std::unexpected(std::string("Task not in Database, use Insert!"));
+    }
+
+    std::uint32_t taskID = task.taskID;
+    std::string failure;
+
+    try
+    {
+        CoreDBInterface::PreparedQuery updateQuery = TaskModel::buildRecordUpdate(std::move(task));
+        co_await pool.asyncExecutePrepared(updateQuery.statementKey, updateQuery.sqlText, updateQuery.parameters);
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In TaskGateway::update({}) : {}", taskID, e.what());
+    }
+
+    TaskModel::taskRowCache().invalidate(taskID);
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    co_return DBResult<void>{};
+}
+
+/*
+ * The rows are added to the Tasks row cache when it is enabled.
+ */
+NSBA::awaitable<TaskRecords> TaskGateway::coRoutineSelectRecords(std::string query) const
+{
+    ModelRowCache& rowCache = TaskModel::taskRowCache();
+    bool cacheRows = rowCache.isEnabled();
+    std::uint64_t cacheGeneration = rowCache.getGeneration();
+
+    NSBM::results localResult = co_await pool.asyncExecute(query);
+
+    TaskRecords tasks;
+    tasks.reserve(localResult.rows().size());
+    for (auto row: localResult.rows())
+    {
+        tasks.push_back(TaskModel::recordFromRow(row));
+        if (cacheRows)
+        {
+            rowCache.store(tasks.back().taskID, row, cacheGeneration);
+        }
+    }
+
+    co_return tasks;
+}
@@ -0,0 +1,51 @@
+#ifndef TASKGATEWAY_H_
+#define TASKGATEWAY_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include "DBConnectionPool.h"
+#include <span>
+#include <string>
+#include "TaskRecord.h"
+#include <vector>
+
+using TaskRecords = std::vector<TaskRecord>;
+
+/*
+ * Loads and saves TaskRecords. The gateway is stateless, it holds only the
+ * connection pool, so one gateway can serve any number of records, lists and
+ * threads. The SQL, the prepared statements and the row codec are TaskModel's,
+ * and the rows share the Tasks row cache with TaskModel.
+ *
+ * The blocking interfaces wait for the coroutine versions on the shared
+ * DBExecutionContext, errors are returned in the DBResult.
+ */
+class TaskGateway
+{
+public:
+    template<typename ValueType>
+    using DBResult = CoreDBInterface::DBResult<ValueType>;
+
+    TaskGateway();
+    ~TaskGateway() = default;
+
+    DBResult<TaskRecord> selectByTaskID(std::size_t taskID) const;
+    DBResult<TaskRecords> selectByTaskIDs(std::span<const std::size_t> taskIDs) const;
+    DBResult<TaskRecords> selectByAssignedUser(std::size_t assignedUserID) const;
+    DBResult<void> insert(TaskRecord& task) const;
+    DBResult<void> update(const TaskRecord& task) const;
+
+    NSBA::awaitable<DBResult<TaskRecord>> asyncSelectByTaskID(std::size_t taskID) const;
+    NSBA::awaitable<DBResult<TaskRecords>> asyncSelectByTaskIDs(std::vector<std::size_t> taskIDs) const;
+    NSBA::awaitable<DBResult<TaskRecords>> asyncSelectByAssignedUser(std::size_t assignedUserID) const;
+    NSBA::awaitable<DBResult<std::uint32_t>> asyncInsert(TaskRecord task) const;
+    NSBA::awaitable<DBResult<void>> asyncUpdate(TaskRecord task) const;
+
+private:
+    NSBA::awaitable<TaskRecords> coRoutineSelectRecords(std::string query) const;
+
+    DBConnectionPool& pool;
+};
+
+#endif // TASKGATEWAY_H_
@@ -1,9 +1,12 @@
 #include <chrono>
 #include <format>
 #include <iostream>
+#include "ListCursor.h"
 #include "ListDBInterface.h"
+#include "ListPage.h"
 #include "TaskList.h"
 #include "TaskModel.h"
+#include "TaskTree.h"
 
 TaskList::TaskList()
 : ListDBInterface<TaskModel>()
@@ -11,115 +14,160 @@ TaskList::TaskList()
 
 }
 
-TaskListValues TaskList::getActiveTasksForAssignedUser(std::size_t assignedUserID)
+TaskListValues TaskList::getActiveTasksForAssignedUser(std::size_t assignedUserID, const ListPage& page)
 {
-    prepareForRunQueryAsync();
+    return waitForTaskList(asyncGetActiveTasksForAssignedUser(assignedUserID, page));
+}
+
+TaskListValues TaskList::getUnstartedDueForStartForAssignedUser(std::size_t assignedUserID, const ListPage& page)
+{
+    return waitForTaskList(asyncGetUnstartedDueForStartForAssignedUser(assignedUserID, page));
+}
+
+TaskListValues TaskList::getTasksCompletedByAssignedAfterDate(std::size_t assignedUserID,
+    std::chrono::year_month_day& searchStartDate, const ListPage& page)
+{
+    return waitForTaskList(asyncGetTasksCompletedByAssignedAfterDate(assignedUserID, searchStartDate, page));
+}
+
+TaskListValues TaskList::getTasksByAssignedIDandParentID(std::size_t assignedUserID, std::size_t parentID,
+    const ListPage& page)
+{
+    return waitForTaskList(asyncGetTasksByAssignedIDandParentID(assignedUserID, parentID, page));
+}
+
+NSBA::awaitable<TaskList::TaskListResult> TaskList::asyncGetActiveTasksForAssignedUser(std::size_t assignedUserID,
+    ListPage page)
+{
+    errorMessages.clear();
 /*
  * Prepend function name to any error messages.
  */
     appendErrorMessage("In TaskList::getActiveTasksForAssignedUser : ");
 
-    try
-    {
-        firstFormattedQuery = queryGenerator.formatSelectActiveTasksForAssignedUser(assignedUserID);
-        return runQueryFillTaskList();
-    }
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatSelectActiveTasksForAssignedUser(formatOptions, assignedUserID, page); });
 
-    catch(const std::exception& e)
-    {
-        appendErrorMessage(e.what());
-    }
-    
-    return TaskListValues();
+    co_return co_await coRoutineRunQueryFillTaskList();
 }
 
-TaskListValues TaskList::getUnstartedDueForStartForAssignedUser(std::size_t assignedUserID)
+NSBA::awaitable<TaskList::TaskListResult> TaskList::asyncGetUnstartedDueForStartForAssignedUser(
+    std::size_t assignedUserID, ListPage page)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
     appendErrorMessage("In TaskList::getUnstartedDueForStartForAssignedUser : ");
 
-    try
-    {
-        firstFormattedQuery = queryGenerator.formatSelectUnstartedDueForStartForAssignedUser(assignedUserID);
-        return runQueryFillTaskList();
-    }
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatSelectUnstartedDueForStartForAssignedUser(formatOptions, assignedUserID,
+            page); });
 
-    catch(const std::exception& e)
-    {
-        appendErrorMessage(e.what());
-    }
-    
-    return TaskListValues();
+    co_return co_await coRoutineRunQueryFillTaskList();
 }
 
-TaskListValues TaskList::getTasksCompletedByAssignedAfterDate(std::size_t assignedUserID,
-    std::chrono::year_month_day& searchStartDate)
+NSBA::awaitable<TaskList::TaskListResult> TaskList::asyncGetTasksCompletedByAssignedAfterDate(
+    std::size_t assignedUserID, std::chrono::year_month_day searchStartDate, ListPage page)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
     appendErrorMessage("In TaskList::getTasksCompletedByAssignedAfterDate : ");
 
-    try
-    {
-        firstFormattedQuery = queryGenerator.formatSelectTasksCompletedByAssignedAfterDate(
-            assignedUserID, searchStartDate);
-        return runQueryFillTaskList();
-    }
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatSelectTasksCompletedByAssignedAfterDate(formatOptions, assignedUserID,
+            searchStartDate, page); });
 
-    catch(const std::exception& e)
-    {
-        appendErrorMessage(e.what());
-    }
-    
-    return TaskListValues();
+    co_return co_await coRoutineRunQueryFillTaskList();
 }
 
-TaskListValues TaskList::getTasksByAssignedIDandParentID(std::size_t assignedUserID, std::size_t parentID)
+NSBA::awaitable<TaskList::TaskListResult> TaskList::asyncGetTasksByAssignedIDandParentID(
+    std::size_t assignedUserID, std::size_t parentID, ListPage page)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
     appendErrorMessage("In TaskList::getTasksByAssignedIDandParentID : ");
 
-    try
-    {
-        firstFormattedQuery = queryGenerator.formatSelectTasksByAssignedIDandParentID(
-            assignedUserID, parentID);
-        return runQueryFillTaskList();
-    }
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatSelectTasksByAssignedIDandParentID(formatOptions, assignedUserID, parentID,
+            page); });
+
+    co_return co_await coRoutineRunQueryFillTaskList();
+}
+
+TaskListValues TaskList::getTasksThatDependOn(std::size_t taskID, const ListPage& page)
+{
+    return waitForTaskList(asyncGetTasksThatDependOn(taskID, page));
+}
+
+NSBA::awaitable<TaskList::TaskListResult> TaskList::asyncGetTasksThatDependOn(std::size_t taskID, ListPage page)
+{
+    errorMessages.clear();
+    appendErrorMessage("In TaskList::getTasksThatDependOn : ");
+
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatSelectTasksThatDependOn(formatOptions, taskID, page); });
+
+    co_return co_await coRoutineRunQueryFillTaskList();
+}
 
-    catch(const std::exception& e)
+TaskTree TaskList::getTaskTree(std::size_t rootTaskID, std::size_t maxDepth)
+{
+    DBResult<TaskTree> taskTree = waitForCoRoutine(asyncGetTaskTree(rootTaskID, maxDepth));
+
+    return taskTree.has_value()? std::move(taskTree.value()) : TaskTree();
+}
+
+NSBA::awaitable<TaskList::DBResult<TaskTree>> TaskList::asyncGetTaskTree(std::size_t rootTaskID, std::size_t maxDepth)
+{
+    errorMessages.clear();
+    appendErrorMessage("In TaskList::getTaskTree : ");
+
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatSelectTaskTree(formatOptions, rootTaskID, maxDepth); });
+
+    TaskListResult subtreeTasks = co_await coRoutineRunQueryFillTaskList();
+    if (!subtreeTasks.has_value())
     {
-        appendErrorMessage(e.what());
+        co_return std::unexpected(subtreeTasks.error());
     }
-    
-    return TaskListValues();
+
+    co_return TaskTree(rootTaskID, std::move(subtreeTasks.value()), maxDepth);
 }
 
-TaskListValues TaskList::fillTaskList()
+ListCursor<TaskModel> TaskList::getTasksCompletedByAssignedAfterDateCursor(std::size_t assignedUserID,
+    std::chrono::year_month_day searchStartDate)
 {
-    TaskListValues taskList;
+    return ListCursor<TaskModel>(queryGenerator.formatSelectTasksCompletedByAssignedAfterDate(getFormatOptions(),
+        assignedUserID, searchStartDate));
+}
 
-    for (auto taskID: primaryKeyResults)
+ListPage TaskList::nextPage(const ListPage& page, const TaskListValues& pageTasks)
+{
+    ListPage next = page;
+    if (!pageTasks.empty())
     {
-        TaskModel_shp newTask = std::make_shared<TaskModel>(TaskModel());
-        newTask->selectByTaskID(taskID);
-        taskList.push_back(newTask);
+        next.afterKey = pageTasks.back()->getTaskID();
+        next.afterDate = pageTasks.back()->getDueDate();
     }
 
-    return taskList;
+    return next;
 }
 
-TaskListValues TaskList::runQueryFillTaskList()
+TaskListValues TaskList::waitForTaskList(NSBA::awaitable<TaskListResult> listQuery)
+{
+    TaskListResult taskList = waitForCoRoutine(std::move(listQuery));
+
+    return taskList.has_value()? std::move(taskList.value()) : TaskListValues();
+}
+
+NSBA::awaitable<TaskList::TaskListResult> TaskList::coRoutineRunQueryFillTaskList()
 {
     if (firstFormattedQuery.empty())
     {
-        appendErrorMessage(std::format("Formatting select multiple tasks query string failed {}",
+        co_return operationFailed(std::format("Formatting select multiple tasks query string failed {}",
             queryGenerator.getAllErrorMessages()));
-        return TaskListValues();
     }
-    if (runFirstQuery())
+
+    if (co_await coRoutineRunFirstQuery())
     {
-        return fillTaskList();
+        co_return std::move(listResults);
     }
 
-    return TaskListValues();
+    co_return TaskListValues();
 }
-
@@ -4,26 +4,67 @@
 #include <chrono>
 #include <format>
 #include <iostream>
+#include "ListCursor.h"
 #include "ListDBInterface.h"
+#include "ListPage.h"
 #include "TaskModel.h"
+#include "TaskTree.h"
 
 using TaskListValues = std::vector<TaskModel_shp>;
 
 class TaskList : public ListDBInterface<TaskModel>
 {
 public:
+    using TaskListResult = DBResult<TaskListValues>;
+
     TaskList();
     virtual ~TaskList() = default;
 
-    TaskListValues getActiveTasksForAssignedUser(std::size_t assignedUserID);
-    TaskListValues getUnstartedDueForStartForAssignedUser(std::size_t assignedUserID);
+    TaskListValues getActiveTasksForAssignedUser(std::size_t assignedUserID, const ListPage& page = {});
+    TaskListValues getUnstartedDueForStartForAssignedUser(std::size_t assignedUserID, const ListPage& page = {});
     TaskListValues getTasksCompletedByAssignedAfterDate(std::size_t assignedUserID,
-        std::chrono::year_month_day& searchStartDate);
-    TaskListValues getTasksByAssignedIDandParentID(std::size_t assignedUserID, std::size_t parentID);
+        std::chrono::year_month_day& searchStartDate, const ListPage& page = {});
+    TaskListValues getTasksByAssignedIDandParentID(std::size_t assignedUserID, std::size_t parentID,
+        const ListPage& page = {});
+    TaskListValues getTasksThatDependOn(std::size_t taskID, const ListPage& page = {});
+
+/*
+ * Coroutine versions of the list queries, the blocking versions above wait for these.
+ */
+    NSBA::awaitable<TaskListResult> asyncGetActiveTasksForAssignedUser(std::size_t assignedUserID,
+        ListPage page = {});
+    NSBA::awaitable<TaskListResult> asyncGetUnstartedDueForStartForAssignedUser(std::size_t assignedUserID,
+        ListPage page = {});
+    NSBA::awaitable<TaskListResult> asyncGetTasksCompletedByAssignedAfterDate(std::size_t assignedUserID,
+        std::chrono::year_month_day searchStartDate, ListPage page = {});
+    NSBA::awaitable<TaskListResult> asyncGetTasksByAssignedIDandParentID(std::size_t assignedUserID,
+        std::size_t parentID, ListPage page = {});
+    NSBA::awaitable<TaskListResult> asyncGetTasksThatDependOn(std::size_t taskID, ListPage page = {});
+
+/*
+ * The task and all of its descendants to maxDepth levels below it, loaded with one
+ * recursive query. The tree is empty when the root task doesn't exist or the query
+ * failed.
+ */
+    TaskTree getTaskTree(std::size_t rootTaskID, std::size_t maxDepth = TaskTree::DefaultMaxDepth);
+    NSBA::awaitable<DBResult<TaskTree>> asyncGetTaskTree(std::size_t rootTaskID,
+        std::size_t maxDepth = TaskTree::DefaultMaxDepth);
+
+/*
+ * The page after the tasks of a page. The active and unstarted tasks are in
+ * (RequiredDelivery, TaskID) order, the other lists are in TaskID order.
+ */
+    static ListPage nextPage(const ListPage& page, const TaskListValues& pageTasks);
+
+/*
+ * Streams the tasks for reports that can cover a large number of tasks.
+ */
+    ListCursor<TaskModel> getTasksCompletedByAssignedAfterDateCursor(std::size_t assignedUserID,
+        std::chrono::year_month_day searchStartDate);
 
 private:
-    TaskListValues fillTaskList();
-    TaskListValues runQueryFillTaskList();
+    TaskListValues waitForTaskList(NSBA::awaitable<TaskListResult> listQuery);
+    NSBA::awaitable<TaskListResult> coRoutineRunQueryFillTaskList();
 
 };
 
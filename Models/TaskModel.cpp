@@ -1,11 +1,22 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include "commonUtilities.h"
+#include <cstdint>
 #include <functional>
 #include "GenericDictionary.h"
 #include <iostream>
 #include <memory>
+#include <optional>
+#include "QueryTemplate.h"
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include "TaskModel.h"
+#include "TaskTree.h"
+#include <unordered_map>
+#include <utility>
 //#include "UserModel.h"
 #include <vector>
 
@@ -21,6 +32,45 @@ static std::vector<GenericDictionary<TaskModel::TaskStatus, std::string>::DictTy
 
 static GenericDictionary<TaskModel::TaskStatus, std::string> taskStatusConversionTable(statusConversionsDefs);
 
+/*
+ * Prepared statement text, the parameter order is the order of recordColumnParameters().
+ */
+static constexpr std::string_view insertTaskPrefixSQL =
+    schemaStatement<TaskModel::schema, SchemaStatement::InsertPrefix>;
+static constexpr std::string_view insertTaskSQL = schemaStatement<TaskModel::schema, SchemaStatement::Insert>;
+static constexpr std::string_view updateAllTaskSQL = schemaStatement<TaskModel::schema, SchemaStatement::UpdateAll>;
+
+/*
+ * The text protocol queries, see QueryTemplate.
+ */
+static constexpr std::string_view selectTasksSQL = schemaStatement<TaskModel::schema, SchemaStatement::Select>;
+static const QueryTemplate selectByDescriptionAndAssignedUserQuery(selectTasksSQL,
+    " WHERE Description = {} AND AsignedTo = {}");
+static const QueryTemplate selectActiveTasksForAssignedUserQuery(selectTasksSQL,
+    " WHERE AsignedTo = {} AND Completed IS NULL AND (Status IS NOT NULL AND Status <> {})");
+static const QueryTemplate selectUnstartedDueForStartForAssignedUserQuery(selectTasksSQL,
+    " WHERE AsignedTo = {} AND ScheduledStart < {} AND (Status IS NULL OR Status = {})");
+static const QueryTemplate selectTasksCompletedByAssignedAfterDateQuery(selectTasksSQL,
+    " WHERE AsignedTo = {} AND Completed >= {}");
+static const QueryTemplate selectTasksByAssignedIDandParentIDQuery(selectTasksSQL,
+    " WHERE AsignedTo = {} AND ParentTask = {}");
+static const QueryTemplate selectByAssignedUserQuery(selectTasksSQL, " WHERE AsignedTo = {} ORDER BY TaskID");
+static const QueryTemplate selectTasksThatDependOnQuery(selectTasksSQL,
+    " WHERE TaskID IN (SELECT TaskID FROM TaskDependencies WHERE DependsOn = {})");
+/*
+ * TreePath is the list of TaskIDs from the root, a task already on the path is not
+ * followed again so a ParentTask cycle ends, TreeDepth stops the recursion at the
+ * depth limit. The path has room for TaskTree::MaxDepthLimit + 1 levels of 10 digit IDs.
+ */
+static const QueryTemplate selectTaskTreeQuery(selectTasksSQL,
+    " WHERE TaskID IN (WITH RECURSIVE TaskTree (TaskID, TreeDepth, TreePath) AS ("
+    "SELECT TaskID, 0, CAST(CONCAT(',', TaskID, ',') AS CHAR(4096)) FROM Tasks WHERE TaskID = {}"
+    " UNION ALL"
+    " SELECT child.TaskID, TaskTree.TreeDepth + 1, CONCAT(TaskTree.TreePath, child.TaskID, ',')"
+    " FROM Tasks AS child JOIN TaskTree ON child.ParentTask = TaskTree.TaskID"
+    " WHERE TaskTree.TreeDepth < {} AND LOCATE(CONCAT(',', child.TaskID, ','), TaskTree.TreePath) = 0)"
+    " SELECT TaskID FROM TaskTree)");
+
 TaskModel::TaskModel()
 : ModelDBInterface("Task")
 {
@@ -74,92 +124,77 @@ std::chrono::year_month_day TaskModel::getCompletionDate() const
 
 void TaskModel::setCreatorID(std::size_t inCreatorID)
 {
-    modified = true;
-    creatorID = inCreatorID;
+    setColumnValue(creatorID, inCreatorID, createdByIdx);
 }
 
 void TaskModel::setAssignToID(std::size_t inAssignedID)
 {
-    modified = true;
-    assignToID = inAssignedID;
+    setColumnValue(assignToID, inAssignedID, assignedToIdx);
 }
 
 void TaskModel::setDescription(std::string inDescription)
 {
-    modified = true;
-    description = inDescription;
+    setColumnValue(description, inDescription, descriptionIdx);
 }
 
 void TaskModel::setStatus(TaskModel::TaskStatus inStatus)
 {
-    modified = true;
-    status = inStatus;
+    setColumnValue(status, inStatus, statusIdx);
 }
 
 void TaskModel::setParentTaskID(std::size_t inParentTaskID)
 {
-    modified = true;
-    parentTaskID = inParentTaskID;
+    setColumnValue(parentTaskID, inParentTaskID, parentTaskIdx);
 }
 
 void TaskModel::setPercentageComplete(double inPercentComplete)
 {
-    modified = true;
-    percentageComplete = inPercentComplete;
+    setColumnValue(percentageComplete, inPercentComplete, percentageCompleteIdx);
 }
 
 void TaskModel::setCreationDate(std::chrono::year_month_day inCreationDate)
 {
-    modified = true;
-    creationDate = inCreationDate;
+    setColumnValue(creationDate, inCreationDate, createdOnIdx);
 }
 
 void TaskModel::setDueDate(std::chrono::year_month_day inDueDate)
 {
-    modified = true;
-    dueDate = inDueDate;
+    setColumnValue(dueDate, inDueDate, requiredDeliveryIdx);
 }
 
 void TaskModel::setScheduledStart(std::chrono::year_month_day startDate)
 {
-    modified = true;
-    scheduledStart = startDate;
+    setColumnValue(scheduledStart, startDate, scheduledStartIdx);
 }
 
 void TaskModel::setactualStartDate(std::chrono::year_month_day startDate)
 {
-    modified = true;
-    actualStartDate = startDate;
+    setColumnValue(actualStartDate, startDate, actualStartIdx);
 }
 
 void TaskModel::setEstimatedCompletion(std::chrono::year_month_day completionDate)
 {
-    modified = true;
-    estimatedCompletion = completionDate;
+    setColumnValue(estimatedCompletion, completionDate, estimatedCompletionIdx);
 }
 
 void TaskModel::setCompletionDate(std::chrono::year_month_day inCompletionDate)
 {
-    modified = true;
-    completionDate = inCompletionDate;
+    setColumnValue(completionDate, inCompletionDate, completedIdx);
 }
 
 void TaskModel::setEstimatedEffort(unsigned int inEstimatedHours)
 {
-    modified = true;
-    estimatedEffort = inEstimatedHours;
+    setColumnValue(estimatedEffort, inEstimatedHours, estimatedEffortHoursIdx);
 }
 
 void TaskModel::setActualEffortToDate(double effortHoursYTD)
 {
-    modified = true;
-    actualEffortToDate = effortHoursYTD;
+    setColumnValue(actualEffortToDate, effortHoursYTD, actualEffortHoursIdx);
 }
 
 void TaskModel::setPriorityGroup(unsigned int inPriorityGroup)
 {
-    modified = true;
-    priorityGroup = inPriorityGroup;
+    setColumnValue(priorityGroup, inPriorityGroup, schedulePriorityGroupIdx);
 }
 
 void TaskModel::setPriorityGroupC(const char priorityGroup)
@@ -170,20 +205,24 @@ void TaskModel::setPriorityGroupC(const char priorityGroup)
 
 void TaskModel::setPriority(unsigned int inPriority)
 {
-    modified = true;
-    priority = inPriority;
+    setColumnValue(priority, inPriority, priorityInGroupIdx);
 }
 
 void TaskModel::setPersonal(bool personalIn)
 {
-    modified = true;
-    personal = personalIn;
+    setColumnValue(personal, personalIn, personalIdx);
 }
 
 void TaskModel::addDependency(std::size_t taskId)
 {
-    modified = true;
+    if (std::find(dependencies.begin(), dependencies.end(), taskId) != dependencies.end())
+    {
+        return;
+    }
+
     dependencies.push_back(taskId);
+    addedDependencies.push_back(taskId);
+    modified = true;
 }
 
 void TaskModel::setTaskID(std::size_t newID)
@@ -194,15 +233,12 @@ void TaskModel::setTaskID(std::size_t newID)
 
 bool TaskModel::selectByDescriptionAndAssignedUser(std::string_view description, std::size_t assignedUserID)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE Description = {} AND AsignedTo = {}", description, assignedUserID);
-
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+        NSBM::results localResult = runQueryAsync(formatSelectByDescriptionAndAssignedUser(getFormatOptions(),
+            description, assignedUserID));
 
         return processResult(localResult);
     }
@@ -216,39 +252,155 @@ bool TaskModel::selectByDescriptionAndAssignedUser(std::string_view description,
 
 bool TaskModel::selectByTaskID(std::size_t taskID)
 {
-    prepareForRunQueryAsync();
+    return waitForCoRoutine(asyncSelectByTaskID(taskID)).has_value();
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<void>> TaskModel::asyncSelectByTaskID(std::size_t taskID)
+{
+    errorMessages.clear();
+
+    co_return co_await coRoutineSelectSingleModel(buildPreparedSelectByTaskID(taskID),
+        std::format("selectByTaskID({})", taskID), taskID);
+}
+
+std::vector<std::shared_ptr<TaskModel>> TaskModel::selectByTaskIDs(std::span<const std::size_t> taskIDs)
+{
+    DBResult<std::vector<std::shared_ptr<TaskModel>>> tasks = waitForCoRoutine(
+        asyncSelectByTaskIDs(std::vector<std::size_t>(taskIDs.begin(), taskIDs.end())));
+
+    return tasks.has_value()? std::move(tasks.value()) : std::vector<std::shared_ptr<TaskModel>>();
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<std::vector<std::shared_ptr<TaskModel>>>> TaskModel::asyncSelectByTaskIDs(
+    std::vector<std::size_t> taskIDs)
+{
+    errorMessages.clear();
+
+    std::vector<std::shared_ptr<TaskModel>> tasks;
+    if (taskIDs.empty())
+    {
+        co_return tasks;
+    }
+
+    std::unordered_map<std::size_t, std::shared_ptr<TaskModel>> tasksByID;
+    std::vector<std::size_t> uncachedTaskIDs;
+
+    for (auto taskID: taskIDs)
+    {
+        std::shared_ptr<TaskModel> task = std::make_shared<TaskModel>();
+        if (task->loadFromRowCache(taskID))
+        {
+            tasksByID.insert_or_assign(taskID, task);
+        }
+        else
+        {
+            uncachedTaskIDs.push_back(taskID);
+        }
+    }
+
+    std::string failure;
+    ModelRowCache& rowCache = getRowCache();
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE TaskID = {}", taskID);
+        NSBM::format_options formatOptions = co_await coRoutineGetFormatOptions();
+        std::span<const std::size_t> allTaskIDs(uncachedTaskIDs);
 
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+        for (std::size_t chunkStart = 0; chunkStart < allTaskIDs.size(); chunkStart += MaxTaskIDsPerSelect)
+        {
+            std::span<const std::size_t> chunk = allTaskIDs.subspan(chunkStart,
+                std::min(MaxTaskIDsPerSelect, allTaskIDs.size() - chunkStart));
+
+            std::uint64_t cacheGeneration = rowCache.getGeneration();
+            NSBM::results localResult = co_await coRoutineExecuteSqlStatement(formatSelectByTaskIDs(formatOptions,
+                chunk));
+            for (auto row: localResult.rows())
+            {
+                std::shared_ptr<TaskModel> task = std::make_shared<TaskModel>();
+                task->loadFromResultRow(row);
+                tasksByID.insert_or_assign(task->getTaskID(), task);
+                rowCache.store(task->getTaskID(), row, cacheGeneration);
+            }
+        }
 
-        return processResult(localResult);
+        std::vector<ModelDBInterface*> selectedTasks;
+        selectedTasks.reserve(tasksByID.size());
+        for (auto& selected: tasksByID)
+        {
+            selectedTasks.push_back(selected.second.get());
+        }
+        co_await coRoutineLoadRelatedRows(selectedTasks);
     }
 
     catch(const std::exception& e)
     {
-        appendErrorMessage(std::format("In TaskModel::selectByTaskID({}) : {}", taskID, e.what()));
-        return false;
+        failure = std::format("In TaskModel::selectByTaskIDs : {}", e.what());
     }
+
+    if (!failure.empty())
+    {
+        co_return operationFailed(failure);
+    }
+
+    tasks.reserve(taskIDs.size());
+    for (auto taskID: taskIDs)
+    {
+        auto found = tasksByID.find(taskID);
+        if (found != tasksByID.end())
+        {
+            tasks.push_back(found->second);
+        }
+        else
+        {
+            appendErrorMessage(std::format("In TaskModel::selectByTaskIDs : Task {} not found!", taskID));
+        }
+    }
+
+    co_return tasks;
 }
 
-std::string TaskModel::formatSelectActiveTasksForAssignedUser(std::size_t assignedUserID)
+std::string TaskModel::formatSelectByDescriptionAndAssignedUser(const NSBM::format_options& formatOptions,
+    std::string_view description, std::size_t assignedUserID)
 {
-    prepareForRunQueryAsync();
+    return selectByDescriptionAndAssignedUserQuery.format(formatOptions, description, assignedUserID);
+}
+
+std::string TaskModel::formatSelectByAssignedUser(const NSBM::format_options& formatOptions,
+    std::size_t assignedUserID)
+{
+    return selectByAssignedUserQuery.format(formatOptions, assignedUserID);
+}
+
+std::string TaskModel::formatSelectByTaskIDs(const NSBM::format_options& formatOptions,
+    std::span<const std::size_t> taskIDs)
+{
+    NSBM::format_context fctx(formatOptions);
+    NSBM::format_sql_to(fctx, baseQuery);
+    NSBM::format_sql_to(fctx, " WHERE TaskID IN ({})", taskIDs);
+
+    return std::move(fctx).get().value();
+}
+
+std::string_view TaskModel::getSelectByTaskIDSQL()
+{
+    static const std::string selectByTaskIDSQL = std::string(baseQuery.get()) + " WHERE TaskID = ?";
+
+    return selectByTaskIDSQL;
+}
+
+std::string TaskModel::formatSelectActiveTasksForAssignedUser(const NSBM::format_options& formatOptions,
+    std::size_t assignedUserID, const ListPage& page)
+{
+    errorMessages.clear();
 
     try {
         constexpr unsigned int notStarted = static_cast<unsigned int>(TaskModel::TaskStatus::Not_Started);
 
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, listQueryBase);
-        NSBM::format_sql_to(fctx, " WHERE AsignedTo = {} AND Completed IS NULL AND (Status IS NOT NULL AND Status <> {})",
+        NSBM::format_context fctx = selectActiveTasksForAssignedUserQuery.start(formatOptions,
             assignedUserID, stdchronoDateToBoostMySQLDate(getTodaysDatePlus(OneWeek)), notStarted);
+        appendListPage(fctx, page, true, "RequiredDelivery");
 
-        return std::move(fctx).get().value();
+        return QueryTemplate::finish(std::move(fctx));
     }
 
     catch(const std::exception& e)
@@ -256,22 +408,22 @@ std::string TaskModel::formatSelectActiveTasksForAssignedUser(std::size_t assign
         appendErrorMessage(std::format("In TaskModel::formatSelectUnstartedDueForStartForAssignedUser({}) : {}", assignedUserID, e.what()));
     }
 
-    return std::string();
+    return {};
 }
 
-std::string TaskModel::formatSelectUnstartedDueForStartForAssignedUser(std::size_t assignedUserID)
+std::string TaskModel::formatSelectUnstartedDueForStartForAssignedUser(const NSBM::format_options& formatOptions,
+    std::size_t assignedUserID, const ListPage& page)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try {
         constexpr unsigned int notStarted = static_cast<unsigned int>(TaskModel::TaskStatus::Not_Started);
 
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, listQueryBase);
-        NSBM::format_sql_to(fctx, " WHERE AsignedTo = {} AND ScheduledStart < {} AND (Status IS NULL OR Status = {})",
+        NSBM::format_context fctx = selectUnstartedDueForStartForAssignedUserQuery.start(formatOptions,
             assignedUserID, stdchronoDateToBoostMySQLDate(getTodaysDatePlus(OneWeek)), notStarted);
+        appendListPage(fctx, page, true, "RequiredDelivery");
 
-        return std::move(fctx).get().value();
+        return QueryTemplate::finish(std::move(fctx));
     }
 
     catch(const std::exception& e)
@@ -279,20 +431,20 @@ std::string TaskModel::formatSelectUnstartedDueForStartForAssignedUser(std::size
         appendErrorMessage(std::format("In TaskModel::formatSelectUnstartedDueForStartForAssignedUser({}) : {}", assignedUserID, e.what()));
     }
 
-    return std::string();
+    return {};
 }
 
-std::string TaskModel::formatSelectTasksCompletedByAssignedAfterDate(std::size_t assignedUserID, std::chrono::year_month_day& searchStartDate)
+std::string TaskModel::formatSelectTasksCompletedByAssignedAfterDate(const NSBM::format_options& formatOptions,
+    std::size_t assignedUserID, std::chrono::year_month_day& searchStartDate, const ListPage& page)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, listQueryBase);
-        NSBM::format_sql_to(fctx, " WHERE AsignedTo = {} AND Completed >= {}",
+        NSBM::format_context fctx = selectTasksCompletedByAssignedAfterDateQuery.start(formatOptions,
             assignedUserID, stdchronoDateToBoostMySQLDate(searchStartDate));
+        appendListPage(fctx, page, true);
 
-        return std::move(fctx).get().value();
+        return QueryTemplate::finish(std::move(fctx));
     }
 
     catch(const std::exception& e)
@@ -300,19 +452,20 @@ std::string TaskModel::formatSelectTasksCompletedByAssignedAfterDate(std::size_t
         appendErrorMessage(std::format("In TaskModel::formatSelectTasksCompletedByAssignedAfterDate({}) : {}", assignedUserID, e.what()));
     }
 
-    return std::string();
+    return {};
 }
 
-std::string TaskModel::formatSelectTasksByAssignedIDandParentID(std::size_t assignedUserID, std::size_t parentID)
+std::string TaskModel::formatSelectTasksByAssignedIDandParentID(const NSBM::format_options& formatOptions,
+    std::size_t assignedUserID, std::size_t parentID, const ListPage& page)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, listQueryBase);
-        NSBM::format_sql_to(fctx, " WHERE AsignedTo = {} AND ParentTask = {}", assignedUserID, parentID);
+        NSBM::format_context fctx = selectTasksByAssignedIDandParentIDQuery.start(formatOptions,
+            assignedUserID, parentID);
+        appendListPage(fctx, page, true);
 
-        return std::move(fctx).get().value();
+        return QueryTemplate::finish(std::move(fctx));
     }
 
     catch(const std::exception& e)
@@ -320,7 +473,48 @@ std::string TaskModel::formatSelectTasksByAssignedIDandParentID(std::size_t assi
         appendErrorMessage(std::format("In TaskModel::formatSelectTasksByAssignedIDandParentID({}) : {}", assignedUserID, e.what()));
     }
 
-    return std::string();
+    return {};
+}
+
+/*
+ * The reverse dependencies are found through the DependsOn index of TaskDependencies.
+ */
+std::string TaskModel::formatSelectTasksThatDependOn(const NSBM::format_options& formatOptions,
+    std::size_t taskID, const ListPage& page)
+{
+    errorMessages.clear();
+
+    try {
+        NSBM::format_context fctx = selectTasksThatDependOnQuery.start(formatOptions, taskID);
+        appendListPage(fctx, page, true);
+
+        return QueryTemplate::finish(std::move(fctx));
+    }
+
+    catch(const std::exception& e)
+    {
+        appendErrorMessage(std::format("In TaskModel::formatSelectTasksThatDependOn({}) : {}", taskID, e.what()));
+    }
+
+    return {};
+}
+
+std::string TaskModel::formatSelectTaskTree(const NSBM::format_options& formatOptions,
+    std::size_t rootTaskID, std::size_t maxDepth)
+{
+    errorMessages.clear();
+
+    try {
+        return selectTaskTreeQuery.format(formatOptions, rootTaskID,
+            std::min(maxDepth, TaskTree::MaxDepthLimit) + 1);
+    }
+
+    catch(const std::exception& e)
+    {
+        appendErrorMessage(std::format("In TaskModel::formatSelectTaskTree({}) : {}", rootTaskID, e.what()));
+    }
+
+    return {};
 }
 
 std::string TaskModel::taskStatusString() const
@@ -358,204 +552,313 @@ bool TaskModel::diffTask(TaskModel& other)
 
 std::string TaskModel::formatInsertStatement()
 {
-    std::size_t dependencyCount = getDependencies().size();
-    std::optional<std::string> depenenciesText;
-    if (dependencyCount)
-    {
-        std::vector<std::size_t> dependencyList = getDependencies();
-        depenenciesText = buildDependenciesText(dependencyList);
-    }
-
-    return NSBM::format_sql(format_opts.value(),
-        "INSERT INTO Tasks (CreatedBy, AsignedTo, Description, ParentTask, Status, PercentageComplete, CreatedOn,"
-            "RequiredDelivery, ScheduledStart, ActualStart, EstimatedCompletion, Completed, EstimatedEffortHours, "
-            "ActualEffortHours, SchedulePriorityGroup, PriorityInGroup, Personal, DependencyCount, Dependencies)"
-            " VALUES ({0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}, {10}, {11}, {12}, {13}, {14}, {15}, {16}, {17}, {18})",
-            creatorID,
-            assignToID,
-            description,
-            parentTaskID,
-            getStatusIntVal(),
-            percentageComplete,
-            stdchronoDateToBoostMySQLDate(creationDate),
-            stdchronoDateToBoostMySQLDate(dueDate),
-            stdchronoDateToBoostMySQLDate(scheduledStart),
-            optionalDateConversion(actualStartDate),
-            optionalDateConversion(estimatedCompletion),
-            optionalDateConversion(completionDate),
-            estimatedEffort,
-            actualEffortToDate,
-            priorityGroup,
-            priority,
-            personal,
-            dependencyCount,
-            depenenciesText
-    );
+    return std::string(insertTaskPrefixSQL) + formatBulkInsertValues(format_opts.value());
 }
 
-std::string TaskModel::formatUpdateStatement()
+std::string_view TaskModel::getBulkInsertPrefix() const
 {
-    std::size_t dependencyCount = getDependencies().size();
-    std::optional<std::string> depenenciesText;
-    if (dependencyCount)
-    {
-        std::vector<std::size_t> dependencyList = getDependencies();
-        depenenciesText = buildDependenciesText(dependencyList);
-    }
-
-    return NSBM::format_sql(format_opts.value(),
-        "UPDATE Tasks SET"
-            " CreatedBy = {0},"
-            " AsignedTo = {1},"
-            " Description = {2},"
-            " ParentTask = {3},"
-            " Status = {4},"
-            " PercentageComplete = {5},"
-            " CreatedOn = {6},"
-            " RequiredDelivery = {7},"
-            " ScheduledStart = {8},"
-            " ActualStart = {9},"
-            " EstimatedCompletion = {10},"
-            " Completed = {11},"
-            " EstimatedEffortHours = {12},"
-            " ActualEffortHours = {13},"
-            " SchedulePriorityGroup = {14},"
-            " PriorityInGroup = {15},"
-            " Personal = {16},"
-            " DependencyCount = {17},"
-            "Dependencies = {18}"
-        " WHERE TaskID = {19} ",
-            creatorID,
-            assignToID,
-            description,
-            parentTaskID,
-            getStatusIntVal(),
-            percentageComplete,
-            stdchronoDateToBoostMySQLDate(creationDate),
-            stdchronoDateToBoostMySQLDate(dueDate),
-            stdchronoDateToBoostMySQLDate(scheduledStart),
-            optionalDateConversion(actualStartDate),
-            optionalDateConversion(estimatedCompletion),
-            optionalDateConversion(completionDate),
-            estimatedEffort,
-            actualEffortToDate,
-            priorityGroup,
-            priority,
-            personal,
-            dependencyCount,
-            depenenciesText,
-        primaryKey
-    );}
-
-std::string TaskModel::formatSelectStatement()
-{
-    prepareForRunQueryAsync();
+    return insertTaskPrefixSQL;
+}
 
-    NSBM::format_context fctx(format_opts.value());
-    NSBM::format_sql_to(fctx, baseQuery);
-    NSBM::format_sql_to(fctx, " WHERE TaskID = {}", primaryKey);
+/*
+ * Shared with TaskGateway, which reads and writes the same rows.
+ */
+ModelRowCache& TaskModel::taskRowCache()
+{
+    static ModelRowCache taskRows("Tasks", programOptions.modelCacheSize);
+    return taskRows;
+}
 
-    return std::move(fctx).get().value();
+CoreDBInterface::PreparedQuery TaskModel::buildPreparedInsert()
+{
+    return buildRecordInsert(toRecord());
 }
 
-void TaskModel::initRequiredFields()
+ModelDBInterface::UpdateColumns TaskModel::getUpdateColumns() const
 {
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingDescription, this), "description"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingCreatorID, this), "user ID for creator"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingAssignedID, this), "user ID for assigned user"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingEffortEstimate, this), "estimated effort in hours"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingPriorityGroup, this), "priority"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingCreationDate, this), "date of creation"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingScheduledStart, this), "scheduled start date"});
-    missingRequiredFieldsTests.push_back({std::bind(&TaskModel::isMissingDueDate, this), "due date (deadline)"});
+    return UpdateColumns{schema.tableName, schema.columnNames};
 }
 
-void TaskModel::addDependencies(const std::string & dependenciesText)
+CoreDBInterface::PreparedQuery TaskModel::buildPreparedSelect()
 {
-    std::vector<std::string> dependencyStrings = explodeTextField(dependenciesText);
+    return buildPreparedSelectByTaskID(primaryKey);
+}
+
+CoreDBInterface::PreparedQuery TaskModel::buildPreparedSelectByTaskID(std::size_t taskID)
+{
+    return PreparedQuery{"Tasks.selectByTaskID", getSelectByTaskIDSQL(), {NSBM::field(taskID)}};
+}
 
-    if (!dependencyStrings.empty())
+CoreDBInterface::PreparedQuery TaskModel::buildRecordInsert(TaskRecord task)
+{
+    return PreparedQuery{"Tasks.insert", insertTaskSQL, recordColumnParameters(std::move(task))};
+}
+
+/*
+ * Writes every column, the record does not track which columns changed.
+ */
+CoreDBInterface::PreparedQuery TaskModel::buildRecordUpdate(TaskRecord task)
+{
+    std::uint32_t taskID = task.taskID;
+    PreparedQuery updateQuery{"Tasks.updateAll", updateAllTaskSQL, recordColumnParameters(std::move(task))};
+    updateQuery.parameters.emplace_back(taskID);
+
+    return updateQuery;
+}
+
+/*
+ * A task without a status is written as Not_Started.
+ */
+TaskRecord TaskModel::toRecord() const
+{
+    TaskRecord task;
+
+    task.taskID = static_cast<std::uint32_t>(primaryKey);
+    task.createdBy = static_cast<std::uint32_t>(creatorID);
+    task.assignedTo = static_cast<std::uint32_t>(assignToID);
+    task.description = description;
+    if (parentTaskID.has_value())
     {
-        for (auto dependencyStr: dependencyStrings)
-        {
-            dependencies.push_back(static_cast<std::size_t>(std::stol(dependencyStr)));
-        }
+        task.parentTaskID = static_cast<std::uint32_t>(parentTaskID.value());
     }
-    else
+    task.status = static_cast<std::uint8_t>(getStatusIntVal());
+    task.percentageComplete = percentageComplete;
+    task.createdOn = creationDate;
+    task.requiredDelivery = dueDate;
+    task.scheduledStart = scheduledStart;
+    task.actualStart = actualStartDate;
+    task.estimatedCompletion = estimatedCompletion;
+    task.completed = completionDate;
+    task.estimatedEffortHours = estimatedEffort;
+    task.actualEffortHours = actualEffortToDate;
+    task.schedulePriorityGroup = priorityGroup;
+    task.priorityInGroup = priority;
+    task.personal = personal;
+
+    return task;
+}
+
+/*
+ * Column values in the order of the INSERT column list, each value is placed by
+ * its schema column index.
+ */
+std::vector<NSBM::field> TaskModel::recordColumnParameters(TaskRecord task)
+{
+    std::vector<NSBM::field> parameters(schema.parameterCount);
+
+    parameters[schema.parameterIdx(createdByIdx)] = NSBM::field(task.createdBy);
+    parameters[schema.parameterIdx(assignedToIdx)] = NSBM::field(task.assignedTo);
+    parameters[schema.parameterIdx(descriptionIdx)] = NSBM::field(std::move(task.description));
+    parameters[schema.parameterIdx(parentTaskIdx)] = optionalToField(task.parentTaskID);
+    parameters[schema.parameterIdx(statusIdx)] = task.status.has_value()?
+        NSBM::field(static_cast<unsigned int>(task.status.value())) : NSBM::field();
+    parameters[schema.parameterIdx(percentageCompleteIdx)] = NSBM::field(task.percentageComplete);
+    parameters[schema.parameterIdx(createdOnIdx)] = NSBM::field(stdchronoDateToBoostMySQLDate(task.createdOn));
+    parameters[schema.parameterIdx(requiredDeliveryIdx)] =
+        NSBM::field(stdchronoDateToBoostMySQLDate(task.requiredDelivery));
+    parameters[schema.parameterIdx(scheduledStartIdx)] = NSBM::field(stdchronoDateToBoostMySQLDate(task.scheduledStart));
+    parameters[schema.parameterIdx(actualStartIdx)] = optionalToField(optionalDateConversion(task.actualStart));
+    parameters[schema.parameterIdx(estimatedCompletionIdx)] =
+        optionalToField(optionalDateConversion(task.estimatedCompletion));
+    parameters[schema.parameterIdx(completedIdx)] = optionalToField(optionalDateConversion(task.completed));
+    parameters[schema.parameterIdx(estimatedEffortHoursIdx)] = NSBM::field(task.estimatedEffortHours);
+    parameters[schema.parameterIdx(actualEffortHoursIdx)] = NSBM::field(task.actualEffortHours);
+    parameters[schema.parameterIdx(schedulePriorityGroupIdx)] = NSBM::field(task.schedulePriorityGroup);
+    parameters[schema.parameterIdx(priorityInGroupIdx)] = NSBM::field(task.priorityInGroup);
+    parameters[schema.parameterIdx(personalIdx)] = NSBM::field(static_cast<int>(task.personal));
+
+    return parameters;
+}
+
+/*
+ * Existing edges are left as they are, a dependency that is already in the table is
+ * not an error.
+ */
+std::vector<std::string> TaskModel::formatRelatedRows()
+{
+    std::vector<std::string> statements;
+    if (addedDependencies.empty())
     {
-        std::runtime_error NoExpectedDependencies("Dependencies expected but not found!");
-        throw NoExpectedDependencies;
+        return statements;
     }
+
+    NSBM::format_context fctx(format_opts.value());
+    NSBM::format_sql_to(fctx, "INSERT INTO TaskDependencies (TaskID, DependsOn) VALUES ");
+
+    for (std::size_t dependencyIdx = 0; dependencyIdx < addedDependencies.size(); ++dependencyIdx)
+    {
+        if (dependencyIdx > 0)
+        {
+            NSBM::format_sql_to(fctx, ", ");
+        }
+
+        if (isInDataBase())
+        {
+            NSBM::format_sql_to(fctx, "({}, {})", primaryKey, addedDependencies[dependencyIdx]);
+        }
+        else
+        {
+            NSBM::format_sql_to(fctx, "(LAST_INSERT_ID(), {})", addedDependencies[dependencyIdx]);
+        }
+    }
+    NSBM::format_sql_to(fctx, " ON DUPLICATE KEY UPDATE TaskID = TaskID");
+
+    statements.push_back(std::move(fctx).get().value());
+
+    return statements;
 }
 
-std::string TaskModel::buildDependenciesText(std::vector<std::size_t>& dependencyList) noexcept
+/*
+ * The edges are read in DependsOn order, each task's dependencies are sorted. The
+ * dependencies of a cached task are kept with its row in the row cache, the edges
+ * are only read for the tasks whose dependencies are not cached.
+ */
+NSBA::awaitable<void> TaskModel::coRoutineLoadRelatedRows(std::span<ModelDBInterface* const> tasks)
 {
-    if (dependencyList.size() > 1)
+    ModelRowCache& rowCache = getRowCache();
+    std::unordered_map<std::size_t, std::vector<TaskModel*>> tasksByID;
+    std::vector<std::size_t> taskIDs;
+
+    for (ModelDBInterface* model: tasks)
+    {
+        TaskModel* task = static_cast<TaskModel*>(model);
+        if (std::optional<std::vector<std::size_t>> cachedDependencies = rowCache.findRelatedIDs(task->primaryKey);
+            cachedDependencies.has_value())
+        {
+            task->dependencies = std::move(cachedDependencies.value());
+            continue;
+        }
+
+        task->dependencies.clear();
+        std::vector<TaskModel*>& sameTask = tasksByID[task->primaryKey];
+        if (sameTask.empty())
+        {
+            taskIDs.push_back(task->primaryKey);
+        }
+        sameTask.push_back(task);
+    }
+
+    if (taskIDs.empty())
     {
-        std::sort(dependencyList.begin(), dependencyList.end());
+        co_return;
     }
 
-    std::vector<std::string> dependencyStrings;
-    for (auto dependency: dependencyList)
+    std::uint64_t cacheGeneration = rowCache.getGeneration();
+    NSBM::format_options formatOptions = co_await coRoutineGetFormatOptions();
+    std::span<const std::size_t> allTaskIDs(taskIDs);
+
+    for (std::size_t chunkStart = 0; chunkStart < allTaskIDs.size(); chunkStart += MaxTaskIDsPerSelect)
     {
-        dependencyStrings.push_back(std::to_string(dependency));
+        std::span<const std::size_t> chunk = allTaskIDs.subspan(chunkStart,
+            std::min(MaxTaskIDsPerSelect, allTaskIDs.size() - chunkStart));
+
+        NSBM::results localResult = co_await coRoutineExecuteSqlStatement(NSBM::format_sql(formatOptions,
+            "SELECT TaskID, DependsOn FROM TaskDependencies WHERE TaskID IN ({}) ORDER BY TaskID, DependsOn", chunk));
+
+        for (auto row: localResult.rows())
+        {
+            for (TaskModel* task: tasksByID[row.at(0).as_uint64()])
+            {
+                task->dependencies.push_back(row.at(1).as_uint64());
+            }
+        }
     }
 
-    return implodeTextField(dependencyStrings);
+    for (std::size_t taskID: taskIDs)
+    {
+        rowCache.storeRelatedIDs(taskID, tasksByID[taskID].front()->dependencies, cacheGeneration);
+    }
 }
 
-void TaskModel::processResultRow(NSBM::row_view rv)
+/*
+ * The column indexes come from the schema and the row is checked against it, so
+ * the columns are accessed without bounds checks.
+ */
+TaskRecord TaskModel::recordFromRow(NSBM::row_view rv)
 {
+    if (rv.size() != schema.columnCount)
+    {
+        throw std::runtime_error(std::format("Task row has {} columns, expected {}", rv.size(), schema.columnCount));
+    }
+
+    TaskRecord task;
+
     // Required fields.
-    primaryKey = rv.at(taskIdIdx).as_uint64();
-    creatorID = rv.at(createdByIdx).as_uint64();
-    assignToID = rv.at(assignedToIdx).as_uint64();
-    description = rv.at(descriptionIdx).as_string();
-    percentageComplete = rv.at(percentageCompleteIdx).as_double();
-    creationDate = boostMysqlDateToChronoDate(rv.at(createdOnIdx).as_date());
-    dueDate = boostMysqlDateToChronoDate(rv.at(requiredDeliveryIdx).as_date());
-    scheduledStart = boostMysqlDateToChronoDate(rv.at(scheduledStartIdx).as_date());
-    estimatedEffort = rv.at(estimatedEffortHoursIdx).as_uint64();
-    actualEffortToDate = rv.at(actualEffortHoursIdx).as_double();
-    priorityGroup = rv.at(schedulePriorityGroupIdx).as_uint64();
-    priority = rv.at(priorityInGroupIdx).as_uint64();
-    personal = rv.at(personalIdx).as_int64();
+    task.taskID = static_cast<std::uint32_t>(rv[taskIdIdx].as_uint64());
+    task.createdBy = static_cast<std::uint32_t>(rv[createdByIdx].as_uint64());
+    task.assignedTo = static_cast<std::uint32_t>(rv[assignedToIdx].as_uint64());
+    task.description = rv[descriptionIdx].as_string();
+    task.percentageComplete = rv[percentageCompleteIdx].as_double();
+    task.createdOn = boostMysqlDateToChronoDate(rv[createdOnIdx].as_date());
+    task.requiredDelivery = boostMysqlDateToChronoDate(rv[requiredDeliveryIdx].as_date());
+    task.scheduledStart = boostMysqlDateToChronoDate(rv[scheduledStartIdx].as_date());
+    task.estimatedEffortHours = static_cast<std::uint32_t>(rv[estimatedEffortHoursIdx].as_uint64());
+    task.actualEffortHours = rv[actualEffortHoursIdx].as_double();
+    task.schedulePriorityGroup = static_cast<std::uint32_t>(rv[schedulePriorityGroupIdx].as_uint64());
+    task.priorityInGroup = static_cast<std::uint32_t>(rv[priorityInGroupIdx].as_uint64());
+    task.personal = !rv[personalIdx].is_null() && rv[personalIdx].as_int64() != 0;
 
     // Optional fields.
-    if (!rv.at(parentTaskIdx).is_null())
+    if (!rv[parentTaskIdx].is_null())
     {
-        parentTaskID = rv.at(parentTaskIdx).as_uint64();
+        task.parentTaskID = static_cast<std::uint32_t>(rv[parentTaskIdx].as_uint64());
     }
 
-    if (!rv.at(statusIdx).is_null())
+    if (!rv[statusIdx].is_null())
     {
-        setStatus(static_cast<TaskModel::TaskStatus>(rv.at(statusIdx).as_uint64()));
+        task.status = static_cast<std::uint8_t>(rv[statusIdx].as_uint64());
     }
 
-    if (!rv.at(actualStartIdx).is_null())
+    if (!rv[actualStartIdx].is_null())
     {
-        actualStartDate = boostMysqlDateToChronoDate(rv.at(actualStartIdx).as_date());
+        task.actualStart = boostMysqlDateToChronoDate(rv[actualStartIdx].as_date());
     }
 
-    if (!rv.at(estimatedCompletionIdx).is_null())
+    if (!rv[estimatedCompletionIdx].is_null())
     {
-        estimatedCompletion = boostMysqlDateToChronoDate(rv.at(estimatedCompletionIdx).as_date());
+        task.estimatedCompletion = boostMysqlDateToChronoDate(rv[estimatedCompletionIdx].as_date());
     }
 
-    if (!rv.at(completedIdx).is_null())
+    if (!rv[completedIdx].is_null())
     {
-        completionDate = boostMysqlDateToChronoDate(rv.at(completedIdx).as_date());
+        task.completed = boostMysqlDateToChronoDate(rv[completedIdx].as_date());
     }
 
-    std::size_t dependencyCount = rv.at(dependencyCountIdx).as_uint64();
-    if (dependencyCount > 0)
+    return task;
+}
+
+void TaskModel::processResultRow(NSBM::row_view rv)
+{
+    TaskRecord task = recordFromRow(rv);
+
+    primaryKey = task.taskID;
+    creatorID = task.createdBy;
+    assignToID = task.assignedTo;
+    description = std::move(task.description);
+    parentTaskID = task.parentTaskID;
+    status.reset();
+    if (task.status.has_value())
     {
-        std::string dependenciesText = rv.at(depenedenciesTextIdx).as_string();
-        addDependencies(dependenciesText);
+        status = statusFromInt(task.status.value());
     }
+    percentageComplete = task.percentageComplete;
+    creationDate = task.createdOn;
+    dueDate = task.requiredDelivery;
+    scheduledStart = task.scheduledStart;
+    actualStartDate = task.actualStart;
+    estimatedCompletion = task.estimatedCompletion;
+    completionDate = task.completed;
+    estimatedEffort = task.estimatedEffortHours;
+    actualEffortToDate = task.actualEffortHours;
+    priorityGroup = task.schedulePriorityGroup;
+    priority = task.priorityInGroup;
+    personal = task.personal;
+
+    // The dependencies are loaded by coRoutineLoadRelatedRows().
+    dependencies.clear();
+    addedDependencies.clear();
 
     // All the set functions set modified, since this user is new in memory it is not modified.
     modified = false;
-
 }
 
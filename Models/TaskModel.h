@@ -1,15 +1,19 @@
 #ifndef TASKMODEL_H_
 #define TASKMODEL_H_
 
+#include <array>
 #include <chrono>
 #include "commonUtilities.h"
 #include <format>
-#include <functional>
 #include <iostream>
 #include <memory>
 #include "ModelDBInterface.h"
+#include "ModelSchema.h"
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include "TaskRecord.h"
 #include <vector>
 
 class TaskModel : public ModelDBInterface
@@ -86,24 +90,81 @@ public:
  */
     bool selectByDescriptionAndAssignedUser(std::string_view description, std::size_t assignedUserID);
     bool selectByTaskID(std::size_t taskID);
-    // Return multiple Tasks.
-    std::string formatSelectActiveTasksForAssignedUser(std::size_t assignedUserID);
-    std::string formatSelectUnstartedDueForStartForAssignedUser(std::size_t assignedUserID);
-    std::string formatSelectTasksCompletedByAssignedAfterDate(std::size_t assignedUserID,
-        std::chrono::year_month_day& searchStartDate);
-    std::string formatSelectTasksByAssignedIDandParentID(std::size_t assignedUserID, std::size_t parentID);
+    NSBA::awaitable<DBResult<void>> asyncSelectByTaskID(std::size_t taskID);
+    std::string_view getBulkInsertPrefix() const override;
+    ModelRowCache& getRowCache() const override { return taskRowCache(); };
+    static ModelRowCache& taskRowCache();
+    unsigned int getFlushOrder() const noexcept override { return 1; };   // Tasks reference UserProfile.
+/*
+ * Select many tasks by TaskID with one query per MaxTaskIDsPerSelect IDs. The tasks
+ * are returned in the order of the IDs, IDs that are not found are reported in the
+ * error messages and left out of the result.
+ */
+    std::vector<std::shared_ptr<TaskModel>> selectByTaskIDs(std::span<const std::size_t> taskIDs);
+    NSBA::awaitable<DBResult<std::vector<std::shared_ptr<TaskModel>>>> asyncSelectByTaskIDs(
+        std::vector<std::size_t> taskIDs);
+/*
+ * The statements of the selects above, these throw if a value can't be formatted.
+ * The select by TaskID is prepared, its one parameter is the TaskID.
+ */
+    static std::string formatSelectByDescriptionAndAssignedUser(const NSBM::format_options& formatOptions,
+        std::string_view description, std::size_t assignedUserID);
+    static std::string formatSelectByAssignedUser(const NSBM::format_options& formatOptions,
+        std::size_t assignedUserID);
+    static std::string formatSelectByTaskIDs(const NSBM::format_options& formatOptions,
+        std::span<const std::size_t> taskIDs);
+    static std::string_view getSelectByTaskIDSQL();
+/*
+ * The one codec of a Tasks row, TaskModel decodes its rows and encodes its
+ * parameters through a TaskRecord, TaskGateway uses the codec and the prepared
+ * statements below for its records.
+ */
+    static TaskRecord recordFromRow(NSBM::row_view rv);
+    static std::vector<NSBM::field> recordColumnParameters(TaskRecord task);
+    static PreparedQuery buildPreparedSelectByTaskID(std::size_t taskID);
+    static PreparedQuery buildRecordInsert(TaskRecord task);
+    static PreparedQuery buildRecordUpdate(TaskRecord task);
+/*
+ * The list queries, see QueryTemplate. The caller provides the format options,
+ * coroutines must not wait for them with getFormatOptions().
+ */
+    std::string formatSelectActiveTasksForAssignedUser(const NSBM::format_options& formatOptions,
+        std::size_t assignedUserID, const ListPage& page = {});
+    std::string formatSelectUnstartedDueForStartForAssignedUser(const NSBM::format_options& formatOptions,
+        std::size_t assignedUserID, const ListPage& page = {});
+    std::string formatSelectTasksCompletedByAssignedAfterDate(const NSBM::format_options& formatOptions,
+        std::size_t assignedUserID, std::chrono::year_month_day& searchStartDate, const ListPage& page = {});
+    std::string formatSelectTasksByAssignedIDandParentID(const NSBM::format_options& formatOptions,
+        std::size_t assignedUserID, std::size_t parentID, const ListPage& page = {});
+    std::string formatSelectTasksThatDependOn(const NSBM::format_options& formatOptions, std::size_t taskID,
+        const ListPage& page = {});
+/*
+ * The task and its descendants to maxDepth + 1 levels below it, see TaskTree.
+ */
+    std::string formatSelectTaskTree(const NSBM::format_options& formatOptions, std::size_t rootTaskID,
+        std::size_t maxDepth);
+/*
+ * The dependencies are rows of the TaskDependencies table, the dependencies of all
+ * the tasks of a list are loaded with one query per MaxTaskIDsPerSelect tasks. The
+ * row cache keeps the dependencies of each cached task with its row.
+ */
+    bool hasRelatedRowChanges() const override { return !addedDependencies.empty(); };
+    void clearRelatedRowChanges() override { addedDependencies.clear(); };
+    NSBA::awaitable<void> coRoutineLoadRelatedRows(std::span<ModelDBInterface* const> tasks) override;
 
 /*
  * Required fields.
  */
-    bool isMissingDescription() { return (description.empty() || description.length() < MinimumDescriptionLength); };
-    bool isMissingCreatorID() { return creatorID == 0; };
-    bool isMissingAssignedID() { return assignToID == 0; };
-    bool isMissingEffortEstimate() { return estimatedEffort == 0; };
-    bool isMissingPriorityGroup() { return priorityGroup == 0; };
-    bool isMissingCreationDate() { return !creationDate.ok(); };
-    bool isMissingScheduledStart() { return !scheduledStart.ok(); };
-    bool isMissingDueDate() { return !dueDate.ok(); };
+    bool isMissingDescription() const { return (description.empty() || description.length() < MinimumDescriptionLength); };
+    bool isMissingCreatorID() const { return creatorID == 0; };
+    bool isMissingAssignedID() const { return assignToID == 0; };
+    bool isMissingEffortEstimate() const { return estimatedEffort == 0; };
+    bool isMissingPriorityGroup() const { return priorityGroup == 0; };
+    bool isMissingCreationDate() const { return !creationDate.ok(); };
+    bool isMissingScheduledStart() const { return !scheduledStart.ok(); };
+    bool isMissingDueDate() const { return !dueDate.ok(); };
+    bool hasRequiredValues() const override { return requiredFieldsPresent(requiredFields); };
+    void reportMissingFields() noexcept override { reportMissingRequiredFields(requiredFields); };
 
 
     bool operator==(TaskModel& other)
@@ -157,16 +218,27 @@ public:
         return os;
     };
 
+/*
+ * The select, insert and update statements and the column indexes are generated
+ * from the schema, the column order is the order of the schema's column names.
+ */
+    static constexpr ModelSchema<18> schema{"Tasks",
+        {
+            "TaskID", "CreatedBy", "AsignedTo", "Description", "ParentTask", "Status", "PercentageComplete",
+            "CreatedOn", "RequiredDelivery", "ScheduledStart", "ActualStart", "EstimatedCompletion", "Completed",
+            "EstimatedEffortHours", "ActualEffortHours", "SchedulePriorityGroup", "PriorityInGroup", "Personal"
+        }
+    };
 
 private:
     TaskStatus statusFromInt(unsigned int statusI) const { return static_cast<TaskModel::TaskStatus>(statusI); };
     bool diffTask(TaskModel& other);
     std::string formatInsertStatement() override;
-    std::string formatUpdateStatement() override;
-    std::string formatSelectStatement() override;
-    void initRequiredFields() override;
-    void addDependencies(const std::string& dependenciesText);
-    std::string buildDependenciesText(std::vector<std::size_t>& dependencyList) noexcept;
+    PreparedQuery buildPreparedInsert() override;
+    UpdateColumns getUpdateColumns() const override;
+    PreparedQuery buildPreparedSelect() override;
+    TaskRecord toRecord() const;
+    std::vector<std::string> formatRelatedRows() override;
     void processResultRow(NSBM::row_view rv) override;
 
     std::size_t creatorID;
@@ -186,40 +258,46 @@ private:
     unsigned int priorityGroup;
     unsigned int priority;
     bool personal;
-    const std::size_t MinimumDescriptionLength = 10;
+    static constexpr std::size_t MinimumDescriptionLength = 10;
     std::vector<std::size_t> dependencies;
+    std::vector<std::size_t> addedDependencies;     // Not yet written to TaskDependencies.
+
+    static constexpr std::array<RequiredField<TaskModel>, 8> requiredFields{{
+        {&TaskModel::isMissingDescription, "description"},
+        {&TaskModel::isMissingCreatorID, "user ID for creator"},
+        {&TaskModel::isMissingAssignedID, "user ID for assigned user"},
+        {&TaskModel::isMissingEffortEstimate, "estimated effort in hours"},
+        {&TaskModel::isMissingPriorityGroup, "priority"},
+        {&TaskModel::isMissingCreationDate, "date of creation"},
+        {&TaskModel::isMissingScheduledStart, "scheduled start date"},
+        {&TaskModel::isMissingDueDate, "due date (deadline)"}
+    }};
+
+    static constexpr NSBM::constant_string_view baseQuery{schemaStatement<schema, SchemaStatement::Select>};
+
+    static constexpr std::size_t taskIdIdx = schema.columnIdx("TaskID");
+    static constexpr std::size_t createdByIdx = schema.columnIdx("CreatedBy");
+    static constexpr std::size_t assignedToIdx = schema.columnIdx("AsignedTo");
+    static constexpr std::size_t descriptionIdx = schema.columnIdx("Description");
+    static constexpr std::size_t parentTaskIdx = schema.columnIdx("ParentTask");
+    static constexpr std::size_t statusIdx = schema.columnIdx("Status");
+    static constexpr std::size_t percentageCompleteIdx = schema.columnIdx("PercentageComplete");
+    static constexpr std::size_t createdOnIdx = schema.columnIdx("CreatedOn");
+    static constexpr std::size_t requiredDeliveryIdx = schema.columnIdx("RequiredDelivery");
+    static constexpr std::size_t scheduledStartIdx = schema.columnIdx("ScheduledStart");
+    static constexpr std::size_t actualStartIdx = schema.columnIdx("ActualStart");
+    static constexpr std::size_t estimatedCompletionIdx = schema.columnIdx("EstimatedCompletion");
+    static constexpr std::size_t completedIdx = schema.columnIdx("Completed");
+    static constexpr std::size_t estimatedEffortHoursIdx = schema.columnIdx("EstimatedEffortHours");
+    static constexpr std::size_t actualEffortHoursIdx = schema.columnIdx("ActualEffortHours");
+    static constexpr std::size_t schedulePriorityGroupIdx = schema.columnIdx("SchedulePriorityGroup");
+    static constexpr std::size_t priorityInGroupIdx = schema.columnIdx("PriorityInGroup");
+    static constexpr std::size_t personalIdx = schema.columnIdx("Personal");
 
 /*
- * The indexes below are based on the following select statement, maintain this order
- * baseQuery could be SELECT * FROM Tasks, but this way the order of the columns
- * returned are known.
+ * Keeps each chunk of selectByTaskIDs() well below the maximum size of an NSBM::results.
  */
-    NSBM::constant_string_view baseQuery = "SELECT TaskID, CreatedBy, AsignedTo, Description, ParentTask, Status, PercentageComplete, CreatedOn,"
-            "RequiredDelivery, ScheduledStart, ActualStart, EstimatedCompletion, Completed, EstimatedEffortHours, "
-            "ActualEffortHours, SchedulePriorityGroup, PriorityInGroup, Personal, DependencyCount, Dependencies FROM Tasks ";
-
-    const std::size_t taskIdIdx = 0;
-    const std::size_t createdByIdx = 1;
-    const std::size_t assignedToIdx = 2;
-    const std::size_t descriptionIdx = 3;
-    const std::size_t parentTaskIdx = 4;
-    const std::size_t statusIdx = 5;
-    const std::size_t percentageCompleteIdx = 6;
-    const std::size_t createdOnIdx = 7;
-    const std::size_t requiredDeliveryIdx = 8;
-    const std::size_t scheduledStartIdx = 9;
-    const std::size_t actualStartIdx = 10;
-    const std::size_t estimatedCompletionIdx = 11;
-    const std::size_t completedIdx = 12;
-    const std::size_t estimatedEffortHoursIdx = 13;
-    const std::size_t actualEffortHoursIdx = 14;
-    const std::size_t schedulePriorityGroupIdx = 15;
-    const std::size_t priorityInGroupIdx = 16;
-    const std::size_t personalIdx = 17;
-    const std::size_t dependencyCountIdx = 18;
-    const std::size_t depenedenciesTextIdx = 19;
-
-    NSBM::constant_string_view listQueryBase = "SELECT TaskID FROM Tasks ";
+    static constexpr std::size_t MaxTaskIDsPerSelect = 500;
 };
 
 using TaskModel_shp = std::shared_ptr<TaskModel>;
@@ -0,0 +1,56 @@
+#ifndef TASKRECORD_H_
+#define TASKRECORD_H_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/*
+ * The column data of one row of the Tasks table and nothing else, no connection
+ * details, error messages or change tracking. Large task lists that are only read
+ * or written as a whole (reports, scheduling) should use TaskRecord and
+ * TaskGateway rather than TaskModel, a record is about 120 bytes plus the
+ * description where a TaskModel carries its database state with every task.
+ *
+ * The IDs are the INT UNSIGNED columns of the table, a TaskID of 0 means the task
+ * is not in the database yet. The optional members are the columns that can be
+ * NULL. The status is the value of TaskModel::TaskStatus.
+ */
+struct TaskRecord
+{
+    std::string description;
+    double percentageComplete = 0.0;
+    double actualEffortHours = 0.0;
+    std::uint32_t taskID = 0;
+    std::uint32_t createdBy = 0;
+    std::uint32_t assignedTo = 0;
+    std::uint32_t estimatedEffortHours = 0;
+    std::uint32_t schedulePriorityGroup = 0;
+    std::uint32_t priorityInGroup = 0;
+    std::optional<std::uint32_t> parentTaskID;
+    std::chrono::year_month_day createdOn;
+    std::chrono::year_month_day requiredDelivery;
+    std::chrono::year_month_day scheduledStart;
+    std::optional<std::chrono::year_month_day> actualStart;
+    std::optional<std::chrono::year_month_day> estimatedCompletion;
+    std::optional<std::chrono::year_month_day> completed;
+    std::optional<std::uint8_t> status;
+    bool personal = false;
+
+    static constexpr std::size_t MinimumDescriptionLength = 10;
+
+/*
+ * The same rules as the required fields of TaskModel.
+ */
+    bool hasRequiredValues() const noexcept
+    {
+        return description.length() >= MinimumDescriptionLength && createdBy != 0 && assignedTo != 0 &&
+            estimatedEffortHours != 0 && schedulePriorityGroup != 0 && createdOn.ok() && requiredDelivery.ok() &&
+            scheduledStart.ok();
+    };
+
+    bool operator==(const TaskRecord& other) const = default;
+};
+
+#endif // TASKRECORD_H_
@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TASKTABLE_HAS_AVX2_KERNELS 1
+#endif
+#include <span>
+#include <stdexcept>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include "TaskRecord.h"
+#include "TaskTable.h"
+#include <vector>
+
+static constexpr std::size_t RowsPerWord = 64;
+
+static std::size_t wordCount(std::size_t rowCount) noexcept
+{
+    return (rowCount + RowsPerWord - 1) / RowsPerWord;
+}
+
+/*
+ * The scalar filters are also used for the rows after the last full word of the
+ * AVX2 filters. Comparing the offsets from low as unsigned values checks both
+ * ends of the range with one compare, the caller guarantees low <= high.
+ */
+template<typename ValueType>
+static void scalarSelectRange(std::span<const ValueType> values, ValueType low, ValueType high,
+    std::span<std::uint64_t> words) noexcept
+{
+    using UnsignedType = std::make_unsigned_t<ValueType>;
+    const UnsignedType width = static_cast<UnsignedType>(static_cast<UnsignedType>(high) - static_cast<UnsignedType>(low));
+
+    for (std::size_t wordIdx = 0; wordIdx < words.size(); ++wordIdx)
+    {
+        std::size_t firstRow = wordIdx * RowsPerWord;
+        std::size_t rowsInWord = std::min(RowsPerWord, values.size() - firstRow);
+        std::uint64_t word = 0;
+        for (std::size_t bit = 0; bit < rowsInWord; ++bit)
+        {
+            UnsignedType offset = static_cast<UnsignedType>(
+                static_cast<UnsignedType>(values[firstRow + bit]) - static_cast<UnsignedType>(low));
+            word |= static_cast<std::uint64_t>(offset <= width) << bit;
+        }
+        words[wordIdx] = word;
+    }
+}
+
+#ifdef TASKTABLE_HAS_AVX2_KERNELS
+/*
+ * Eight rows per compare, a row is in the range when it is neither below low nor
+ * above high.
+ */
+__attribute__((target("avx2")))
+static void avx2SelectRange(std::span<const std::int32_t> values, std::int32_t low, std::int32_t high,
+    std::span<std::uint64_t> words) noexcept
+{
+    const __m256i lowValues = _mm256_set1_epi32(low);
+    const __m256i highValues = _mm256_set1_epi32(high);
+    const std::size_t fullWords = values.size() / RowsPerWord;
+
+    for (std::size_t wordIdx = 0; wordIdx < fullWords; ++wordIdx)
+    {
+        const std::int32_t* block = values.data() + wordIdx * RowsPerWord;
+        std::uint64_t word = 0;
+        for (std::size_t lane = 0; lane < RowsPerWord; lane += 8)
+        {
+            __m256i rowValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + lane));
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lowValues, rowValues),
+                _mm256_cmpgt_epi32(rowValues, highValues));
+            std::uint32_t outsideBits = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(outside)));
+            word |= static_cast<std::uint64_t>(~outsideBits & 0xFFu) << lane;
+        }
+        words[wordIdx] = word;
+    }
+
+    scalarSelectRange(values.subspan(fullWords * RowsPerWord), low, high, words.subspan(fullWords));
+}
+
+/*
+ * Thirty two rows per compare, a byte is in the range when clamping it to the
+ * range doesn't change it.
+ */
+__attribute__((target("avx2")))
+static void avx2SelectRange(std::span<const std::uint8_t> values, std::uint8_t low, std::uint8_t high,
+    std::span<std::uint64_t> words) noexcept
+{
+    const __m256i lowValues = _mm256_set1_epi8(static_cast<char>(low));
+    const __m256i highValues = _mm256_set1_epi8(static_cast<char>(high));
+    const std::size_t fullWords = values.size() / RowsPerWord;
+
+    for (std::size_t wordIdx = 0; wordIdx < fullWords; ++wordIdx)
+    {
+        const std::uint8_t* block = values.data() + wordIdx * RowsPerWord;
+        std::uint64_t word = 0;
+        for (std::size_t lane = 0; lane < RowsPerWord; lane += 32)
+        {
+            __m256i rowValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + lane));
+            __m256i inside = _mm256_and_si256(
+                _mm256_cmpeq_epi8(_mm256_max_epu8(rowValues, lowValues), rowValues),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(rowValues, highValues), rowValues));
+            word |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(inside))) << lane;
+        }
+        words[wordIdx] = word;
+    }
+
+    scalarSelectRange(values.subspan(fullWords * RowsPerWord), low, high, words.subspan(fullWords));
+}
+#endif
+
+static bool processorHasAvx2() noexcept
+{
+#ifdef TASKTABLE_HAS_AVX2_KERNELS
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+static std::atomic<bool> simdFiltersEnabled{processorHasAvx2()};
+
+template<typename ValueType>
+static void selectRowsInRange(std::span<const ValueType> values, ValueType low, ValueType high,
+    std::span<std::uint64_t> words) noexcept
+{
+#ifdef TASKTABLE_HAS_AVX2_KERNELS
+    if (simdFiltersEnabled.load(std::memory_order_relaxed))
+    {
+        avx2SelectRange(values, low, high, words);
+        return;
+    }
+#endif
+    scalarSelectRange(values, low, high, words);
+}
+
+TaskSelection::TaskSelection(std::size_t rowCountIn)
+: bitWords(wordCount(rowCountIn), 0),
+  rows{rowCountIn}
+{
+}
+
+std::size_t TaskSelection::selectedCount() const noexcept
+{
+    std::size_t count = 0;
+    for (std::uint64_t word: bitWords)
+    {
+        count += static_cast<std::size_t>(std::popcount(word));
+    }
+
+    return count;
+}
+
+std::vector<std::size_t> TaskSelection::selectedRows() const
+{
+    std::vector<std::size_t> selected;
+    selected.reserve(selectedCount());
+
+    for (std::size_t wordIdx = 0; wordIdx < bitWords.size(); ++wordIdx)
+    {
+        for (std::uint64_t word = bitWords[wordIdx]; word != 0; word &= word - 1)
+        {
+            selected.push_back(wordIdx * RowsPerWord + static_cast<std::size_t>(std::countr_zero(word)));
+        }
+    }
+
+    return selected;
+}
+
+TaskSelection& TaskSelection::operator&=(const TaskSelection& other) noexcept
+{
+    std::size_t sharedWords = std::min(bitWords.size(), other.bitWords.size());
+    for (std::size_t wordIdx = 0; wordIdx < sharedWords; ++wordIdx)
+    {
+        bitWords[wordIdx] &= other.bitWords[wordIdx];
+    }
+    std::fill(bitWords.begin() + sharedWords, bitWords.end(), 0);
+
+    return *this;
+}
+
+TaskSelection& TaskSelection::operator|=(const TaskSelection& other) noexcept
+{
+    std::size_t sharedWords = std::min(bitWords.size(), other.bitWords.size());
+    for (std::size_t wordIdx = 0; wordIdx < sharedWords; ++wordIdx)
+    {
+        bitWords[wordIdx] |= other.bitWords[wordIdx];
+    }
+
+    return *this;
+}
+
+TaskTable::TaskTable(const TaskListValues& tasks)
+{
+    reserve(tasks.size());
+    for (const TaskModel_shp& task: tasks)
+    {
+        append(*task);
+    }
+}
+
+TaskTable::TaskTable(std::span<const TaskRecord> tasks)
+{
+    reserve(tasks.size());
+    for (const TaskRecord& task: tasks)
+    {
+        append(task);
+    }
+}
+
+void TaskTable::reserve(std::size_t rowCount)
+{
+    taskIDs.reserve(rowCount);
+    statuses.reserve(rowCount);
+    scheduledStarts.reserve(rowCount);
+    requiredDeliveries.reserve(rowCount);
+    schedulePriorityGroups.reserve(rowCount);
+    priorityInGroups.reserve(rowCount);
+}
+
+void TaskTable::clear() noexcept
+{
+    taskIDs.clear();
+    statuses.clear();
+    scheduledStarts.clear();
+    requiredDeliveries.clear();
+    schedulePriorityGroups.clear();
+    priorityInGroups.clear();
+}
+
+void TaskTable::append(const TaskModel& task)
+{
+    append(task.getTaskID(), task.getStatus(), task.getScheduledStart(), task.getDueDate(), task.getPriorityGroup(),
+        task.getPriority());
+}
+
+void TaskTable::append(const TaskRecord& task)
+{
+    TaskModel::TaskStatus status = task.status.has_value()?
+        static_cast<TaskModel::TaskStatus>(task.status.value()) : TaskModel::TaskStatus::Not_Started;
+
+    append(task.taskID, status, task.scheduledStart, task.requiredDelivery, task.schedulePriorityGroup,
+        task.priorityInGroup);
+}
+
+void TaskTable::append(std::size_t taskID, TaskModel::TaskStatus status, std::chrono::year_month_day scheduledStart,
+    std::chrono::year_month_day requiredDelivery, unsigned int schedulePriorityGroup, unsigned int priorityInGroup)
+{
+    taskIDs.push_back(static_cast<std::uint32_t>(taskID));
+    statuses.push_back(static_cast<std::uint8_t>(status));
+    scheduledStarts.push_back(dayNumber(scheduledStart));
+    requiredDeliveries.push_back(dayNumber(requiredDelivery));
+    schedulePriorityGroups.push_back(static_cast<std::int32_t>(schedulePriorityGroup));
+    priorityInGroups.push_back(static_cast<std::int32_t>(priorityInGroup));
+}
+
+std::vector<std::size_t> TaskTable::selectedTaskIDs(const TaskSelection& selection) const
+{
+    std::vector<std::size_t> selected;
+    selected.reserve(selection.selectedCount());
+
+    for (std::size_t row: selection.selectedRows())
+    {
+        selected.push_back(taskIDs[row]);
+    }
+
+    return selected;
+}
+
+/*
+ * Both ends of the range are inclusive, an empty range selects nothing.
+ */
+TaskSelection TaskTable::selectRange(Column column, std::int32_t low, std::int32_t high) const
+{
+    TaskSelection selection(size());
+    if (low > high)
+    {
+        return selection;
+    }
+
+    if (column == Column::Status)
+    {
+        if (high < 0 || low > UINT8_MAX)
+        {
+            return selection;
+        }
+        selectRowsInRange<std::uint8_t>(statuses, static_cast<std::uint8_t>(std::max(low, 0)),
+            static_cast<std::uint8_t>(std::min<std::int32_t>(high, UINT8_MAX)), selection.words());
+    }
+    else
+    {
+        selectRowsInRange<std::int32_t>(int32Column(column), low, high, selection.words());
+    }
+
+    return selection;
+}
+
+TaskSelection TaskTable::selectStatus(TaskModel::TaskStatus status) const
+{
+    return selectEqual(Column::Status, static_cast<std::int32_t>(status));
+}
+
+TaskSelection TaskTable::selectScheduledStartBetween(std::chrono::year_month_day first,
+    std::chrono::year_month_day last) const
+{
+    return selectRange(Column::ScheduledStart, dayNumber(first), dayNumber(last));
+}
+
+TaskSelection TaskTable::selectRequiredDeliveryBetween(std::chrono::year_month_day first,
+    std::chrono::year_month_day last) const
+{
+    return selectRange(Column::RequiredDelivery, dayNumber(first), dayNumber(last));
+}
+
+bool TaskTable::simdAvailable() noexcept
+{
+    return simdFiltersEnabled.load(std::memory_order_relaxed);
+}
+
+void TaskTable::useSimd(bool enabled) noexcept
+{
+    simdFiltersEnabled.store(enabled && processorHasAvx2(), std::memory_order_relaxed);
+}
+
+std::int32_t TaskTable::dayNumber(std::chrono::year_month_day date) noexcept
+{
+    return static_cast<std::int32_t>(std::chrono::sys_days(date).time_since_epoch().count());
+}
+
+const std::vector<std::int32_t>& TaskTable::int32Column(Column column) const
+{
+    switch (column)
+    {
+        case Column::ScheduledStart:
+            return scheduledStarts;
+        case Column::RequiredDelivery:
+            return requiredDeliveries;
+        case Column::SchedulePriorityGroup:
+            return schedulePriorityGroups;
+        case Column::PriorityInGroup:
+            return priorityInGroups;
+        default:
+            throw std::logic_error("TaskTable::int32Column called for a column that isn't 32 bits");
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef TASKTABLE_H_
+#define TASKTABLE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include "TaskList.h"
+#include "TaskModel.h"
+#include "TaskRecord.h"
+#include <vector>
+
+/*
+ * One bit per row of a TaskTable, bit n of word n / 64 is row n. The bits past the
+ * last row are always 0 so selections can be combined and counted a word at a time.
+ */
+class TaskSelection
+{
+public:
+    TaskSelection() = default;
+    explicit TaskSelection(std::size_t rowCountIn);
+    ~TaskSelection() = default;
+
+    std::size_t rowCount() const noexcept { return rows; };
+    std::size_t selectedCount() const noexcept;
+    bool isSelected(std::size_t row) const noexcept { return (bitWords[row / 64] >> (row % 64)) & 1; };
+    std::vector<std::size_t> selectedRows() const;
+
+    TaskSelection& operator&=(const TaskSelection& other) noexcept;
+    TaskSelection& operator|=(const TaskSelection& other) noexcept;
+    TaskSelection operator&(const TaskSelection& other) const { return TaskSelection(*this) &= other; };
+    TaskSelection operator|(const TaskSelection& other) const { return TaskSelection(*this) |= other; };
+    bool operator==(const TaskSelection& other) const = default;
+
+    std::span<std::uint64_t> words() noexcept { return bitWords; };
+    std::span<const std::uint64_t> words() const noexcept { return bitWords; };
+
+private:
+    std::vector<std::uint64_t> bitWords;
+    std::size_t rows = 0;
+};
+
+/*
+ * The scheduling columns of a set of tasks stored as one array per column, for
+ * planning views that filter the same tasks many times. Dates are stored as the
+ * day count of std::chrono::sys_days and the status as the value of
+ * TaskModel::TaskStatus, a NULL status is stored as Not_Started as
+ * TaskModel::getStatus() reports it.
+ *
+ * Each filter evaluates an inclusive range over one column and returns a
+ * TaskSelection, filters on several columns are combined with & and |. The
+ * filters use AVX2 when the processor supports it and a scalar loop otherwise,
+ * both produce the same selection.
+ */
+class TaskTable
+{
+public:
+    enum class Column { Status, ScheduledStart, RequiredDelivery, SchedulePriorityGroup, PriorityInGroup };
+
+    TaskTable() = default;
+    explicit TaskTable(const TaskListValues& tasks);
+    explicit TaskTable(std::span<const TaskRecord> tasks);
+    ~TaskTable() = default;
+
+    void reserve(std::size_t rowCount);
+    void clear() noexcept;
+    void append(const TaskModel& task);
+    void append(const TaskRecord& task);
+    void append(std::size_t taskID, TaskModel::TaskStatus status, std::chrono::year_month_day scheduledStart,
+        std::chrono::year_month_day requiredDelivery, unsigned int schedulePriorityGroup, unsigned int priorityInGroup);
+
+    std::size_t size() const noexcept { return taskIDs.size(); };
+    std::size_t taskIDAt(std::size_t row) const noexcept { return taskIDs[row]; };
+    std::vector<std::size_t> selectedTaskIDs(const TaskSelection& selection) const;
+
+    TaskSelection selectRange(Column column, std::int32_t low, std::int32_t high) const;
+    TaskSelection selectEqual(Column column, std::int32_t value) const { return selectRange(column, value, value); };
+    TaskSelection selectStatus(TaskModel::TaskStatus status) const;
+    TaskSelection selectScheduledStartBetween(std::chrono::year_month_day first,
+        std::chrono::year_month_day last) const;
+    TaskSelection selectRequiredDeliveryBetween(std::chrono::year_month_day first,
+        std::chrono::year_month_day last) const;
+
+/*
+ * False forces the scalar filters, for testing and benchmarking the fallback.
+ */
+    static bool simdAvailable() noexcept;
+    static void useSimd(bool enabled) noexcept;
+
+private:
+    static std::int32_t dayNumber(std::chrono::year_month_day date) noexcept;
+    const std::vector<std::int32_t>& int32Column(Column column) const;
+
+    std::vector<std::uint32_t> taskIDs;
+    std::vector<std::uint8_t> statuses;
+    std::vector<std::int32_t> scheduledStarts;
+    std::vector<std::int32_t> requiredDeliveries;
+    std::vector<std::int32_t> schedulePriorityGroups;
+    std::vector<std::int32_t> priorityInGroups;
+};
+
+#endif // TASKTABLE_H_
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include "TaskModel.h"
+#include "TaskTree.h"
+#include <vector>
+
+TaskTree::TaskTree(std::size_t rootTaskIDIn, std::vector<TaskModel_shp> subtreeTasks, std::size_t maxDepthIn)
+: rootTaskID{rootTaskIDIn}, tasks{std::move(subtreeTasks)}
+{
+    std::erase(tasks, nullptr);
+    std::ranges::sort(tasks, {}, &TaskModel::getTaskID);
+    auto duplicates = std::ranges::unique(tasks, {}, &TaskModel::getTaskID);
+    tasks.erase(duplicates.begin(), duplicates.end());
+
+    const std::size_t maxDepth = std::min(maxDepthIn, MaxDepthLimit);
+    bool allReachable = linkTasks();
+    depthLimitReached = std::ranges::any_of(depths,
+        [maxDepth](std::size_t depth) { return depth != NoParent && depth > maxDepth; });
+
+    if (!allReachable || depthLimitReached)
+    {
+/*
+ * Tasks whose ParentTask chain doesn't reach the root are not part of the tree, the
+ * level below maxDepth was only loaded to find out whether the tree goes deeper.
+ */
+        std::vector<TaskModel_shp> kept;
+        for (std::size_t taskIdx = 0; taskIdx < tasks.size(); ++taskIdx)
+        {
+            if (depths[taskIdx] != NoParent && depths[taskIdx] <= maxDepth)
+            {
+                kept.push_back(tasks[taskIdx]);
+            }
+        }
+        tasks = std::move(kept);
+        linkTasks();
+    }
+}
+
+TaskModel_shp TaskTree::findTask(std::size_t taskID) const
+{
+    std::optional<std::size_t> taskIdx = findIndex(taskID);
+
+    return taskIdx.has_value()? tasks[*taskIdx] : nullptr;
+}
+
+std::vector<TaskModel_shp> TaskTree::getChildren(std::size_t taskID) const
+{
+    std::vector<TaskModel_shp> children;
+
+    if (std::optional<std::size_t> taskIdx = findIndex(taskID); taskIdx.has_value())
+    {
+        for (std::size_t childIdx = childOffsets[*taskIdx]; childIdx < childOffsets[*taskIdx + 1]; ++childIdx)
+        {
+            children.push_back(tasks[childIndexes[childIdx]]);
+        }
+    }
+
+    return children;
+}
+
+std::optional<std::size_t> TaskTree::getDepth(std::size_t taskID) const
+{
+    std::optional<std::size_t> taskIdx = findIndex(taskID);
+
+    return taskIdx.has_value()? std::optional<std::size_t>(depths[*taskIdx]) : std::nullopt;
+}
+
+std::vector<TaskModel_shp> TaskTree::getSubtreeDepthFirst(std::size_t taskID) const
+{
+    std::vector<TaskModel_shp> subtree;
+    std::optional<std::size_t> startIdx = findIndex(taskID);
+    if (!startIdx.has_value())
+    {
+        return subtree;
+    }
+
+    std::vector<std::size_t> pending{*startIdx};
+    while (!pending.empty())
+    {
+        std::size_t taskIdx = pending.back();
+        pending.pop_back();
+        subtree.push_back(tasks[taskIdx]);
+
+/*
+ * Pushed in reverse so the children come off the stack in TaskID order.
+ */
+        for (std::size_t childIdx = childOffsets[taskIdx + 1]; childIdx > childOffsets[taskIdx]; --childIdx)
+        {
+            pending.push_back(childIndexes[childIdx - 1]);
+        }
+    }
+
+    return subtree;
+}
+
+std::optional<std::size_t> TaskTree::findIndex(std::size_t taskID) const
+{
+    auto found = std::ranges::lower_bound(taskIDs, taskID);
+    if (found == taskIDs.end() || *found != taskID)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<std::size_t>(found - taskIDs.begin());
+}
+
+/*
+ * Returns false when some of the tasks can't be reached from the root, their depth
+ * is left as NoParent.
+ */
+bool TaskTree::linkTasks()
+{
+    taskIDs.clear();
+    std::ranges::transform(tasks, std::back_inserter(taskIDs), &TaskModel::getTaskID);
+
+    std::optional<std::size_t> foundRoot = findIndex(rootTaskID);
+    if (!foundRoot.has_value())
+    {
+        tasks.clear();
+        taskIDs.clear();
+        depths.clear();
+        childOffsets.assign(1, 0);
+        childIndexes.clear();
+        return true;
+    }
+    rootIdx = *foundRoot;
+
+    std::vector<std::size_t> parentIndexes(tasks.size(), NoParent);
+    for (std::size_t taskIdx = 0; taskIdx < tasks.size(); ++taskIdx)
+    {
+        if (taskIdx != rootIdx)
+        {
+            parentIndexes[taskIdx] = findIndex(tasks[taskIdx]->getParentTaskID()).value_or(NoParent);
+        }
+    }
+    buildChildOffsets(parentIndexes);
+
+    depths.assign(tasks.size(), NoParent);
+    depths[rootIdx] = 0;
+    std::size_t reachedCount = 1;
+    std::deque<std::size_t> pending{rootIdx};
+    while (!pending.empty())
+    {
+        std::size_t taskIdx = pending.front();
+        pending.pop_front();
+        for (std::size_t childIdx = childOffsets[taskIdx]; childIdx < childOffsets[taskIdx + 1]; ++childIdx)
+        {
+            std::size_t child = childIndexes[childIdx];
+            if (depths[child] == NoParent)
+            {
+                depths[child] = depths[taskIdx] + 1;
+                ++reachedCount;
+                pending.push_back(child);
+            }
+        }
+    }
+
+    return reachedCount == tasks.size();
+}
+
+/*
+ * Counting sort of the tasks by parent, the children of each parent stay in
+ * TaskID order because the tasks are in TaskID order.
+ */
+void TaskTree::buildChildOffsets(const std::vector<std::size_t>& parentIndexes)
+{
+    childOffsets.assign(tasks.size() + 1, 0);
+    for (std::size_t parentIdx: parentIndexes)
+    {
+        if (parentIdx != NoParent)
+        {
+            ++childOffsets[parentIdx + 1];
+        }
+    }
+    for (std::size_t taskIdx = 0; taskIdx < tasks.size(); ++taskIdx)
+    {
+        childOffsets[taskIdx + 1] += childOffsets[taskIdx];
+    }
+
+    childIndexes.resize(childOffsets.back());
+    std::vector<std::size_t> nextChild(childOffsets.begin(), childOffsets.end() - 1);
+    for (std::size_t taskIdx = 0; taskIdx < tasks.size(); ++taskIdx)
+    {
+        if (parentIndexes[taskIdx] != NoParent)
+        {
+            childIndexes[nextChild[parentIndexes[taskIdx]]++] = taskIdx;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef TASKTREE_H_
+#define TASKTREE_H_
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include "TaskModel.h"
+#include <vector>
+
+/*
+ * A task and all of its descendants, loaded by TaskList::getTaskTree() with one
+ * query. The children of each task are stored in one array with an offset per
+ * task, the tasks and the children of each task are in TaskID order.
+ *
+ * The query loads one level more than the depth limit, the tree drops that level
+ * and only keeps whether it had any tasks.
+ *
+ * The tree is built from the ParentTask of each task. Only tasks reachable from
+ * the root are kept and each task is visited once, so a ParentTask cycle in the
+ * database can't loop, the root never has a parent in the tree.
+ */
+class TaskTree
+{
+public:
+    static constexpr std::size_t DefaultMaxDepth = 64;
+    static constexpr std::size_t MaxDepthLimit = 256;
+
+    TaskTree() = default;
+    TaskTree(std::size_t rootTaskIDIn, std::vector<TaskModel_shp> subtreeTasks, std::size_t maxDepthIn = DefaultMaxDepth);
+    ~TaskTree() = default;
+
+    std::size_t getRootTaskID() const noexcept { return rootTaskID; };
+    TaskModel_shp getRoot() const { return tasks.empty()? nullptr : tasks[rootIdx]; };
+    std::size_t size() const noexcept { return tasks.size(); };
+    bool empty() const noexcept { return tasks.empty(); };
+    bool contains(std::size_t taskID) const { return findIndex(taskID).has_value(); };
+    std::span<const TaskModel_shp> getTasks() const noexcept { return tasks; };
+
+    TaskModel_shp findTask(std::size_t taskID) const;
+    std::vector<TaskModel_shp> getChildren(std::size_t taskID) const;
+/*
+ * The root is at depth 0, std::nullopt when the task is not in the tree.
+ */
+    std::optional<std::size_t> getDepth(std::size_t taskID) const;
+/*
+ * The task and its descendants in depth first order, each task before its children.
+ */
+    std::vector<TaskModel_shp> getSubtreeDepthFirst(std::size_t taskID) const;
+/*
+ * True when the tree goes deeper than the depth limit, the tasks below the limit
+ * are not in the tree.
+ */
+    bool reachedDepthLimit() const noexcept { return depthLimitReached; };
+
+private:
+    std::optional<std::size_t> findIndex(std::size_t taskID) const;
+    bool linkTasks();
+    void buildChildOffsets(const std::vector<std::size_t>& parentIndexes);
+
+    static constexpr std::size_t NoParent = static_cast<std::size_t>(-1);
+
+    std::size_t rootTaskID = 0;
+    std::size_t rootIdx = 0;
+    bool depthLimitReached = false;
+    std::vector<TaskModel_shp> tasks;
+    std::vector<std::size_t> taskIDs;
+    std::vector<std::size_t> depths;
+    std::vector<std::size_t> childOffsets;
+    std::vector<std::size_t> childIndexes;
+};
+
+#endif // TASKTREE_H_
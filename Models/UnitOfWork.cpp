@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include <cstdint>
+#include "DBConnectionPool.h"
+#include <exception>
+#include <format>
+#include <iostream>
+#include <map>
+#include "ModelDBInterface.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "UnitOfWork.h"
+#include <vector>
+
+UnitOfWork::UnitOfWork()
+: CoreDBInterface()
+{
+}
+
+void UnitOfWork::registerModel(ModelPtr model, BeforeFlush beforeFlush)
+{
+    auto alreadyRegistered = std::find_if(registeredModels.begin(), registeredModels.end(),
+        [&model](const RegisteredModel& registered) { return registered.model == model; });
+
+    if (alreadyRegistered == registeredModels.end())
+    {
+        registeredModels.push_back(RegisteredModel{model, beforeFlush});
+    }
+}
+
+bool UnitOfWork::commit()
+{
+    return waitForCoRoutine(asyncCommit()).has_value();
+}
+
+NSBA::awaitable<CoreDBInterface::DBResult<void>> UnitOfWork::asyncCommit()
+{
+    co_await coRoutinePrepareForRunQuery();
+
+    if (registeredModels.empty())
+    {
+        co_return DBResult<void>{};
+    }
+
+    std::vector<RegisteredModel*> flushQueue;
+    for (RegisteredModel& registered: registeredModels)
+    {
+        flushQueue.push_back(&registered);
+    }
+    std::stable_sort(flushQueue.begin(), flushQueue.end(),
+        [](const RegisteredModel* a, const RegisteredModel* b)
+        { return a->model->getFlushOrder() < b->model->getFlushOrder(); });
+
+    DBConnectionPool& pool = DBConnectionPool::getPool(dbConnectionParameters);
+    NSBM::pooled_connection conn = co_await pool.asyncGetConnection();
+    std::vector<ModelPtr> insertedModels;
+    std::string failure;
+    bool connectionLost = false;
+
+    try
+    {
+        NSBM::format_options formatOptions = conn->format_opts().value();
+        NSBM::results statementResult;
+        co_await conn->async_execute("START TRANSACTION", statementResult);
+        std::uint64_t autoIncrementStep = co_await coRoutineGetAutoIncrementStep(conn.get());
+
+        for (auto groupStart = flushQueue.begin(); groupStart != flushQueue.end(); )
+        {
+            unsigned int flushOrder = (*groupStart)->model->getFlushOrder();
+            auto groupEnd = std::find_if(groupStart, flushQueue.end(),
+                [flushOrder](const RegisteredModel* registered)
+                { return registered->model->getFlushOrder() != flushOrder; });
+
+            std::vector<RegisteredModel*> flushGroup(groupStart, groupEnd);
+            co_await flushModels(conn.get(), formatOptions, flushGroup, autoIncrementStep, insertedModels);
+            groupStart = groupEnd;
+        }
+
+        co_await conn->async_execute("COMMIT", statementResult);
+    }
+
+    catch (const NSBM::error_with_diagnostics& e)
+    {
+        connectionLost = DBConnectionPool::isConnectionLevelError(e.code());
+        failure = std::format("In UnitOfWork.commit() : {}", e.what());
+    }
+
+    catch (const std::exception& e)
+    {
+        failure = std::format("In UnitOfWork.commit() : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_await pool.asyncAbandonTransaction(conn, connectionLost);
+
+        for (ModelPtr model: insertedModels)
+        {
+            model->forgetBulkInsert();
+        }
+
+        co_return operationFailed(failure);
+    }
+
+    pool.returnWithoutReset(conn);
+
+    for (RegisteredModel& registered: registeredModels)
+    {
+        registered.model->invalidateCachedRow();
+        registered.model->clearRelatedRowChanges();
+        registered.model->clearModified();
+    }
+    registeredModels.clear();
+
+    co_return DBResult<void>{};
+}
+
+NSBA::awaitable<std::uint64_t> UnitOfWork::coRoutineGetAutoIncrementStep(NSBM::any_connection& transactionConn)
+{
+    NSBM::results stepResult;
+    co_await transactionConn.async_execute("SELECT CAST(@@SESSION.auto_increment_increment AS UNSIGNED)",
+        stepResult);
+
+    co_return stepResult.rows().at(0).at(0).as_uint64();
+}
+
+/*
+ * All the models of one flush order, the new models are inserted with multi-row
+ * INSERT statements, one set of statements for each model type, and the modified
+ * models are updated, then the related rows of all the models are written. All of
+ * the statements are sent as pipelines, any failed statement throws.
+ */
+NSBA::awaitable<void> UnitOfWork::flushModels(NSBM::any_connection& conn, const NSBM::format_options& formatOptions,
+    std::vector<RegisteredModel*>& flushGroup, std::uint64_t autoIncrementStep, std::vector<ModelPtr>& insertedModels)
+{
+    std::map<std::string_view, std::vector<ModelPtr>> newModelsByType;
+    std::vector<std::string> updateStatements;
+
+    for (RegisteredModel* registered: flushGroup)
+    {
+        if (registered->beforeFlush)
+        {
+            registered->beforeFlush();
+        }
+
+        ModelPtr model = registered->model;
+        if (!model->isModified())
+        {
+            continue;
+        }
+
+        if (model->isInDataBase())
+        {
+            if (model->hasDirtyColumns())
+            {
+                updateStatements.push_back(model->formatBatchUpdateStatement(formatOptions));
+            }
+            continue;
+        }
+
+        if (!model->hasRequiredValues())
+        {
+            model->reportMissingFields();
+            throw std::runtime_error(std::format("{} is missing required values!\n{}",
+                model->getModelName(), model->getAllErrorMessages()));
+        }
+        newModelsByType[model->getBulkInsertPrefix()].push_back(model);
+    }
+
+    std::vector<ModelDBInterface::BulkInsertStatements> bulkInsertsByType;
+    std::vector<std::string> statements;
+
+    for (const auto& typeModels: newModelsByType)
+    {
+        bulkInsertsByType.push_back(ModelDBInterface::formatBulkInsertStatements(formatOptions,
+            typeModels.second));
+        statements.insert(statements.end(), bulkInsertsByType.back().statements.begin(),
+            bulkInsertsByType.back().statements.end());
+    }
+    statements.insert(statements.end(), updateStatements.begin(), updateStatements.end());
+
+    std::vector<std::uint64_t> lastInsertIDs = co_await runPipelines(conn, statements);
+
+    std::size_t statementIdx = 0;
+    std::size_t typeIdx = 0;
+    for (const auto& typeModels: newModelsByType)
+    {
+        const std::vector<ModelPtr>& newModels = typeModels.second;
+        const ModelDBInterface::BulkInsertStatements& bulkInserts = bulkInsertsByType[typeIdx++];
+        std::vector<std::uint64_t> firstInsertedIDs(lastInsertIDs.begin() + statementIdx,
+            lastInsertIDs.begin() + statementIdx + bulkInserts.statements.size());
+        statementIdx += bulkInserts.statements.size();
+
+        ModelDBInterface::assignBulkInsertKeys(newModels, bulkInserts, firstInsertedIDs, autoIncrementStep);
+        insertedModels.insert(insertedModels.end(), newModels.begin(), newModels.end());
+    }
+
+    // The related rows of the new models need the primary keys assigned above.
+    std::vector<std::string> relatedStatements;
+    for (RegisteredModel* registered: flushGroup)
+    {
+        if (registered->model->isInDataBase() && registered->model->hasRelatedRowChanges())
+        {
+            std::vector<std::string> modelStatements = registered->model->formatRelatedRowStatements(
+                formatOptions);
+            relatedStatements.insert(relatedStatements.end(), modelStatements.begin(), modelStatements.end());
+        }
+    }
+
+    co_await runPipelines(conn, relatedStatements);
+}
+
+/*
+ * Returns the last insert ID of each statement.
+ */
+NSBA::awaitable<std::vector<std::uint64_t>> UnitOfWork::runPipelines(NSBM::any_connection& conn,
+    const std::vector<std::string>& statements)
+{
+    NSBM::pipeline_request request;
+    std::vector<NSBM::stage_response> responses;
+    std::vector<std::uint64_t> lastInsertIDs;
+
+    for (std::size_t chunkStart = 0; chunkStart < statements.size(); chunkStart += MaxStatementsPerPipeline)
+    {
+        std::size_t chunkEnd = std::min(chunkStart + MaxStatementsPerPipeline, statements.size());
+
+        request.clear();
+        for (std::size_t statementIdx = chunkStart; statementIdx < chunkEnd; ++statementIdx)
+        {
+            if (verboseOutput)
+            {
+                std::clog << "Unit of work: \n\t" << statements[statementIdx] << "\n";
+            }
+            request.add_execute(statements[statementIdx]);
+        }
+
+        co_await conn.async_run_pipeline(request, responses);
+
+        for (const NSBM::stage_response& response: responses)
+        {
+            lastInsertIDs.push_back(response.get_results().last_insert_id());
+        }
+    }
+
+    co_return lastInsertIDs;
+}
+
@@ -0,0 +1,70 @@
+#ifndef UNITOFWORK_H_
+#define UNITOFWORK_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "ModelDBInterface.h"
+#include <string>
+#include <vector>
+
+/*
+ * Saves many models in one transaction on one pooled connection.
+ *
+ * Models are registered with the unit of work and nothing is written until
+ * commit(). The models are then written in flush order (users before tasks), the
+ * new models of each flush order with multi-row INSERT statements and the modified
+ * models with UPDATE statements, all the statements of a flush order are sent in
+ * one pipeline. If any statement fails the whole transaction is rolled back and
+ * the models are left as they were before commit().
+ *
+ * A model that refers to another model of the same unit of work by primary key
+ * can register a function that is called after the lower flush orders have been
+ * inserted and before the model itself is written, for example to set the
+ * creator of a task to the user that was just inserted.
+ */
+class UnitOfWork : public CoreDBInterface
+{
+public:
+    using ModelPtr = std::shared_ptr<ModelDBInterface>;
+    using BeforeFlush = std::function<void(void)>;
+
+    UnitOfWork();
+    virtual ~UnitOfWork() = default;
+
+    void registerModel(ModelPtr model, BeforeFlush beforeFlush = BeforeFlush());
+    bool commit();
+    NSBA::awaitable<DBResult<void>> asyncCommit();
+/*
+ * Forget the registered models without writing them.
+ */
+    void rollback() noexcept { registeredModels.clear(); };
+    std::size_t getRegisteredCount() const noexcept { return registeredModels.size(); };
+
+private:
+    struct RegisteredModel
+    {
+        ModelPtr model;
+        BeforeFlush beforeFlush;
+    };
+
+/*
+ * The auto-increment step of the session that runs the inserts, it must be read on
+ * the connection of the transaction since another pooled connection's session can
+ * use a different step.
+ */
+    static NSBA::awaitable<std::uint64_t> coRoutineGetAutoIncrementStep(NSBM::any_connection& transactionConn);
+    NSBA::awaitable<void> flushModels(NSBM::any_connection& conn, const NSBM::format_options& formatOptions,
+        std::vector<RegisteredModel*>& flushGroup, std::uint64_t autoIncrementStep,
+        std::vector<ModelPtr>& insertedModels);
+    NSBA::awaitable<std::vector<std::uint64_t>> runPipelines(NSBM::any_connection& conn,
+        const std::vector<std::string>& statements);
+
+    std::vector<RegisteredModel> registeredModels;
+};
+
+#endif // UNITOFWORK_H_
+
@@ -0,0 +1,193 @@
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include <cstdint>
+#include "DBExecutionContext.h"
+#include <exception>
+#include <format>
+#include "ModelRowCache.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include "UserGateway.h"
+#include "UserModel.h"
+#include "UserRecord.h"
+#include <utility>
+
+UserGateway::UserGateway()
+: pool{DBConnectionPool::getPool(DBConnectionPool::connectionParametersFromProgramOptions())}
+{
+}
+
+UserGateway::DBResult<UserRecord> UserGateway::selectByUserID(std::size_t userID) const
+{
+    return DBExecutionContext::instance().runAndWait(asyncSelectByUserID(userID));
+}
+
+UserGateway::DBResult<UserRecord> UserGateway::selectByLoginName(std::string_view loginName) const
+{
+    return DBExecutionContext::instance().runAndWait(asyncSelectByLoginName(std::string(loginName)));
+}
+
+UserGateway::DBResult<void> UserGateway::insert(UserRecord& user) const
+{
+    DBResult<std::uint32_t> userID = DBExecutionContext::instance().runAndWait(asyncInsert(user));
+    if (!userID.has_value())
+    {
+        return std::unexpected(userID.error());
+    }
+
+    user.userID = userID.value();
+    return {};
+}
+
+UserGateway::DBResult<void> UserGateway::update(const UserRecord& user) const
+{
+    return DBExecutionContext::instance().runAndWait(asyncUpdate(user));
+}
+
+NSBA::awaitable<UserGateway::DBResult<UserRecord>> UserGateway::asyncSelectByUserID(std::size_t userID) const
+{
+    ModelRowCache& rowCache = UserModel::userRowCache();
+    std::optional<UserRecord> user;
+    std::string failure;
+
+    try
+    {
+        if (std::optional<NSBM::row> cachedRow = rowCache.find(userID); cachedRow.has_value())
+        {
+            user = UserModel::recordFromRow(cachedRow.value());
+        }
+        else
+        {
+            std::uint64_t cacheGeneration = rowCache.getGeneration();
+            CoreDBInterface::PreparedQuery selectQuery = UserModel::buildPreparedSelectByUserID(userID);
+            NSBM::results localResult = co_await pool.asyncExecutePrepared(selectQuery.statementKey,
+                selectQuery.sqlText, selectQuery.parameters);
+            if (!localResult.rows().empty())
+            {
+                user = UserModel::recordFromRow(localResult.rows()[0]);
+                rowCache.store(userID, localResult.rows()[0], cacheGeneration);
+            }
+        }
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In UserGateway::selectByUserID({}) : {}", userID, e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    if (!user.has_value())
+    {
+        co_return std::unexpected(std::format("User {} not found!", userID));
+    }
+
+    co_return std::move(user.value());
+}
+
+NSBA::awaitable<UserGateway::DBResult<UserRecord>> UserGateway::asyncSelectByLoginName(std::string loginName) const
+{
+    std::optional<UserRecord> user;
+    std::string failure;
+
+    try
+    {
+        std::uint64_t cacheGeneration = UserModel::userRowCache().getGeneration();
+        CoreDBInterface::PreparedQuery selectQuery = UserModel::buildPreparedSelectByLoginName(loginName);
+        NSBM::results localResult = co_await pool.asyncExecutePrepared(selectQuery.statementKey,
+            selectQuery.sqlText, selectQuery.parameters);
+        if (!localResult.rows().empty())
+        {
+            user = UserModel::recordFromRow(localResult.rows()[0]);
+            UserModel::userRowCache().store(user->userID, localResult.rows()[0], cacheGeneration);
+        }
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In UserGateway::selectByLoginName({}) : {}", loginName, e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    if (!user.has_value())
+    {
+        co_return std::unexpected(std::format("User {} not found!", loginName));
+    }
+
+    co_return std::move(user.value());
+}
+
+NSBA::awaitable<UserGateway::DBResult<std::uint32_t>> UserGateway::asyncInsert(UserRecord user) const
+{
+    if (user.userID != 0)
+    {
+        co_return std::unexpected(std::format("User {} already in Database, use Update!", user.userID));
+    }
+
+    if (!user.hasRequiredValues())
+    {
+        co_return std::unexpected(std::format("User {} is missing required values!", user.loginName));
+    }
+
+    std::uint32_t userID = 0;
+    std::string failure;
+
+    try
+    {
+        CoreDBInterface::PreparedQuery insertQuery = UserModel::buildRecordInsert(std::move(user));
+        NSBM::results localResult = co_await pool.asyncExecutePrepared(insertQuery.statementKey,
+            insertQuery.sqlText, insertQuery.parameters);
+        userID = static_cast<std::uint32_t>(localResult.last_insert_id());
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In UserGateway::insert : {}", e.what());
+    }
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    co_return userID;
+}
+
+NSBA::awaitable<UserGateway::DBResult<void>> UserGateway::asyncUpdate(UserRecord user) const
+{
+    if (user.userID == 0)
+    {
+        co_return std::unexpected(std::string("User not in Database, use Insert!"));
+    }
+
+    std::uint32_t userID = user.userID;
+    std::string failure;
+
+    try
+    {
+        CoreDBInterface::PreparedQuery updateQuery = UserModel::buildRecordUpdate(std::move(user));
+        co_await pool.asyncExecutePrepared(updateQuery.statementKey, updateQuery.sqlText, updateQuery.parameters);
+    }
+
+    catch(const std::exception& e)
+    {
+        failure = std::format("In UserGateway::update({}) : {}", userID, e.what());
+    }
+
+    UserModel::userRowCache().invalidate(userID);
+
+    if (!failure.empty())
+    {
+        co_return std::unexpected(failure);
+    }
+
+    co_return DBResult<void>{};
+}
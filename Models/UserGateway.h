@@ -0,0 +1,40 @@
+#ifndef USERGATEWAY_H_
+#define USERGATEWAY_H_
+
+#include <boost/asio.hpp>
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include "DBConnectionPool.h"
+#include <string>
+#include <string_view>
+#include "UserRecord.h"
+
+/*
+ * Loads and saves UserRecords, see TaskGateway. The SQL, the prepared statements
+ * and the row codec are UserModel's, and the rows share the UserProfile row cache
+ * with UserModel.
+ */
+class UserGateway
+{
+public:
+    template<typename ValueType>
+    using DBResult = CoreDBInterface::DBResult<ValueType>;
+
+    UserGateway();
+    ~UserGateway() = default;
+
+    DBResult<UserRecord> selectByUserID(std::size_t userID) const;
+    DBResult<UserRecord> selectByLoginName(std::string_view loginName) const;
+    DBResult<void> insert(UserRecord& user) const;
+    DBResult<void> update(const UserRecord& user) const;
+
+    NSBA::awaitable<DBResult<UserRecord>> asyncSelectByUserID(std::size_t userID) const;
+    NSBA::awaitable<DBResult<UserRecord>> asyncSelectByLoginName(std::string loginName) const;
+    NSBA::awaitable<DBResult<std::uint32_t>> asyncInsert(UserRecord user) const;
+    NSBA::awaitable<DBResult<void>> asyncUpdate(UserRecord user) const;
+
+private:
+    DBConnectionPool& pool;
+};
+
+#endif // USERGATEWAY_H_
@@ -1,6 +1,8 @@
 #include <format>
 #include <iostream>
+#include "ListCursor.h"
 #include "ListDBInterface.h"
+#include "ListPage.h"
 #include "UserList.h"
 #include "UserModel.h"
 
@@ -10,35 +12,45 @@ UserList::UserList()
 
 }
 
-UserListValues UserList::getAllUsers()
+UserListValues UserList::getAllUsers(const ListPage& page)
 {
-    prepareForRunQueryAsync();
-    UserListValues allUsers;
+    UserListResult allUsers = waitForCoRoutine(asyncGetAllUsers(page));
 
-    try
+    return allUsers.has_value()? std::move(allUsers.value()) : UserListValues();
+}
+
+ListPage UserList::nextPage(const ListPage& page, const UserListValues& pageUsers)
+{
+    ListPage next = page;
+    if (!pageUsers.empty())
+    {
+        next.afterKey = pageUsers.back()->getUserID();
+    }
+
+    return next;
+}
+
+ListCursor<UserModel> UserList::getAllUsersCursor()
+{
+    return ListCursor<UserModel>(queryGenerator.formatGetAllUsersQuery(getFormatOptions()));
+}
+
+NSBA::awaitable<UserList::UserListResult> UserList::asyncGetAllUsers(ListPage page)
+{
+    errorMessages.clear();
+
+    co_await coRoutineFormatFirstQuery([&](const NSBM::format_options& formatOptions)
+        { return queryGenerator.formatGetAllUsersQuery(formatOptions, page); });
+    if (firstFormattedQuery.empty())
     {
-        firstFormattedQuery = queryGenerator.formatGetAllUsersQuery();
-        if (firstFormattedQuery.empty())
-        {
-            appendErrorMessage(std::format("Formatting getAllUser query string failed {}",
-                queryGenerator.getAllErrorMessages()));
-            return allUsers;
-        }
-        if (runFirstQuery())
-        {
-            for (auto userID: primaryKeyResults)
-            {
-                UserModel_shp newUser = std::make_shared<UserModel>(UserModel());
-                newUser->selectByUserID(userID);
-                allUsers.push_back(newUser);
-            }
-        }
+        co_return operationFailed(std::format("Formatting getAllUser query string failed {}",
+            queryGenerator.getAllErrorMessages()));
     }
 
-    catch(const std::exception& e)
+    if (co_await coRoutineRunFirstQuery())
     {
-        appendErrorMessage(std::format("In UserList::getAllUsers : {}", e.what()));
+        co_return std::move(listResults);
     }
-    
-    return allUsers;
+
+    co_return UserListValues();
 }
@@ -3,7 +3,9 @@
 
 #include <format>
 #include <iostream>
+#include "ListCursor.h"
 #include "ListDBInterface.h"
+#include "ListPage.h"
 #include "UserModel.h"
 
 using UserListValues = std::vector<UserModel_shp>;
@@ -11,9 +13,20 @@ using UserListValues = std::vector<UserModel_shp>;
 class UserList : public ListDBInterface<UserModel>
 {
 public:
+    using UserListResult = DBResult<UserListValues>;
+
     UserList();
     virtual ~UserList() = default;
-    UserListValues getAllUsers();
+    UserListValues getAllUsers(const ListPage& page = {});
+    NSBA::awaitable<UserListResult> asyncGetAllUsers(ListPage page = {});
+/*
+ * The page after the users of a page, the users are in UserID order.
+ */
+    static ListPage nextPage(const ListPage& page, const UserListValues& pageUsers);
+/*
+ * Streams all the users rather than loading them in one result.
+ */
+    ListCursor<UserModel> getAllUsersCursor();
 
 private:
 
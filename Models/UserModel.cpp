@@ -1,16 +1,39 @@
+#include <array>
 #include <exception>
 #include <chrono>
 #include "commonUtilities.h"
+#include <cstdint>
+#include "DelimitedTextCodec.h"
 #include <format>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include "QueryTemplate.h"
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include "UserModel.h"
 #include <vector>
 
+/*
+ * Prepared statement text.
+ */
+static constexpr std::string_view insertUserPrefixSQL =
+    schemaStatement<UserModel::schema, SchemaStatement::InsertPrefix>;
+static constexpr std::string_view insertUserSQL = schemaStatement<UserModel::schema, SchemaStatement::Insert>;
+static constexpr std::string_view updateAllUserSQL = schemaStatement<UserModel::schema, SchemaStatement::UpdateAll>;
+
+/*
+ * The text protocol queries, see QueryTemplate.
+ */
+static constexpr std::string_view selectUsersSQL = schemaStatement<UserModel::schema, SchemaStatement::Select>;
+static const QueryTemplate selectByEmailQuery(selectUsersSQL, " WHERE EmailAddress = {}");
+static const QueryTemplate selectByLoginAndPasswordQuery(selectUsersSQL, " WHERE LoginName = {} AND HashedPassWord = {}");
+static const QueryTemplate selectByFullNameQuery(selectUsersSQL,
+    " WHERE LastName = {} AND FirstName = {} AND MiddleInitial = {}");
+static const QueryTemplate selectAllUsersQuery(selectUsersSQL, "");
+
 UserModel::UserModel()
 : ModelDBInterface("User")
 {
@@ -62,74 +85,62 @@ void UserModel::createLoginBasedOnUserName(
 
 void UserModel::setLastName(const std::string &lastNameP)
 {
-    modified = true;
-    lastName = lastNameP;
+    setColumnValue(lastName, lastNameP, LastNameIdx);
 }
 
 void UserModel::setFirstName(const std::string &firstNameP)
 {
-    modified = true;
-    firstName = firstNameP;
+    setColumnValue(firstName, firstNameP, FirstNameIdx);
 }
 
 void UserModel::setMiddleInitial(const std::string &middleinitP)
 {
-    modified = true;
-    middleInitial = middleinitP;
+    setColumnValue(middleInitial, middleinitP, MiddleInitialIdx);
 }
 
 void UserModel::setEmail(const std::string &emailP)
 {
-    modified = true;
-    email = emailP;
+    setColumnValue(email, emailP, EmailAddressIdx);
 }
 
 void UserModel::setLoginName(const std::string &loginNameP)
 {
-    modified = true;
-    loginName = loginNameP;
+    setColumnValue(loginName, loginNameP, LoginNameIdx);
 }
 
 void UserModel::setPassword(const std::string &passwordP)
 {
-    modified = true;
-    password = passwordP;
+    setColumnValue(password, passwordP, PasswordIdx);
 }
 
 void UserModel::setStartTime(const std::string &startTime)
 {
-    modified = true;
-    preferences.startTime = startTime;
+    setColumnValue(preferences.startTime, startTime, PreferencesIdx);
 }
 
 void UserModel::setEndTime(const std::string &endTime)
 {
-    modified = true;
-    preferences.endTime = endTime;
+    setColumnValue(preferences.endTime, endTime, PreferencesIdx);
 }
 
 void UserModel::setPriorityInSchedule(bool inSchedule)
 {
-    modified = true;
-    preferences.includePriorityInSchedule = inSchedule;
+    setColumnValue(preferences.includePriorityInSchedule, inSchedule, PreferencesIdx);
 }
 
 void UserModel::setMinorPriorityInSchedule(bool inSchedule)
 {
-    modified = true;
-    preferences.includeMinorPriorityInSchedule = inSchedule;
+    setColumnValue(preferences.includeMinorPriorityInSchedule, inSchedule, PreferencesIdx);
 }
 
 void UserModel::setUsingLettersForMaorPriority(bool usingLetters)
 {
-    modified = true;
-    preferences.userLetterForMajorPriority = usingLetters;
+    setColumnValue(preferences.userLetterForMajorPriority, usingLetters, PreferencesIdx);
 }
 
 void UserModel::setSeparatingPriorityWithDot(bool separate)
 {
-    modified = true;
-    preferences.separateMajorAndMinorWithDot = separate;
+    setColumnValue(preferences.separateMajorAndMinorWithDot, separate, PreferencesIdx);
 }
 
 void UserModel::setUserID(std::size_t UserID)
@@ -140,37 +151,35 @@ void UserModel::setUserID(std::size_t UserID)
 
 void UserModel::setCreationDate(std::chrono::year_month_day dateIn)
 {
-    modified = true;
-    created = dateIn;
+    setColumnValue(created, dateIn, UserAddedIdx);
 }
 
 void UserModel::setLastLogin(std::chrono::system_clock::time_point dateAndTime)
 {
-    modified = true;
-    lastLogin = dateAndTime;
+    setColumnValue(lastLogin, dateAndTime, LastLoginIdx);
 }
 
-bool UserModel::isMissingLastName()
+bool UserModel::isMissingLastName() const
 {
     return (lastName.empty() || lastName.length() < minNameLenght);
 }
 
-bool UserModel::isMissingFirstName()
+bool UserModel::isMissingFirstName() const
 {
     return (firstName.empty() || firstName.length() < minNameLenght);
 }
 
-bool UserModel::isMissingLoginName()
+bool UserModel::isMissingLoginName() const
 {
     return (loginName.empty() || loginName.length() < (2 * minNameLenght));
 }
 
-bool UserModel::isMissingPassword()
+bool UserModel::isMissingPassword() const
 {
-    return (password.empty() || password.length() < minPasswordLenght);;
+    return (password.empty() || password.length() < minPasswordLenght);
 }
 
-bool UserModel::isMissingDateAdded()
+bool UserModel::isMissingDateAdded() const
 {
     return !created.ok();
 }
@@ -183,104 +192,212 @@ bool UserModel::diffUser(UserModel &other)
         created == other.created);
 }
 
-void UserModel::initRequiredFields()
+std::string UserModel::formatInsertStatement()
 {
-    missingRequiredFieldsTests.push_back({std::bind(&UserModel::isMissingLastName, this), "Last Name"});
-    missingRequiredFieldsTests.push_back({std::bind(&UserModel::isMissingFirstName, this), "First Name"});
-    missingRequiredFieldsTests.push_back({std::bind(&UserModel::isMissingLoginName, this), "Login Name"});
-    missingRequiredFieldsTests.push_back({std::bind(&UserModel::isMissingPassword, this), "Password"});
-    missingRequiredFieldsTests.push_back({std::bind(&UserModel::isMissingDateAdded, this), "Date Added"});
+    return std::string(insertUserPrefixSQL) + formatBulkInsertValues(format_opts.value());
 }
 
-std::string UserModel::formatInsertStatement()
+std::string_view UserModel::getBulkInsertPrefix() const
 {
-    initFormatOptions();
+    return insertUserPrefixSQL;
+}
 
-    std::string insertStatement = NSBM::format_sql(format_opts.value(),
-        "INSERT INTO UserProfile (LastName, FirstName, MiddleInitial, EmailAddress, LoginName, "
-        "HashedPassWord, UserAdded, LastLogin, Preferences) VALUES ({0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8})",
-        lastName, firstName, middleInitial, email, loginName, password,
-        stdchronoDateToBoostMySQLDate(created),
-        optionalDateTimeConversion(lastLogin), buildPreferenceText()
-    );
+/*
+ * Shared with UserGateway, which reads and writes the same rows.
+ */
+ModelRowCache& UserModel::userRowCache()
+{
+    static ModelRowCache userRows("UserProfile", programOptions.modelCacheSize);
+    return userRows;
+}
 
-    return insertStatement;
+CoreDBInterface::PreparedQuery UserModel::buildPreparedInsert()
+{
+    return buildRecordInsert(toRecord());
 }
 
-std::string UserModel::formatUpdateStatement()
+CoreDBInterface::PreparedQuery UserModel::buildRecordInsert(UserRecord user)
 {
-    initFormatOptions();
+    return PreparedQuery{"UserProfile.insert", insertUserSQL, recordColumnParameters(std::move(user))};
+}
+
+/*
+ * Writes every column, the record does not track which columns changed.
+ */
+CoreDBInterface::PreparedQuery UserModel::buildRecordUpdate(UserRecord user)
+{
+    std::uint32_t userID = user.userID;
+    PreparedQuery updateQuery{"UserProfile.updateAll", updateAllUserSQL, recordColumnParameters(std::move(user))};
+    updateQuery.parameters.emplace_back(userID);
 
-    std::string updateStatement = NSBM::format_sql(format_opts.value(),
-        "UPDATE UserProfile SET"
-            " UserProfile.LastName = {0},"
-            " UserProfile.FirstName = {1},"
-            " UserProfile.MiddleInitial = {2},"
-            " UserProfile.EmailAddress = {3}," 
-            " UserProfile.LoginName = {4},"
-            " UserProfile.HashedPassWord = {5},"
-            " UserProfile.Preferences = {6},"
-            " UserProfile.LastLogin = {7}"
-        " WHERE UserProfile.UserID = {8}",
-            lastName, firstName,middleInitial, email, loginName,password, 
-            buildPreferenceText(), optionalDateTimeConversion(lastLogin), primaryKey);
-        
-    return updateStatement;
+    return updateQuery;
 }
 
-std::string UserModel::formatSelectStatement()
+UserRecord UserModel::toRecord() noexcept
 {
-    initFormatOptions();
+    UserRecord user;
 
-    NSBM::format_context fctx(format_opts.value());
-    NSBM::format_sql_to(fctx, baseQuery);
-    NSBM::format_sql_to(fctx, " WHERE UserID = {}", primaryKey);
+    user.userID = static_cast<std::uint32_t>(primaryKey);
+    user.lastName = lastName;
+    user.firstName = firstName;
+    user.middleInitial = middleInitial;
+    user.emailAddress = email;
+    user.loginName = loginName;
+    user.password = password;
+    user.preferences = buildPreferenceText();
+    user.lastLogin = lastLogin;
+    user.userAdded = created;
 
-    return std::move(fctx).get().value();
+    return user;
 }
 
+/*
+ * Each value is placed by its schema column index.
+ */
+std::vector<NSBM::field> UserModel::recordColumnParameters(UserRecord user)
+{
+    std::vector<NSBM::field> parameters(schema.parameterCount);
+
+    parameters[schema.parameterIdx(LastNameIdx)] = NSBM::field(std::move(user.lastName));
+    parameters[schema.parameterIdx(FirstNameIdx)] = NSBM::field(std::move(user.firstName));
+    parameters[schema.parameterIdx(MiddleInitialIdx)] = NSBM::field(std::move(user.middleInitial));
+    parameters[schema.parameterIdx(EmailAddressIdx)] = NSBM::field(std::move(user.emailAddress));
+    parameters[schema.parameterIdx(LoginNameIdx)] = NSBM::field(std::move(user.loginName));
+    parameters[schema.parameterIdx(PasswordIdx)] = NSBM::field(std::move(user.password));
+    parameters[schema.parameterIdx(UserAddedIdx)] = NSBM::field(stdchronoDateToBoostMySQLDate(user.userAdded));
+    parameters[schema.parameterIdx(LastLoginIdx)] = optionalToField(optionalDateTimeConversion(user.lastLogin));
+    parameters[schema.parameterIdx(PreferencesIdx)] = NSBM::field(std::move(user.preferences));
+
+    return parameters;
+}
+
+ModelDBInterface::UpdateColumns UserModel::getUpdateColumns() const
+{
+    return UpdateColumns{schema.tableName, schema.columnNames};
+}
+
+CoreDBInterface::PreparedQuery UserModel::buildPreparedSelect()
+{
+    return buildPreparedSelectByUserID(primaryKey);
+}
+
+CoreDBInterface::PreparedQuery UserModel::buildPreparedSelectByUserID(std::size_t userID)
+{
+    return PreparedQuery{"UserProfile.selectByUserID", getSelectByUserIDSQL(), {NSBM::field(userID)}};
+}
+
+CoreDBInterface::PreparedQuery UserModel::buildPreparedSelectByLoginName(std::string_view loginName)
+{
+    return PreparedQuery{"UserProfile.selectByLoginName", getSelectByLoginNameSQL(),
+        {NSBM::field(std::string(loginName))}};
+}
+
+/*
+ * One allocation for the returned text, the flags are written with std::to_chars.
+ */
 std::string UserModel::buildPreferenceText() noexcept
 {
-    std::vector<std::string> preferences;
+    using TextCodec = DelimitedTextCodec<std::string_view>;
+    using FlagCodec = DelimitedTextCodec<int>;
+
+    std::string preferenceText;
+    preferenceText.reserve(preferences.startTime.size() + preferences.endTime.size() + 2 * PreferenceFieldCount);
 
-    preferences.push_back(getStartTime());
-    preferences.push_back(getEndTime());
-    preferences.push_back(std::to_string(static_cast<int>(isPriorityInSchedule())));
-    preferences.push_back(std::to_string(static_cast<int>(isMinorPriorityInSchedule())));
-    preferences.push_back(std::to_string(static_cast<int>(isUsingLettersForMaorPriority())));
-    preferences.push_back(std::to_string(static_cast<int>(isSeparatingPriorityWithDot())));
+    TextCodec::appendField(preferenceText, preferences.startTime, delimiter);
+    TextCodec::appendField(preferenceText, preferences.endTime, delimiter);
+    FlagCodec::appendField(preferenceText, static_cast<int>(isPriorityInSchedule()), delimiter);
+    FlagCodec::appendField(preferenceText, static_cast<int>(isMinorPriorityInSchedule()), delimiter);
+    FlagCodec::appendField(preferenceText, static_cast<int>(isUsingLettersForMaorPriority()), delimiter);
+    FlagCodec::appendField(preferenceText, static_cast<int>(isSeparatingPriorityWithDot()), delimiter);
 
-    return implodeTextField(preferences);
+    return preferenceText;
 }
 
-void UserModel::processResultRow(NSBM::row_view rv)
+/*
+ * The column indexes come from the schema and the row is checked against it, so
+ * the columns are accessed without bounds checks.
+ */
+UserRecord UserModel::recordFromRow(NSBM::row_view rv)
 {
-    primaryKey = rv.at(UserIdIdx).as_uint64();
-    lastName = rv.at(LastNameIdx).as_string();
-    firstName = rv.at(FirstNameIdx).as_string();
-    middleInitial = rv.at(MiddleInitialIdx).as_string();
-    email = rv.at(EmailAddressIdx).as_string();
-    loginName = rv.at(LoginNameIdx).as_string();
-    password = rv.at(PasswordIdx).as_string();
-    created = (boostMysqlDateToChronoDate(rv.at(UserAddedIdx).as_date()));
-    if (!rv.at(LastLoginIdx).is_null())
+    if (rv.size() != schema.columnCount)
     {
-        lastLogin = boostMysqlDateTimeToChronoTimePoint(rv.at(LastLoginIdx).as_datetime());
+        throw std::runtime_error(std::format("User row has {} columns, expected {}", rv.size(), schema.columnCount));
     }
-    std::string preferences = rv.at(PreferencesIdx).as_string();
-    parsePrefenceText(preferences);
+
+    UserRecord user;
+
+    user.userID = static_cast<std::uint32_t>(rv[UserIdIdx].as_uint64());
+    user.lastName = rv[LastNameIdx].as_string();
+    user.firstName = rv[FirstNameIdx].as_string();
+    user.loginName = rv[LoginNameIdx].as_string();
+    user.password = rv[PasswordIdx].as_string();
+    user.userAdded = boostMysqlDateToChronoDate(rv[UserAddedIdx].as_date());
+
+    if (!rv[MiddleInitialIdx].is_null())
+    {
+        user.middleInitial = rv[MiddleInitialIdx].as_string();
+    }
+
+    if (!rv[EmailAddressIdx].is_null())
+    {
+        user.emailAddress = rv[EmailAddressIdx].as_string();
+    }
+
+    if (!rv[LastLoginIdx].is_null())
+    {
+        user.lastLogin = boostMysqlDateTimeToChronoTimePoint(rv[LastLoginIdx].as_datetime());
+    }
+
+    if (!rv[PreferencesIdx].is_null())
+    {
+        user.preferences = rv[PreferencesIdx].as_string();
+    }
+
+    return user;
 }
 
-void UserModel::parsePrefenceText(std::string preferences) noexcept
+void UserModel::processResultRow(NSBM::row_view rv)
 {
-    std::vector<std::string> subfields = explodeTextField(preferences);
+    UserRecord user = recordFromRow(rv);
+
+    primaryKey = user.userID;
+    lastName = std::move(user.lastName);
+    firstName = std::move(user.firstName);
+    middleInitial = std::move(user.middleInitial);
+    email = std::move(user.emailAddress);
+    loginName = std::move(user.loginName);
+    password = std::move(user.password);
+    created = user.userAdded;
+    lastLogin = user.lastLogin;
+    parsePrefenceText(user.preferences);
+}
+
+/*
+ * The subfields are views into the row, only the two times are copied into the model.
+ */
+void UserModel::parsePrefenceText(std::string_view preferenceText) noexcept
+{
+    std::array<std::string_view, PreferenceFieldCount> subfields;
+    DelimitedTextCodec<std::string_view> preferenceCodec(delimiter);
+
+    auto fieldCount = preferenceCodec.decode(preferenceText, subfields);
+    if (!fieldCount.has_value() || fieldCount.value() != PreferenceFieldCount)
+    {
+        appendErrorMessage(std::format("In UserModel::parsePrefenceText : invalid preferences \"{}\"", preferenceText));
+        return;
+    }
 
-    setStartTime(subfields[PrefDayStartIdx]);
-    setEndTime(subfields[PrefDayEndIdx]);
-    setPriorityInSchedule(std::stoi(subfields[PrefMajorPriorityIdx]));
-    setMinorPriorityInSchedule(std::stoi(subfields[PrefMinorPriorityIdx]));
-    setUsingLettersForMaorPriority(std::stoi(subfields[PrefUsingLetterIdx]));
-    setSeparatingPriorityWithDot(std::stoi(subfields[PrefUsingDotIdx]));
+    auto flagValue = [&subfields](std::size_t subfieldIdx)
+    {
+        return DelimitedTextCodec<int>::parseField(subfields[subfieldIdx]).value_or(0) != 0;
+    };
+
+    preferences.startTime = subfields[PrefDayStartIdx];
+    preferences.endTime = subfields[PrefDayEndIdx];
+    preferences.includePriorityInSchedule = flagValue(PrefMajorPriorityIdx);
+    preferences.includeMinorPriorityInSchedule = flagValue(PrefMinorPriorityIdx);
+    preferences.userLetterForMajorPriority = flagValue(PrefUsingLetterIdx);
+    preferences.separateMajorAndMinorWithDot = flagValue(PrefUsingDotIdx);
     clearModified();
 }
 
@@ -290,11 +407,7 @@ bool UserModel::selectByLoginName(const std::string_view &loginName)
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE LoginName = {}", loginName);
-
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+        NSBM::results localResult = runPreparedQueryAsync(buildPreparedSelectByLoginName(loginName));
 
         return processResult(localResult);
     }
@@ -308,15 +421,11 @@ bool UserModel::selectByLoginName(const std::string_view &loginName)
 
 bool UserModel::selectByEmail(const std::string_view &emailAddress)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE EmailAddress = {}", emailAddress);
-
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+        NSBM::results localResult = runQueryAsync(formatSelectByEmail(getFormatOptions(), emailAddress));
 
         return processResult(localResult);
     }
@@ -330,15 +439,12 @@ bool UserModel::selectByEmail(const std::string_view &emailAddress)
 
 bool UserModel::selectByLoginAndPassword(const std::string_view &loginName, const std::string_view &password)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE LoginName = {} AND HashedPassWord = {}", loginName, password);
-
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+        NSBM::results localResult = runQueryAsync(formatSelectByLoginAndPassword(getFormatOptions(),
+            loginName, password));
 
         return processResult(localResult);
     }
@@ -352,15 +458,12 @@ bool UserModel::selectByLoginAndPassword(const std::string_view &loginName, cons
 
 bool UserModel::selectByFullName(const std::string_view &lastName, const std::string_view &firstName, const std::string_view &middleI)
 {
-    prepareForRunQueryAsync();
+    errorMessages.clear();
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE LastName = {} AND FirstName = {} AND MiddleInitial = {}", lastName, firstName, middleI);
-
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+        NSBM::results localResult = runQueryAsync(formatSelectByFullName(getFormatOptions(),
+            lastName, firstName, middleI));
 
         return processResult(localResult);
     }
@@ -372,43 +475,64 @@ bool UserModel::selectByFullName(const std::string_view &lastName, const std::st
     }
 }
 
-std::string UserModel::formatGetAllUsersQuery()
+std::string UserModel::formatSelectByEmail(const NSBM::format_options& formatOptions, std::string_view emailAddress)
 {
-    prepareForRunQueryAsync();
+    return selectByEmailQuery.format(formatOptions, emailAddress);
+}
+
+std::string UserModel::formatSelectByLoginAndPassword(const NSBM::format_options& formatOptions,
+    std::string_view loginName, std::string_view password)
+{
+    return selectByLoginAndPasswordQuery.format(formatOptions, loginName, password);
+}
+
+std::string UserModel::formatSelectByFullName(const NSBM::format_options& formatOptions, std::string_view lastName,
+    std::string_view firstName, std::string_view middleI)
+{
+    return selectByFullNameQuery.format(formatOptions, lastName, firstName, middleI);
+}
+
+std::string_view UserModel::getSelectByUserIDSQL()
+{
+    static const std::string selectByUserIDSQL = std::string(baseQuery.get()) + " WHERE UserID = ?";
+
+    return selectByUserIDSQL;
+}
+
+std::string_view UserModel::getSelectByLoginNameSQL()
+{
+    static const std::string selectByLoginNameSQL = std::string(baseQuery.get()) + " WHERE LoginName = ?";
+
+    return selectByLoginNameSQL;
+}
+
+std::string UserModel::formatGetAllUsersQuery(const NSBM::format_options& formatOptions, const ListPage& page)
+{
+    errorMessages.clear();
 
     try
     {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, "SELECT UserID FROM UserProfile ");
+        NSBM::format_context fctx = selectAllUsersQuery.start(formatOptions);
+        appendListPage(fctx, page, false);
 
-        return std::move(fctx).get().value();
+        return QueryTemplate::finish(std::move(fctx));
     }
 
     catch(const std::exception& e)
     {
         appendErrorMessage(std::format("In UserModel::formatGetAllUsersQuery : {}", e.what()));
-        return std::string();
+        return {};
     }
 }
 
 bool UserModel::selectByUserID(std::size_t UserID)
 {
-    prepareForRunQueryAsync();
-
-    try
-    {
-        NSBM::format_context fctx(format_opts.value());
-        NSBM::format_sql_to(fctx, baseQuery);
-        NSBM::format_sql_to(fctx, " WHERE UserID = {}", UserID);
-
-        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+    return waitForCoRoutine(asyncSelectByUserID(UserID)).has_value();
+}
 
-        return processResult(localResult);
-    }
+NSBA::awaitable<CoreDBInterface::DBResult<void>> UserModel::asyncSelectByUserID(std::size_t UserID)
+{
+    errorMessages.clear();
 
-    catch(const std::exception& e)
-    {
-        appendErrorMessage(std::format("In UserModel::selectByUserID : {}", e.what()));
-        return false;
-    }
+    co_return co_await coRoutineSelectSingleModel(buildPreparedSelectByUserID(UserID), "selectByUserID", UserID);
 }
@@ -1,15 +1,18 @@
 #ifndef USERMODEL_H_
 #define USERMODEL_H_
 
+#include <array>
 #include <chrono>
 #include "commonUtilities.h"
 #include <format>
-#include <functional>
 #include <iostream>
 #include <memory>
 #include "ModelDBInterface.h"
+#include "ModelSchema.h"
 #include <optional>
 #include <string>
+#include <string_view>
+#include "UserRecord.h"
 #include <vector>
 
 class UserModel : public ModelDBInterface
@@ -73,18 +76,43 @@ public:
     bool selectByLoginAndPassword(const std::string_view& loginName, const std::string_view& password);
     bool selectByFullName(const std::string_view& lastName, const std::string_view& firstName,
         const std::string_view& middleI);
-    std::string formatGetAllUsersQuery();
+    std::string formatGetAllUsersQuery(const NSBM::format_options& formatOptions, const ListPage& page = {});
+/*
+ * The statements of the selects above, these throw if a value can't be formatted.
+ * The selects by UserID and by LoginName are prepared, each has one parameter.
+ */
+    static std::string formatSelectByEmail(const NSBM::format_options& formatOptions, std::string_view emailAddress);
+    static std::string formatSelectByLoginAndPassword(const NSBM::format_options& formatOptions,
+        std::string_view loginName, std::string_view password);
+    static std::string formatSelectByFullName(const NSBM::format_options& formatOptions, std::string_view lastName,
+        std::string_view firstName, std::string_view middleI);
+    static std::string_view getSelectByUserIDSQL();
+    static std::string_view getSelectByLoginNameSQL();
+/*
+ * The one codec of a UserProfile row, see TaskModel::recordFromRow().
+ */
+    static UserRecord recordFromRow(NSBM::row_view rv);
+    static std::vector<NSBM::field> recordColumnParameters(UserRecord user);
+    static PreparedQuery buildPreparedSelectByUserID(std::size_t userID);
+    static PreparedQuery buildPreparedSelectByLoginName(std::string_view loginName);
+    static PreparedQuery buildRecordInsert(UserRecord user);
+    static PreparedQuery buildRecordUpdate(UserRecord user);
     bool selectByUserID(std::size_t UserID);
+    NSBA::awaitable<DBResult<void>> asyncSelectByUserID(std::size_t UserID);
+    std::string_view getBulkInsertPrefix() const override;
+    ModelRowCache& getRowCache() const override { return userRowCache(); };
+    static ModelRowCache& userRowCache();
 
 /*
  * Required fields.
  */
-    bool isMissingLastName();
-    bool isMissingFirstName();
-    bool isMissingLoginName();
-    bool isMissingPassword();
-    bool isMissingDateAdded();
-    void initRequiredFields() override;
+    bool isMissingLastName() const;
+    bool isMissingFirstName() const;
+    bool isMissingLoginName() const;
+    bool isMissingPassword() const;
+    bool isMissingDateAdded() const;
+    bool hasRequiredValues() const override { return requiredFieldsPresent(requiredFields); };
+    void reportMissingFields() noexcept override { reportMissingRequiredFields(requiredFields); };
 
     bool operator==(UserModel& other)
     {
@@ -113,16 +141,29 @@ public:
         return os;
     };
 
+/*
+ * The select, insert and update statements and the column indexes are generated
+ * from the schema, the column order is the order of the schema's column names.
+ */
+    static constexpr ModelSchema<10> schema{"UserProfile",
+        {
+            "UserID", "LastName", "FirstName", "MiddleInitial", "EmailAddress", "LoginName", "HashedPassWord",
+            "UserAdded", "LastLogin", "Preferences"
+        }
+    };
+
 private:
     void createLoginBasedOnUserName(const std::string& lastName,
         const std::string& firstName,const std::string& middleInitial);
     bool diffUser(UserModel& other);
     std::string formatInsertStatement() override;
-    std::string formatUpdateStatement() override;
-    std::string formatSelectStatement() override;
+    PreparedQuery buildPreparedInsert() override;
+    UpdateColumns getUpdateColumns() const override;
+    PreparedQuery buildPreparedSelect() override;
+    UserRecord toRecord() noexcept;
 
     std::string buildPreferenceText() noexcept;
-    void parsePrefenceText(std::string preferences) noexcept;
+    void parsePrefenceText(std::string_view preferenceText) noexcept;
     void processResultRow(NSBM::row_view rv) override;
     
     std::string lastName;
@@ -135,36 +176,38 @@ private:
     std::chrono::year_month_day created;
     std::optional<std::chrono::system_clock::time_point> lastLogin;
 
-    const std::size_t minNameLenght = 2;
-    const std::size_t minPasswordLenght = 8;
+    static constexpr std::size_t minNameLenght = 2;
+    static constexpr std::size_t minPasswordLenght = 8;
 
 private:
-/*
- * The indexes below are based on the following select statement, maintain this order.
- * baseQuery could be SELECT * FROM UserProfile, but this way the order of the columns
- * returned are known.
- */
-    NSBM::constant_string_view baseQuery = 
-        "SELECT UserID, LastName, FirstName, MiddleInitial, EmailAddress, LoginName, "
-            "HashedPassWord, UserAdded, LastLogin, Preferences FROM UserProfile ";
-
-    const std::size_t UserIdIdx = 0;
-    const std::size_t LastNameIdx = 1;
-    const std::size_t FirstNameIdx = 2;
-    const std::size_t MiddleInitialIdx = 3;
-    const std::size_t EmailAddressIdx = 4;
-    const std::size_t LoginNameIdx = 5;
-    const std::size_t PasswordIdx = 6;
-    const std::size_t UserAddedIdx = 7;
-    const std::size_t LastLoginIdx = 8;
-    const std::size_t PreferencesIdx = 9;
+    static constexpr std::array<RequiredField<UserModel>, 5> requiredFields{{
+        {&UserModel::isMissingLastName, "Last Name"},
+        {&UserModel::isMissingFirstName, "First Name"},
+        {&UserModel::isMissingLoginName, "Login Name"},
+        {&UserModel::isMissingPassword, "Password"},
+        {&UserModel::isMissingDateAdded, "Date Added"}
+    }};
+
+    static constexpr NSBM::constant_string_view baseQuery{schemaStatement<schema, SchemaStatement::Select>};
+
+    static constexpr std::size_t UserIdIdx = schema.columnIdx("UserID");
+    static constexpr std::size_t LastNameIdx = schema.columnIdx("LastName");
+    static constexpr std::size_t FirstNameIdx = schema.columnIdx("FirstName");
+    static constexpr std::size_t MiddleInitialIdx = schema.columnIdx("MiddleInitial");
+    static constexpr std::size_t EmailAddressIdx = schema.columnIdx("EmailAddress");
+    static constexpr std::size_t LoginNameIdx = schema.columnIdx("LoginName");
+    static constexpr std::size_t PasswordIdx = schema.columnIdx("HashedPassWord");
+    static constexpr std::size_t UserAddedIdx = schema.columnIdx("UserAdded");
+    static constexpr std::size_t LastLoginIdx = schema.columnIdx("LastLogin");
+    static constexpr std::size_t PreferencesIdx = schema.columnIdx("Preferences");
 // Preference subfield indexes
-    const std::size_t PrefDayStartIdx = 0;
-    const std::size_t PrefDayEndIdx = 1;
-    const std::size_t PrefMajorPriorityIdx = 2;
-    const std::size_t PrefMinorPriorityIdx = 3;
-    const std::size_t PrefUsingLetterIdx = 4;
-    const std::size_t PrefUsingDotIdx = 5;
+    static constexpr std::size_t PrefDayStartIdx = 0;
+    static constexpr std::size_t PrefDayEndIdx = 1;
+    static constexpr std::size_t PrefMajorPriorityIdx = 2;
+    static constexpr std::size_t PrefMinorPriorityIdx = 3;
+    static constexpr std::size_t PrefUsingLetterIdx = 4;
+    static constexpr std::size_t PrefUsingDotIdx = 5;
+    static constexpr std::size_t PreferenceFieldCount = 6;
 };
 
 using UserModel_shp = std::shared_ptr<UserModel>;
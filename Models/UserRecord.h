@@ -0,0 +1,43 @@
+#ifndef USERRECORD_H_
+#define USERRECORD_H_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/*
+ * The column data of one row of the UserProfile table, see TaskRecord. The
+ * preferences are kept as the text of the Preferences column, UserModel decodes
+ * them.
+ */
+struct UserRecord
+{
+    std::string lastName;
+    std::string firstName;
+    std::string middleInitial;
+    std::string emailAddress;
+    std::string loginName;
+    std::string password;
+    std::string preferences = "8:30 AM;5:00 PM;1;1;1;0;";
+    std::optional<std::chrono::system_clock::time_point> lastLogin;
+    std::chrono::year_month_day userAdded;
+    std::uint32_t userID = 0;
+
+    static constexpr std::size_t MinimumNameLength = 2;
+    static constexpr std::size_t MinimumPasswordLength = 8;
+
+/*
+ * The same rules as the required fields of UserModel.
+ */
+    bool hasRequiredValues() const noexcept
+    {
+        return lastName.length() >= MinimumNameLength && firstName.length() >= MinimumNameLength &&
+            loginName.length() >= 2 * MinimumNameLength && password.length() >= MinimumPasswordLength &&
+            userAdded.ok();
+    };
+
+    bool operator==(const UserRecord& other) const = default;
+};
+
+#endif // USERRECORD_H_
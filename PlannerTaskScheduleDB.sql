@@ -19,8 +19,7 @@ CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`UserProfile` (
     `Preferences` MEDIUMTEXT NOT NULL,
     `UserAdded` DATE NOT NULL,
     `LastLogin` DATETIME,
-    PRIMARY KEY (`UserID`, `LastName`, `LoginName`),
-    UNIQUE INDEX `UserID_UNIQUE` (`UserID` ASC),
+    PRIMARY KEY (`UserID`),
     UNIQUE INDEX `FullName_UNIQUE` (`LastName`, `FirstName`, `MiddleInitial`),
     UNIQUE INDEX `LoginName_UNIQUE` (`LoginName` ASC),
     UNIQUE INDEX `Email_UNIQUE` (`EmailAddress` ASC),
@@ -36,8 +35,7 @@ CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`UserGoals` (
     `Description` TINYTEXT NOT NULL,
     `Priority` INT DEFAULT NULL,
     `ParentGoal` INT UNSIGNED DEFAULT NULL,
-    PRIMARY KEY (`idUserGoals`, `UserID`),
-    UNIQUE INDEX `idUserGoals_UNIQUE` (`idUserGoals`),
+    PRIMARY KEY (`idUserGoals`),
     CONSTRAINT `fk_UserGoals_UserID`
         FOREIGN KEY (`UserID`)
         REFERENCES `UserProfile` (`UserID`)
@@ -57,8 +55,7 @@ CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserNotes` (
     `LastUpdate` DATETIME NOT NULL,
     UNIQUE INDEX `NotationDateTime_UNIQUE` (`NotationDateTime` DESC),
     UNIQUE INDEX `LastUpdate_UNIQUE` (`LastUpdate` DESC),
-    PRIMARY KEY (`idUserNotes`, `UserID`),
-    UNIQUE INDEX `idUserNotes_UNIQUE` (`idUserNotes` ASC),
+    PRIMARY KEY (`idUserNotes`),
     INDEX `fk_UserNotes_UserID_idx` (`UserID` ASC),
     CONSTRAINT `fk_UserNotes_UserID`
       FOREIGN KEY (`UserID`)
@@ -68,6 +65,15 @@ CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserNotes` (
 );
     
 -- --------------------------------------------------------
+-- The secondary indexes are the access paths of the TaskModel queries, InnoDB adds
+-- TaskID to the end of each so the lists ordered by (RequiredDelivery, TaskID) can
+-- be read in index order.
+--   AsignedTo_Completed_RequiredDelivery_idx : active tasks, tasks completed after a date
+--   AsignedTo_Status_ScheduledStart_idx : unstarted tasks due to start
+--   AsignedTo_Description_idx : select by description and assigned user
+--   ParentTask_AsignedTo_idx : the children of a task
+-- The AsignedTo indexes also serve the fk_Tasks_AsignedTo foreign key, so it has no
+-- index of its own. ParentTask is not a foreign key.
 
 DROP TABLE IF EXISTS `PlannerTaskScheduleDB`.`Tasks`;
 CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`Tasks` (
@@ -89,13 +95,12 @@ CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`Tasks` (
     `SchedulePriorityGroup` INT UNSIGNED NOT NULL,
     `PriorityInGroup` INT UNSIGNED NOT NULL,
     `Personal` BOOLEAN,
-    `DependencyCount` INT UNSIGNED,
-    `Dependencies` MEDIUMTEXT,
-    PRIMARY KEY (`TaskID`, `CreatedBy`),
-    UNIQUE INDEX `TaskID_UNIQUE` (`TaskID` ASC),
+    PRIMARY KEY (`TaskID`),
     INDEX `fk_Tasks_CreatedBy_idx` (`CreatedBy` ASC),
-    INDEX `fk_Tasks_AsignedTo_idx` (`AsignedTo` ASC),
-    INDEX `Description_idx` (`Description` ASC),
+    INDEX `AsignedTo_Completed_RequiredDelivery_idx` (`AsignedTo`, `Completed`, `RequiredDelivery`),
+    INDEX `AsignedTo_Status_ScheduledStart_idx` (`AsignedTo`, `Status`, `ScheduledStart`),
+    INDEX `AsignedTo_Description_idx` (`AsignedTo`, `Description`),
+    INDEX `ParentTask_AsignedTo_idx` (`ParentTask`, `AsignedTo`),
     CONSTRAINT `fk_Tasks_CreatedBy`
         FOREIGN KEY (`CreatedBy`)
         REFERENCES `UserProfile` (`UserID`)
@@ -108,6 +113,29 @@ CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`Tasks` (
         ON UPDATE RESTRICT
 );
 
+-- --------------------------------------------------------
+-- Each row is one dependency edge, TaskID can not start until DependsOn is complete.
+-- The primary key finds the dependencies of a task, DependsOn_idx finds the tasks
+-- that depend on a task.
+
+DROP TABLE IF EXISTS `PlannerTaskScheduleDB`.`TaskDependencies`;
+CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`TaskDependencies` (
+    `TaskID` INT UNSIGNED NOT NULL,
+    `DependsOn` INT UNSIGNED NOT NULL,
+    PRIMARY KEY (`TaskID`, `DependsOn`),
+    INDEX `DependsOn_idx` (`DependsOn`, `TaskID`),
+    CONSTRAINT `fk_TaskDependencies_TaskID`
+        FOREIGN KEY (`TaskID`)
+        REFERENCES `Tasks` (`TaskID`)
+        ON DELETE CASCADE
+        ON UPDATE RESTRICT,
+    CONSTRAINT `fk_TaskDependencies_DependsOn`
+        FOREIGN KEY (`DependsOn`)
+        REFERENCES `Tasks` (`TaskID`)
+        ON DELETE RESTRICT
+        ON UPDATE RESTRICT
+);
+
 -- --------------------------------------------------------
 
 DROP TABLE IF EXISTS `PlannerTaskScheduleDB`.`UserTaskGoals`;
@@ -135,7 +163,6 @@ CREATE TABLE IF NOT EXISTS  `PlannerTaskScheduleDB`.`UserScheduleItemTypeEnum` (
     `idUserScheduleItemTypeEnum` INT UNSIGNED NOT NULL AUTO_INCREMENT,
     `UserScheduleItemTypeEnumLabel` VARCHAR(45) NOT NULL,
     PRIMARY KEY (`idUserScheduleItemTypeEnum`),
-    UNIQUE INDEX `idUserScheduleItemTypeEnum_UNIQUE` (`idUserScheduleItemTypeEnum` ASC),
     UNIQUE INDEX `UserScheduleItemTypeEnumLabel_UNIQUE` (`UserScheduleItemTypeEnumLabel` ASC)
 );
 
@@ -150,6 +177,8 @@ INSERT INTO PlannerTaskScheduleDB.UserScheduleItemTypeEnum
 
 
 -- --------------------------------------------------------
+-- One row per user per day, the DayScheduler writes it with the working hours
+-- the day was scheduled with.
 
 DROP TABLE IF EXISTS  `PlannerTaskScheduleDB`.`UserDaySchedule`;
 CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserDaySchedule` (
@@ -159,9 +188,8 @@ CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserDaySchedule` (
     `StartOfDay` TIME NOT NULL,
     `EndOfDay` TIME NOT NULL,
     `DailyGoals` VARCHAR(45) NULL,
-    PRIMARY KEY (`idUserDaySchedule`, `UserID`),
-    UNIQUE INDEX `idUserDaySchedule_UNIQUE` (`idUserDaySchedule` ASC),
-    INDEX `fk_UserDaySchedule_UserID_idx` (`UserID` ASC),
+    PRIMARY KEY (`idUserDaySchedule`),
+    UNIQUE INDEX `UserID_DateOfSchedule_UNIQUE` (`UserID`, `DateOfSchedule`),
     CONSTRAINT `fk_UserDaySchedule_UserID`
       FOREIGN KEY (`UserID`)
       REFERENCES `PlannerTaskScheduleDB`.`UserProfile` (`UserID`)
@@ -170,6 +198,8 @@ CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserDaySchedule` (
 );
 
 -- --------------------------------------------------------
+-- Task Execution items are generated by the DayScheduler and carry the TaskID,
+-- UserID_StartDateTime_idx finds the items of a user's days.
 
 DROP TABLE IF EXISTS  `PlannerTaskScheduleDB`.`UserScheduleItem`;
 CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserScheduleItem` (
@@ -180,13 +210,19 @@ CREATE TABLE IF NOT EXISTS `PlannerTaskScheduleDB`.`UserScheduleItem` (
     `ItemType` TINYINT NOT NULL,
     `Title` VARCHAR(128) NOT NULL,
     `Location` VARCHAR(45) DEFAULT NULL,
-    PRIMARY KEY (`idUserScheduleItem`, `UserID`),
-    UNIQUE INDEX `idUserScheduleItem_UNIQUE` (`idUserScheduleItem` ASC),
-    INDEX `fk_UserScheduleItem_UserID_idx` (`UserID` ASC),
+    `TaskID` INT UNSIGNED DEFAULT NULL,
+    PRIMARY KEY (`idUserScheduleItem`),
+    INDEX `UserID_StartDateTime_idx` (`UserID`, `StartDateTime`),
+    INDEX `fk_UserScheduleItem_TaskID_idx` (`TaskID` ASC),
     CONSTRAINT `fk_UserScheduleItem_UserID`
       FOREIGN KEY (`UserID`)
       REFERENCES `PlannerTaskScheduleDB`.`UserProfile` (`UserID`)
       ON DELETE RESTRICT
+      ON UPDATE RESTRICT,
+    CONSTRAINT `fk_UserScheduleItem_TaskID`
+      FOREIGN KEY (`TaskID`)
+      REFERENCES `PlannerTaskScheduleDB`.`Tasks` (`TaskID`)
+      ON DELETE CASCADE
       ON UPDATE RESTRICT
 );
 
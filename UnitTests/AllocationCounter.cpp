@@ -0,0 +1,45 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+#ifdef COUNT_ALLOCATIONS
+/*
+ * Counts every allocation made through the global operator new so the benchmarks
+ * can report allocations per row. COUNT_ALLOCATIONS is only defined for the
+ * benchmark executable, the planner keeps the standard operator new.
+ */
+static std::atomic<std::size_t> globalAllocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* allocated = std::malloc(size ? size : 1))
+    {
+        return allocated;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* allocated) noexcept
+{
+    std::free(allocated);
+}
+
+void operator delete(void* allocated, std::size_t) noexcept
+{
+    std::free(allocated);
+}
+
+std::optional<std::size_t> getAllocationCount() noexcept
+{
+    return globalAllocationCount.load(std::memory_order_relaxed);
+}
+#else
+std::optional<std::size_t> getAllocationCount() noexcept
+{
+    return std::nullopt;
+}
+#endif
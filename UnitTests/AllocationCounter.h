@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <cstddef>
+#include <optional>
+
+/*
+ * The number of allocations made through the global operator new so far. Only the
+ * protoPersonalPlannerBenchmarks executable replaces operator new to count them,
+ * the count is empty in protoPersonalPlanner.
+ */
+std::optional<std::size_t> getAllocationCount() noexcept;
+
+#endif // ALLOCATIONCOUNTER_H_
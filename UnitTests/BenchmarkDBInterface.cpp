@@ -0,0 +1,415 @@
+#include "AllocationCounter.h"
+#include <array>
+#include "BenchmarkDBInterface.h"
+#include <boost/mysql.hpp>
+#include <chrono>
+#include "CoreDBInterface.h"
+#include "DelimitedTextCodec.h"
+#include <exception>
+#include <format>
+#include <iostream>
+#include <optional>
+#include "QueryTemplate.h"
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "TaskDependencyGraph.h"
+#include "TaskModel.h"
+#include "TaskTable.h"
+#include <vector>
+
+/*
+ * The allocations made since allocationsAtStart, empty when this executable doesn't
+ * count allocations.
+ */
+static std::optional<std::size_t> allocationsSince(std::optional<std::size_t> allocationsAtStart) noexcept
+{
+    std::optional<std::size_t> allocationsNow = getAllocationCount();
+    if (!allocationsAtStart.has_value() || !allocationsNow.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return allocationsNow.value() - allocationsAtStart.value();
+}
+
+static constexpr std::size_t textFieldValueCount = 16;
+
+BenchmarkDBInterface::BenchmarkDBInterface(std::size_t iterationsIn)
+: CoreDBInterface(),
+  iterations{iterationsIn},
+  taskIDCount{0},
+  currentTaskID{0},
+  selectByTaskIDSQL{"SELECT * FROM Tasks WHERE TaskID = ?"},
+  textFieldChecksum{0},
+  taskTableChecksum{0},
+  queryBuildChecksum{0},
+  dependencyGraphChecksum{0}
+{
+    for (std::size_t valueIdx = 0; valueIdx < textFieldValueCount; ++valueIdx)
+    {
+        textFieldValues.push_back(1000 + valueIdx * 37);
+        textFieldRow += std::to_string(textFieldValues.back());
+        textFieldRow += ';';
+    }
+}
+
+void BenchmarkDBInterface::runAllBenchmarks()
+{
+    runTextFieldBenchmarks();
+    runTaskTableBenchmarks();
+    runQueryBuildBenchmarks();
+    runDependencyGraphBenchmarks();
+
+    prepareForRunQueryAsync();
+
+    try
+    {
+        NSBM::results countResult = runQueryAsync("SELECT COUNT(*) FROM Tasks");
+        taskIDCount = static_cast<std::size_t>(countResult.rows().at(0).at(0).as_int64());
+        if (taskIDCount == 0)
+        {
+            std::clog << "No tasks in the database, benchmarks skipped\n";
+            return;
+        }
+
+        // Both paths prepare or connect on the first call, keep that out of the timing.
+        currentTaskID = 0;
+        runQueryAsync(NSBM::format_sql(format_opts.value(), "SELECT * FROM Tasks WHERE TaskID = {}", nextTaskID()));
+        runPreparedQueryAsync(PreparedQuery{"Benchmark.selectByTaskID", selectByTaskIDSQL, {NSBM::field(nextTaskID())}});
+
+        reportBenchmark("text protocol select by TaskID", benchmarkTextSelectByTaskID());
+        reportBenchmark("prepared statement select by TaskID", benchmarkPreparedSelectByTaskID());
+    }
+
+    catch(const std::exception& e)
+    {
+        std::cerr << std::format("BenchmarkDBInterface::runAllBenchmarks FAILED: {}\n", e.what());
+    }
+}
+
+void BenchmarkDBInterface::runTextFieldBenchmarks()
+{
+    reportTextFieldBenchmark("istringstream decode of a TEXT field", benchmarkStreamTextFieldDecode());
+    reportTextFieldBenchmark("DelimitedTextCodec decode of a TEXT field", benchmarkCodecTextFieldDecode());
+    reportTextFieldBenchmark("std::to_string encode of a TEXT field", benchmarkStringTextFieldEncode());
+    reportTextFieldBenchmark("DelimitedTextCodec encode of a TEXT field", benchmarkCodecTextFieldEncode());
+}
+
+/*
+ * The parsing used by the models before DelimitedTextCodec, a string per value.
+ */
+BenchmarkDBInterface::TextFieldBenchmark BenchmarkDBInterface::benchmarkStreamTextFieldDecode()
+{
+    std::optional<std::size_t> allocationsAtStart = getAllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::string> subFields;
+        std::istringstream iss(textFieldRow);
+        for (std::string token; std::getline(iss, token, ';'); )
+        {
+            subFields.push_back(std::move(token));
+        }
+        for (const std::string& subField: subFields)
+        {
+            textFieldChecksum += std::stoul(subField);
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return TextFieldBenchmark{elapsed, allocationsSince(allocationsAtStart)};
+}
+
+BenchmarkDBInterface::TextFieldBenchmark BenchmarkDBInterface::benchmarkCodecTextFieldDecode()
+{
+    DelimitedTextCodec<std::size_t> textFieldCodec;
+    std::array<std::size_t, textFieldValueCount> decodedValues;
+
+    std::optional<std::size_t> allocationsAtStart = getAllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        auto valueCount = textFieldCodec.decode(textFieldRow, decodedValues);
+        for (std::size_t valueIdx = 0; valueIdx < valueCount.value_or(0); ++valueIdx)
+        {
+            textFieldChecksum += decodedValues[valueIdx];
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return TextFieldBenchmark{elapsed, allocationsSince(allocationsAtStart)};
+}
+
+BenchmarkDBInterface::TextFieldBenchmark BenchmarkDBInterface::benchmarkStringTextFieldEncode()
+{
+    std::optional<std::size_t> allocationsAtStart = getAllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::vector<std::string> subFields;
+        for (std::size_t value: textFieldValues)
+        {
+            subFields.push_back(std::to_string(value));
+        }
+        std::string textField;
+        for (const std::string& subField: subFields)
+        {
+            textField.append(subField);
+            textField += ';';
+        }
+        textFieldChecksum += textField.size();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return TextFieldBenchmark{elapsed, allocationsSince(allocationsAtStart)};
+}
+
+/*
+ * The codec's buffer grows on the first encode, the warm up keeps that out of the count.
+ */
+BenchmarkDBInterface::TextFieldBenchmark BenchmarkDBInterface::benchmarkCodecTextFieldEncode()
+{
+    DelimitedTextCodec<std::size_t> textFieldCodec;
+    textFieldCodec.encode(textFieldValues);
+
+    std::optional<std::size_t> allocationsAtStart = getAllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        textFieldChecksum += textFieldCodec.encode(textFieldValues).size();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return TextFieldBenchmark{elapsed, allocationsSince(allocationsAtStart)};
+}
+
+void BenchmarkDBInterface::reportTextFieldBenchmark(std::string_view benchmarkName, TextFieldBenchmark result)
+{
+    reportBenchmark(benchmarkName, result.elapsed);
+    std::clog << std::format("    {} values per row\n", textFieldValueCount);
+    reportAllocations("row", result.allocations);
+}
+
+/*
+ * The allocations are only counted by the protoPersonalPlannerBenchmarks executable.
+ */
+void BenchmarkDBInterface::reportAllocations(std::string_view perWhat, std::optional<std::size_t> allocations)
+{
+    if (!allocations.has_value())
+    {
+        std::clog << "    allocations not counted, run protoPersonalPlannerBenchmarks to count them\n";
+        return;
+    }
+
+    std::clog << std::format("    {:.1f} allocations per {}\n",
+        iterations ? static_cast<double>(allocations.value()) / iterations : 0.0, perWhat);
+}
+
+/*
+ * The generated tasks spread over two years of scheduled starts, 4 priority groups
+ * and 100 priorities in each group.
+ */
+void BenchmarkDBInterface::runTaskTableBenchmarks()
+{
+    TaskTable table;
+    table.reserve(TaskTableRows);
+
+    std::chrono::sys_days firstStart = std::chrono::sys_days(std::chrono::year_month_day{
+        std::chrono::year{2025}, std::chrono::January, std::chrono::day{1}});
+    for (std::size_t row = 0; row < TaskTableRows; ++row)
+    {
+        std::chrono::sys_days scheduledStart = firstStart + std::chrono::days((row * 7919) % 730);
+        table.append(row + 1, static_cast<TaskModel::TaskStatus>(row % 5), scheduledStart,
+            scheduledStart + std::chrono::days(row % 45), 1 + row % 4, 1 + (row * 31) % 100);
+    }
+
+    bool simdAvailable = TaskTable::simdAvailable();
+    if (simdAvailable)
+    {
+        reportBenchmark("AVX2 TaskTable filter of 1,000,000 tasks", benchmarkTaskTableFilter(table, true));
+    }
+    reportBenchmark("scalar TaskTable filter of 1,000,000 tasks", benchmarkTaskTableFilter(table, false));
+    TaskTable::useSimd(simdAvailable);
+}
+
+/*
+ * Four column filters combined into one selection, the planning view query.
+ */
+std::chrono::duration<double> BenchmarkDBInterface::benchmarkTaskTableFilter(const TaskTable& table, bool useSimd)
+{
+    TaskTable::useSimd(useSimd);
+    std::chrono::year_month_day windowStart{std::chrono::year{2025}, std::chrono::June, std::chrono::day{1}};
+    std::chrono::year_month_day windowEnd{std::chrono::year{2025}, std::chrono::August, std::chrono::day{31}};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        TaskSelection selection = table.selectRange(TaskTable::Column::Status,
+            static_cast<int>(TaskModel::TaskStatus::Not_Started), static_cast<int>(TaskModel::TaskStatus::Work_in_Progress));
+        selection &= table.selectScheduledStartBetween(windowStart, windowEnd);
+        selection &= table.selectEqual(TaskTable::Column::SchedulePriorityGroup, 1);
+        selection &= table.selectRange(TaskTable::Column::PriorityInGroup, 1, 50);
+        taskTableChecksum += selection.selectedCount();
+    }
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+/*
+ * The query options of a utf8mb4 connection, building a query doesn't need the database.
+ */
+static const NSBM::format_options queryBuildFormatOptions{NSBM::utf8mb4_charset, true};
+static constexpr std::string_view queryBuildSelect = "SELECT TaskID, CreatedBy, AsignedTo, Description FROM Tasks";
+static const QueryTemplate queryBuildTemplate(queryBuildSelect, " WHERE AsignedTo = {} AND ParentTask = {}");
+
+void BenchmarkDBInterface::runQueryBuildBenchmarks()
+{
+    TextFieldBenchmark formatContext = benchmarkFormatContextQueryBuild();
+    reportBenchmark("format_context query build", formatContext.elapsed);
+    reportAllocations("query", formatContext.allocations);
+
+    TextFieldBenchmark queryTemplate = benchmarkQueryTemplateQueryBuild();
+    reportBenchmark("QueryTemplate query build", queryTemplate.elapsed);
+    reportAllocations("query", queryTemplate.allocations);
+}
+
+/*
+ * The way the models built queries before QueryTemplate.
+ */
+BenchmarkDBInterface::TextFieldBenchmark BenchmarkDBInterface::benchmarkFormatContextQueryBuild()
+{
+    std::optional<std::size_t> allocationsAtStart = getAllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        NSBM::format_context fctx(queryBuildFormatOptions);
+        NSBM::format_sql_to(fctx, NSBM::runtime(queryBuildSelect));
+        NSBM::format_sql_to(fctx, " WHERE AsignedTo = {} AND ParentTask = {}", i, i + 1);
+        std::string query = std::move(fctx).get().value();
+        queryBuildChecksum += query.size();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return TextFieldBenchmark{elapsed, allocationsSince(allocationsAtStart)};
+}
+
+BenchmarkDBInterface::TextFieldBenchmark BenchmarkDBInterface::benchmarkQueryTemplateQueryBuild()
+{
+    std::optional<std::size_t> allocationsAtStart = getAllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::string query = queryBuildTemplate.format(queryBuildFormatOptions, i, i + 1);
+        queryBuildChecksum += query.size();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return TextFieldBenchmark{elapsed, allocationsSince(allocationsAtStart)};
+}
+
+/*
+ * Each generated task depends on tasks with lower TaskIDs so the graph has no cycle,
+ * the remaining hours cycle from 0 to 16.
+ */
+void BenchmarkDBInterface::runDependencyGraphBenchmarks()
+{
+    std::vector<std::size_t> taskIDs;
+    std::vector<double> remainingHours;
+    for (std::size_t taskID = 1; taskID <= DependencyGraphTasks; ++taskID)
+    {
+        taskIDs.push_back(taskID);
+        remainingHours.push_back(static_cast<double>(taskID % 17));
+    }
+
+    std::vector<TaskDependencyGraph::Dependency> dependencies;
+    dependencies.reserve(DependencyGraphEdges);
+    for (std::size_t edge = 0; edge < DependencyGraphEdges; ++edge)
+    {
+        std::size_t taskID = 2 + (edge * 7919) % (DependencyGraphTasks - 1);
+        dependencies.push_back({taskID, 1 + (edge * 104729) % (taskID - 1)});
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TaskDependencyGraph graph(taskIDs, remainingHours, dependencies);
+    std::chrono::steady_clock::time_point built = std::chrono::steady_clock::now();
+    std::vector<TaskDependencyGraph::TaskTiming> timings = graph.computeTimings();
+    std::vector<std::size_t> criticalPath = graph.getCriticalPath();
+    std::chrono::steady_clock::time_point scheduled = std::chrono::steady_clock::now();
+    dependencyGraphChecksum += timings.size() + criticalPath.size();
+
+    std::clog << std::format("Benchmark TaskDependencyGraph of {} tasks and {} dependencies: built in {:.4f} seconds, "
+        "scheduled in {:.4f} seconds, {} tasks on the critical path\n", graph.taskCount(), graph.dependencyCount(),
+        std::chrono::duration<double>(built - start).count(), std::chrono::duration<double>(scheduled - built).count(),
+        criticalPath.size());
+
+    reportBenchmark("TaskDependencyGraph::addDependency", benchmarkAddDependency(graph));
+}
+
+/*
+ * Dependencies between tasks a few TaskIDs apart, as when a plan is edited, some
+ * of them are against the order of the graph and some would make a cycle.
+ */
+std::chrono::duration<double> BenchmarkDBInterface::benchmarkAddDependency(TaskDependencyGraph& graph)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        std::size_t taskID = 1 + (i * 7919) % DependencyGraphTasks;
+        std::size_t dependsOn = 1 + (taskID + 1 + i % 8) % DependencyGraphTasks;
+        dependencyGraphChecksum += graph.addDependency(taskID, dependsOn)? 1 : 0;
+    }
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+std::chrono::duration<double> BenchmarkDBInterface::benchmarkTextSelectByTaskID()
+{
+    currentTaskID = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        NSBM::format_context fctx(format_opts.value());
+        NSBM::format_sql_to(fctx, "SELECT * FROM Tasks WHERE TaskID = {}", nextTaskID());
+        NSBM::results localResult = runQueryAsync(std::move(fctx).get().value());
+    }
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+std::chrono::duration<double> BenchmarkDBInterface::benchmarkPreparedSelectByTaskID()
+{
+    currentTaskID = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        NSBM::results localResult = runPreparedQueryAsync(
+            PreparedQuery{"Benchmark.selectByTaskID", selectByTaskIDSQL, {NSBM::field(nextTaskID())}});
+    }
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+std::size_t BenchmarkDBInterface::nextTaskID() noexcept
+{
+    currentTaskID = (currentTaskID % taskIDCount) + 1;
+    return currentTaskID;
+}
+
+void BenchmarkDBInterface::reportBenchmark(std::string_view benchmarkName, std::chrono::duration<double> elapsed)
+{
+    double perCallMicroseconds = iterations ? (elapsed.count() * 1'000'000.0) / iterations : 0.0;
+
+    std::clog << std::format("Benchmark {}: {} iterations in {:.4f} seconds, {:.1f} microseconds per call\n",
+        benchmarkName, iterations, elapsed.count(), perCallMicroseconds);
+}
+
@@ -0,0 +1,76 @@
+#ifndef BENCHMARKDBINTERFACE_H_
+#define BENCHMARKDBINTERFACE_H_
+
+#include <chrono>
+#include "CoreDBInterface.h"
+#include <optional>
+#include <string>
+#include "TaskDependencyGraph.h"
+#include "TaskTable.h"
+#include <string_view>
+#include <vector>
+
+/*
+ * Benchmarks for the database access paths. These are run after the unit tests
+ * when --run-benchmarks is specified, the database must already contain the data
+ * inserted by the unit tests.
+ *
+ * The TEXT field benchmarks don't use the database, they compare the delimited
+ * text codec with the stream based parsing it replaced and count the heap
+ * allocations made per row, allocations are only counted by the
+ * protoPersonalPlannerBenchmarks executable, see AllocationCounter.h. The TaskTable benchmarks filter a generated table of
+ * TaskTableRows tasks with the AVX2 and the scalar filters. The query building
+ * benchmarks compare a format_context per query with a QueryTemplate. The
+ * dependency graph benchmarks build and schedule a generated graph of
+ * DependencyGraphEdges dependencies between DependencyGraphTasks tasks.
+ */
+class BenchmarkDBInterface : public CoreDBInterface
+{
+public:
+    BenchmarkDBInterface(std::size_t iterationsIn);
+    ~BenchmarkDBInterface() = default;
+    void runAllBenchmarks();
+
+private:
+    struct TextFieldBenchmark
+    {
+        std::chrono::duration<double> elapsed;
+        std::optional<std::size_t> allocations;     // Empty when allocations are not counted.
+    };
+
+    void runTextFieldBenchmarks();
+    TextFieldBenchmark benchmarkStreamTextFieldDecode();
+    TextFieldBenchmark benchmarkCodecTextFieldDecode();
+    TextFieldBenchmark benchmarkStringTextFieldEncode();
+    TextFieldBenchmark benchmarkCodecTextFieldEncode();
+    void reportTextFieldBenchmark(std::string_view benchmarkName, TextFieldBenchmark result);
+    void reportAllocations(std::string_view perWhat, std::optional<std::size_t> allocations);
+    void runTaskTableBenchmarks();
+    void runQueryBuildBenchmarks();
+    void runDependencyGraphBenchmarks();
+    std::chrono::duration<double> benchmarkAddDependency(TaskDependencyGraph& graph);
+    TextFieldBenchmark benchmarkFormatContextQueryBuild();
+    TextFieldBenchmark benchmarkQueryTemplateQueryBuild();
+    std::chrono::duration<double> benchmarkTaskTableFilter(const TaskTable& table, bool useSimd);
+    std::chrono::duration<double> benchmarkTextSelectByTaskID();
+    std::chrono::duration<double> benchmarkPreparedSelectByTaskID();
+    std::size_t nextTaskID() noexcept;
+    void reportBenchmark(std::string_view benchmarkName, std::chrono::duration<double> elapsed);
+
+    std::size_t iterations;
+    std::size_t taskIDCount;
+    std::size_t currentTaskID;
+    std::string selectByTaskIDSQL;
+    std::string textFieldRow;
+    std::vector<std::size_t> textFieldValues;
+    std::size_t textFieldChecksum;
+    std::size_t taskTableChecksum;
+    std::size_t queryBuildChecksum;
+    std::size_t dependencyGraphChecksum;
+    static constexpr std::size_t TaskTableRows = 1'000'000;
+    static constexpr std::size_t DependencyGraphTasks = 200'000;
+    static constexpr std::size_t DependencyGraphEdges = 1'000'000;
+};
+
+#endif // BENCHMARKDBINTERFACE_H_
+
@@ -0,0 +1,228 @@
+#include <array>
+#include <boost/mysql.hpp>
+#include <chrono>
+#include "CommandLineParser.h"
+#include <exception>
+#include <format>
+#include <functional>
+#include <iostream>
+#include "ListPage.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include "TaskModel.h"
+#include "TaskTree.h"
+#include "TestQueryPlans.h"
+#include "UserModel.h"
+#include <vector>
+
+TestQueryPlans::TestQueryPlans()
+: TestDBInterfaceCore(programOptions.verboseOutput, "query plan")
+{
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestQueryPlans::testTaskQueryPlans, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestQueryPlans::testUserQueryPlans, this));
+}
+
+/*
+ * Each list query is tested with and without a keyset page.
+ */
+TestDBInterfaceCore::TestStatus TestQueryPlans::testTaskQueryPlans()
+{
+    constexpr std::size_t assignedUserID = 1;
+    constexpr std::array<std::size_t, 3> taskIDs{1, 2, 3};
+    std::chrono::year_month_day searchStartDate = std::chrono::year{2024}/std::chrono::January/1;
+    const ListPage page{.pageSize = 10, .afterKey = 1};
+    const ListPage datePage{.pageSize = 10, .afterKey = 1, .afterDate = searchStartDate};
+    TaskModel queryGenerator;
+    const NSBM::format_options& formatOptions = planReader.getFormatOptions();
+    std::vector<ModelQuery> modelQueries;
+
+    modelQueries.push_back({"Tasks.selectByTaskID", std::string(TaskModel::getSelectByTaskIDSQL()),
+        std::vector<NSBM::field>{NSBM::field(taskIDs[0])}});
+    modelQueries.push_back({"TaskModel::formatSelectByTaskIDs",
+        TaskModel::formatSelectByTaskIDs(formatOptions, taskIDs)});
+    modelQueries.push_back({"TaskModel::formatSelectByDescriptionAndAssignedUser",
+        TaskModel::formatSelectByDescriptionAndAssignedUser(formatOptions, "Description", assignedUserID)});
+
+    for (const ListPage& listPage: {ListPage(), datePage})
+    {
+        modelQueries.push_back({"TaskModel::formatSelectActiveTasksForAssignedUser",
+            queryGenerator.formatSelectActiveTasksForAssignedUser(formatOptions, assignedUserID, listPage)});
+        modelQueries.push_back({"TaskModel::formatSelectUnstartedDueForStartForAssignedUser",
+            queryGenerator.formatSelectUnstartedDueForStartForAssignedUser(formatOptions, assignedUserID, listPage)});
+    }
+    for (const ListPage& listPage: {ListPage(), page})
+    {
+        modelQueries.push_back({"TaskModel::formatSelectTasksCompletedByAssignedAfterDate",
+            queryGenerator.formatSelectTasksCompletedByAssignedAfterDate(formatOptions, assignedUserID,
+                searchStartDate, listPage)});
+        modelQueries.push_back({"TaskModel::formatSelectTasksByAssignedIDandParentID",
+            queryGenerator.formatSelectTasksByAssignedIDandParentID(formatOptions, assignedUserID, 1, listPage)});
+        modelQueries.push_back({"TaskModel::formatSelectTasksThatDependOn",
+            queryGenerator.formatSelectTasksThatDependOn(formatOptions, 1, listPage)});
+    }
+
+    modelQueries.push_back({"TaskModel::formatSelectTaskTree",
+        queryGenerator.formatSelectTaskTree(formatOptions, 1, TaskTree::DefaultMaxDepth)});
+
+    for (const ModelQuery& modelQuery: modelQueries)
+    {
+        if (modelQuery.query.empty())
+        {
+            std::clog << std::format("Formatting {} FAILED\n{}\n", modelQuery.name, queryGenerator.getAllErrorMessages());
+            return TESTFAILED;
+        }
+    }
+
+    return testQueryPlans(modelQueries);
+}
+
+TestDBInterfaceCore::TestStatus TestQueryPlans::testUserQueryPlans()
+{
+    UserModel queryGenerator;
+    const NSBM::format_options& formatOptions = planReader.getFormatOptions();
+    std::vector<ModelQuery> modelQueries;
+
+    modelQueries.push_back({"UserProfile.selectByUserID", std::string(UserModel::getSelectByUserIDSQL()),
+        std::vector<NSBM::field>{NSBM::field(std::size_t{1})}});
+    modelQueries.push_back({"UserProfile.selectByLoginName", std::string(UserModel::getSelectByLoginNameSQL()),
+        std::vector<NSBM::field>{NSBM::field(std::string("login"))}});
+    modelQueries.push_back({"UserModel::formatSelectByEmail",
+        UserModel::formatSelectByEmail(formatOptions, "user@example.com")});
+    modelQueries.push_back({"UserModel::formatSelectByLoginAndPassword",
+        UserModel::formatSelectByLoginAndPassword(formatOptions, "login", "password")});
+    modelQueries.push_back({"UserModel::formatSelectByFullName",
+        UserModel::formatSelectByFullName(formatOptions, "Last", "First", "M")});
+/*
+ * Reading every user is a full scan by design, only the keyset pages are tested.
+ */
+    modelQueries.push_back({"UserModel::formatGetAllUsersQuery",
+        queryGenerator.formatGetAllUsersQuery(formatOptions, ListPage{.pageSize = 10, .afterKey = 1})});
+
+    if (modelQueries.back().query.empty())
+    {
+        std::clog << std::format("Formatting UserModel::formatGetAllUsersQuery FAILED\n{}\n",
+            queryGenerator.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    return testQueryPlans(modelQueries);
+}
+
+TestDBInterfaceCore::TestStatus TestQueryPlans::testQueryPlans(const std::vector<ModelQuery>& modelQueries)
+{
+    TestDBInterfaceCore::TestStatus allPlansPassed = TESTPASSED;
+
+    for (const ModelQuery& modelQuery: modelQueries)
+    {
+        std::vector<QueryPlanRow> queryPlan = modelQuery.preparedParameters.has_value()?
+            planReader.explainPrepared(modelQuery.name, modelQuery.query, modelQuery.preparedParameters.value()) :
+            planReader.explain(modelQuery.query);
+        if (queryPlan.empty())
+        {
+            std::clog << std::format("EXPLAIN {} FAILED\n{}\n", modelQuery.name, planReader.getAllErrorMessages());
+            return TESTFAILED;
+        }
+
+        for (const QueryPlanRow& planRow: queryPlan)
+        {
+            if (verboseOutput)
+            {
+                std::clog << std::format("{}: table {} type {} possible_keys {} key {} {}\n", modelQuery.name,
+                    planRow.table, planRow.accessType, planRow.possibleKeys, planRow.key, planRow.extra);
+            }
+            if (isFullTableScan(planRow))
+            {
+                std::clog << std::format("Query plan FAILED, {} scans all of {}\n\t{}\n", modelQuery.name,
+                    planRow.table, modelQuery.query);
+                allPlansPassed = TESTFAILED;
+            }
+        }
+    }
+
+    return allPlansPassed;
+}
+
+/*
+ * The test tables are small enough that the optimizer may prefer a scan to an index
+ * it could use, a query only fails when there is no index it could use. Derived and
+ * materialized tables, <subquery2> for example, are not base tables.
+ */
+bool TestQueryPlans::isFullTableScan(const QueryPlanRow& planRow) const noexcept
+{
+    return planRow.accessType == "ALL" && planRow.possibleKeys.empty() && !planRow.table.starts_with('<');
+}
+
+std::vector<TestQueryPlans::QueryPlanRow> TestQueryPlans::QueryPlanReader::explain(std::string_view query)
+{
+    errorMessages.clear();
+
+    try
+    {
+        return readQueryPlan(runQueryAsync(std::format("EXPLAIN {}", query)));
+    }
+
+    catch (const std::exception& e)
+    {
+        appendErrorMessage(std::format("In TestQueryPlans::QueryPlanReader::explain : {}", e.what()));
+    }
+
+    return {};
+}
+
+/*
+ * EXPLAIN of the model's statement is prepared under its own key, so the plan is the
+ * plan of the statement with its parameters bound.
+ */
+std::vector<TestQueryPlans::QueryPlanRow> TestQueryPlans::QueryPlanReader::explainPrepared(
+    std::string_view statementKey, std::string_view sqlText, std::vector<NSBM::field> parameters)
+{
+    errorMessages.clear();
+
+    try
+    {
+        std::string explainKey = std::format("QueryPlans.{}", statementKey);
+        std::string explainSQL = std::format("EXPLAIN {}", sqlText);
+
+        return readQueryPlan(runPreparedQueryAsync(PreparedQuery{explainKey, explainSQL, std::move(parameters)}));
+    }
+
+    catch (const std::exception& e)
+    {
+        appendErrorMessage(std::format("In TestQueryPlans::QueryPlanReader::explainPrepared : {}", e.what()));
+    }
+
+    return {};
+}
+
+std::vector<TestQueryPlans::QueryPlanRow> TestQueryPlans::QueryPlanReader::readQueryPlan(
+    const NSBM::results& explainResults)
+{
+    std::vector<QueryPlanRow> queryPlan;
+    std::size_t tableIdx = 0;
+    std::size_t typeIdx = 0;
+    std::size_t possibleKeysIdx = 0;
+    std::size_t keyIdx = 0;
+    std::size_t extraIdx = 0;
+    for (std::size_t columnIdx = 0; columnIdx < explainResults.meta().size(); ++columnIdx)
+    {
+        std::string_view columnName = explainResults.meta()[columnIdx].column_name();
+        tableIdx = columnName == "table"? columnIdx : tableIdx;
+        typeIdx = columnName == "type"? columnIdx : typeIdx;
+        possibleKeysIdx = columnName == "possible_keys"? columnIdx : possibleKeysIdx;
+        keyIdx = columnName == "key"? columnIdx : keyIdx;
+        extraIdx = columnName == "Extra"? columnIdx : extraIdx;
+    }
+
+    auto fieldText = [](NSBM::field_view field) {
+        return field.is_string()? std::string(field.as_string()) : std::string();
+    };
+
+    for (NSBM::row_view planRow: explainResults.rows())
+    {
+        queryPlan.push_back({fieldText(planRow.at(tableIdx)), fieldText(planRow.at(typeIdx)),
+            fieldText(planRow.at(possibleKeysIdx)), fieldText(planRow.at(keyIdx)), fieldText(planRow.at(extraIdx))});
+    }
+
+    return queryPlan;
+}
@@ -0,0 +1,66 @@
+#ifndef TESTQUERYPLANS_H_
+#define TESTQUERYPLANS_H_
+
+#include <boost/mysql.hpp>
+#include "CoreDBInterface.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include "TestDBInterfaceCore.h"
+#include <vector>
+
+/*
+ * Runs EXPLAIN on the queries the models issue and fails any query that has no
+ * index it can use. Runs after the task tests so the tables contain rows.
+ */
+class TestQueryPlans : public TestDBInterfaceCore
+{
+public:
+    TestQueryPlans();
+    ~TestQueryPlans() = default;
+
+private:
+/*
+ * One row of EXPLAIN output, possibleKeys and key are empty when they are NULL.
+ */
+    struct QueryPlanRow
+    {
+        std::string table;
+        std::string accessType;
+        std::string possibleKeys;
+        std::string key;
+        std::string extra;
+    };
+
+    class QueryPlanReader : public CoreDBInterface
+    {
+    public:
+        std::vector<QueryPlanRow> explain(std::string_view query);
+        std::vector<QueryPlanRow> explainPrepared(std::string_view statementKey, std::string_view sqlText,
+            std::vector<NSBM::field> parameters);
+        using CoreDBInterface::getFormatOptions;
+
+    private:
+        static std::vector<QueryPlanRow> readQueryPlan(const NSBM::results& explainResults);
+    };
+
+/*
+ * Every query comes from the model that runs it, the prepared statements are
+ * explained with their parameters bound.
+ */
+    struct ModelQuery
+    {
+        std::string name;
+        std::string query;
+        std::optional<std::vector<NSBM::field>> preparedParameters;
+    };
+
+    TestDBInterfaceCore::TestStatus testTaskQueryPlans();
+    TestDBInterfaceCore::TestStatus testUserQueryPlans();
+    TestDBInterfaceCore::TestStatus testQueryPlans(const std::vector<ModelQuery>& modelQueries);
+    bool isFullTableScan(const QueryPlanRow& planRow) const noexcept;
+
+    QueryPlanReader planReader;
+};
+
+#endif // TESTQUERYPLANS_H_
@@ -1,14 +1,31 @@
+#include <algorithm>
 #include "CommandLineParser.h"
 #include "commonUtilities.h"
 #include "CSVReader.h"
+#include <cstdint>
+#include "DaySchedulePlan.h"
+#include "DayScheduler.h"
 #include <exception>
+#include <format>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include "ModelRowCache.h"
+#include <optional>
+#include "ReadyTaskTracker.h"
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include "TestDBInterfaceCore.h"
 #include "TestTaskDBInterface.h"
+#include "TaskDependencyGraph.h"
+#include "TaskGateway.h"
 #include "TaskModel.h"
+#include "TaskRecord.h"
+#include "TaskTable.h"
+#include "TaskTree.h"
+#include "UnitOfWork.h"
 #include "UserModel.h"
 #include <vector>
 
@@ -23,6 +40,20 @@ TestTaskDBInterface::TestTaskDBInterface(std::string taskFileName)
     positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testGetUnstartedTasks, this));
     positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testTaskUpdates, this));
     positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testGetActiveTasks, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testBatchUpdates, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testSelectByTaskIDs, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testBulkInsert, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testUnitOfWork, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testDirtyColumnUpdates, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testRowCache, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testGetTasksThatDependOn, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testTaskRecordGateway, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testTaskTableFilters, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testKeysetPages, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testTaskTree, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testDependencyGraph, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testReadyTaskTracker, this));
+    positiviePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testDaySchedule, this));
 
     negativePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testNegativePathAlreadyInDataBase, this));
     negativePathTestFuncsNoArgs.push_back(std::bind(&TestTaskDBInterface::testnegativePathNotModified, this));
@@ -192,6 +223,45 @@ TaskModel_shp TestTaskDBInterface::creatEvenTask(CSVRow taskData)
     return newTask;
 }
 
+/*
+ * The task is assigned to and created by userOne.
+ */
+TaskModel_shp TestTaskDBInterface::createTestTask(const TestTaskValues& values)
+{
+    TaskModel_shp newTask = std::make_shared<TaskModel>(userOne->getUserID(), values.description);
+    newTask->setCreationDate(getTodaysDate());
+    newTask->setEstimatedEffort(values.estimatedEffort);
+    newTask->setPriorityGroupC(values.priorityGroup);
+    newTask->setPriority(values.priority);
+    newTask->setScheduledStart(values.scheduledStart);
+    newTask->setDueDate(values.dueDate);
+    if (values.parent)
+    {
+        newTask->setParentTaskID(values.parent);
+    }
+    if (values.status.has_value())
+    {
+        newTask->setStatus(values.status.value());
+    }
+    for (auto dependency: values.dependsOn)
+    {
+        newTask->addDependency(dependency);
+    }
+
+    return newTask;
+}
+
+/*
+ * Callers check isInDataBase(), a failed insert leaves its errors in the task.
+ */
+TaskModel_shp TestTaskDBInterface::insertTestTask(const TestTaskValues& values)
+{
+    TaskModel_shp newTask = createTestTask(values);
+    newTask->insert();
+
+    return newTask;
+}
+
 TestDBInterfaceCore::TestStatus TestTaskDBInterface::testGetUnstartedTasks()
 {
     TaskList taskDBInteface;
@@ -242,6 +312,306 @@ TestDBInterfaceCore::TestStatus TestTaskDBInterface::testGetActiveTasks()
     return TESTFAILED;
 }
 
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testBatchUpdates()
+{
+    TaskList taskDBInteface;
+    TaskListValues activeTasks = taskDBInteface.getActiveTasksForAssignedUser(userOne->getUserID());
+    if (activeTasks.empty())
+    {
+        std::cerr << "testBatchUpdates: no active tasks to update\n" << taskDBInteface.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    std::vector<double> expectedEffort;
+    for (auto task: activeTasks)
+    {
+        task->addEffortHours(1.0);
+        expectedEffort.push_back(task->getactualEffortToDate());
+    }
+
+    if (!taskDBInteface.updateAll(activeTasks))
+    {
+        std::cerr << "taskDBInteface.updateAll() FAILED!\n" << taskDBInteface.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    for (std::size_t taskIdx = 0; taskIdx < activeTasks.size(); ++taskIdx)
+    {
+        TaskModel_shp updatedTask = std::make_shared<TaskModel>();
+        updatedTask->selectByTaskID(activeTasks[taskIdx]->getTaskID());
+        if (updatedTask->getactualEffortToDate() != expectedEffort[taskIdx] || activeTasks[taskIdx]->isModified())
+        {
+            std::clog << std::format("Batch update test FAILED for task: {}\n", activeTasks[taskIdx]->getTaskID());
+            return TESTFAILED;
+        }
+    }
+
+    return TESTPASSED;
+}
+
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testSelectByTaskIDs()
+{
+    TaskList taskDBInteface;
+    TaskListValues activeTasks = taskDBInteface.getActiveTasksForAssignedUser(userOne->getUserID());
+    if (activeTasks.empty())
+    {
+        std::cerr << "testSelectByTaskIDs: no active tasks to select\n" << taskDBInteface.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    std::vector<std::size_t> taskIDs;
+    for (auto task: activeTasks)
+    {
+        taskIDs.push_back(task->getTaskID());
+    }
+
+    TaskModel taskSelector;
+    std::vector<TaskModel_shp> selectedTasks = taskSelector.selectByTaskIDs(taskIDs);
+    if (selectedTasks.size() != activeTasks.size())
+    {
+        std::cerr << std::format("taskSelector.selectByTaskIDs() returned {} tasks, expected {}\n",
+            selectedTasks.size(), activeTasks.size()) << taskSelector.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    for (std::size_t taskIdx = 0; taskIdx < activeTasks.size(); ++taskIdx)
+    {
+        if (!(*selectedTasks[taskIdx] == activeTasks[taskIdx]))
+        {
+            std::clog << std::format("selectByTaskIDs test FAILED for task: {}\n", activeTasks[taskIdx]->getTaskID());
+            return TESTFAILED;
+        }
+    }
+
+    return TESTPASSED;
+}
+
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testBulkInsert()
+{
+    constexpr std::size_t bulkTaskCount = 5;
+    TaskListValues newTasks;
+
+    for (std::size_t taskNumber = 1; taskNumber <= bulkTaskCount; ++taskNumber)
+    {
+        newTasks.push_back(createTestTask({.description = std::format("Bulk insert test task {}", taskNumber),
+            .priority = static_cast<unsigned int>(taskNumber),
+            .estimatedEffort = static_cast<unsigned int>(taskNumber)}));
+    }
+
+    TaskList taskDBInteface;
+    if (!taskDBInteface.insertAll(newTasks))
+    {
+        std::cerr << "taskDBInteface.insertAll() FAILED!\n" << taskDBInteface.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    std::vector<std::size_t> taskIDs;
+    for (auto task: newTasks)
+    {
+        if (!task->isInDataBase() || task->isModified())
+        {
+            std::clog << std::format("Bulk insert test FAILED, task '{}' has no TaskID\n", task->getDescription());
+            return TESTFAILED;
+        }
+        taskIDs.push_back(task->getTaskID());
+    }
+
+    TaskModel taskSelector;
+    std::vector<TaskModel_shp> insertedTasks = taskSelector.selectByTaskIDs(taskIDs);
+    if (insertedTasks.size() != newTasks.size())
+    {
+        std::cerr << "Bulk insert test FAILED, inserted tasks not found\n" << taskSelector.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    for (std::size_t taskIdx = 0; taskIdx < newTasks.size(); ++taskIdx)
+    {
+        if (!(*insertedTasks[taskIdx] == newTasks[taskIdx]))
+        {
+            std::clog << std::format("Bulk insert test FAILED for task: {}\n", newTasks[taskIdx]->getTaskID());
+            return TESTFAILED;
+        }
+    }
+
+    return TESTPASSED;
+}
+
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testUnitOfWork()
+{
+    UnitOfWork unitOfWork;
+
+    UserModel_shp newUser = std::make_shared<UserModel>("Work", "Unit", "O", "unit.of.work@example.com");
+    newUser->autoGenerateLoginAndPassword();
+    unitOfWork.registerModel(newUser);
+
+    TaskListValues newTasks;
+    for (std::size_t taskNumber = 1; taskNumber <= 3; ++taskNumber)
+    {
+        TaskModel_shp newTask = createTestTask({.description = std::format("Unit of work test task {}", taskNumber),
+            .priorityGroup = 'B', .estimatedEffort = static_cast<unsigned int>(taskNumber)});
+        newTasks.push_back(newTask);
+        // The user does not have a UserID until it has been inserted.
+        unitOfWork.registerModel(newTask, [newTask, newUser]()
+            {
+                newTask->setCreatorID(newUser->getUserID());
+                newTask->setAssignToID(newUser->getUserID());
+            });
+    }
+
+    // A task that is already in the database is updated in the same transaction.
+    TaskModel_shp existingTask = std::make_shared<TaskModel>();
+    existingTask->selectByTaskID(1);
+    existingTask->addEffortHours(1.0);
+    unitOfWork.registerModel(existingTask);
+
+    if (!unitOfWork.commit())
+    {
+        std::cerr << "unitOfWork.commit() FAILED!\n" << unitOfWork.getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    UserModel_shp insertedUser = std::make_shared<UserModel>();
+    if (!newUser->isInDataBase() || !insertedUser->selectByUserID(newUser->getUserID()) || *insertedUser != *newUser)
+    {
+        std::clog << "Unit of work test FAILED, user not inserted\n" << insertedUser->getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    for (auto task: newTasks)
+    {
+        TaskModel_shp insertedTask = std::make_shared<TaskModel>();
+        if (!insertedTask->selectByTaskID(task->getTaskID()) || insertedTask->getCreatorID() != newUser->getUserID())
+        {
+            std::clog << std::format("Unit of work test FAILED for task '{}'\n", task->getDescription());
+            return TESTFAILED;
+        }
+    }
+
+    TaskModel_shp updatedTask = std::make_shared<TaskModel>();
+    updatedTask->selectByTaskID(existingTask->getTaskID());
+    if (updatedTask->getactualEffortToDate() != existingTask->getactualEffortToDate() || existingTask->isModified())
+    {
+        std::clog << std::format("Unit of work test FAILED, task {} not updated\n", existingTask->getTaskID());
+        return TESTFAILED;
+    }
+
+    return TESTPASSED;
+}
+
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testDirtyColumnUpdates()
+{
+    TaskModel_shp task = std::make_shared<TaskModel>();
+    if (!task->selectByTaskID(1))
+    {
+        std::cerr << "Task 1 not found in database!!\n" << task->getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    task->setDescription(task->getDescription());
+    task->setPriority(task->getPriority());
+    if (task->isModified() || task->hasDirtyColumns())
+    {
+        std::clog << "Dirty column test FAILED, setting the current values marked the task modified\n";
+        return TESTFAILED;
+    }
+
+    task->setPercentageComplete(task->getPercentageComplete() + 10.0);
+    if (!task->isModified() || !task->update())
+    {
+        std::cerr << "Dirty column test FAILED, the changed task was not updated\n" << task->getAllErrorMessages() << "\n";
+        return TESTFAILED;
+    }
+
+    TaskModel_shp updatedTask = std::make_shared<TaskModel>();
+    updatedTask->selectByTaskID(1);
+    if (!(*updatedTask == task) || task->hasDirtyColumns())
+    {
+        std::clog << "Dirty column test FAILED, the updated task differs from the database\n";
+        return TESTFAILED;
+    }
+
+    return TESTPASSED;
+}
+
+/*
+ * The row cache is opt in, the test enables it for the task table and disables it
+ * again so the other tests always read the database.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testRowCache()
+{
+    TaskModel_shp task = std::make_shared<TaskModel>();
+    ModelRowCache& taskRowCache = task->getRowCache();
+    std::size_t savedCapacity = taskRowCache.getStatistics().capacity;
+    TestDBInterfaceCore::TestStatus testStatus = TESTPASSED;
+
+    taskRowCache.setCapacity(2);
+    taskRowCache.clear();
+    taskRowCache.resetStatistics();
+
+    TaskModel_shp cachedTask = std::make_shared<TaskModel>();
+    if (!task->selectByTaskID(1) || !cachedTask->selectByTaskID(1) || !(*cachedTask == task))
+    {
+        std::clog << "Row cache test FAILED, the cached task differs from the selected task\n";
+        testStatus = TESTFAILED;
+    }
+
+    std::optional<std::vector<std::size_t>> cachedDependencies = taskRowCache.findRelatedIDs(1);
+    if (!cachedDependencies.has_value() || cachedDependencies.value() != cachedTask->getDependencies())
+    {
+        std::clog << "Row cache test FAILED, the task dependencies were not cached with the row\n";
+        testStatus = TESTFAILED;
+    }
+
+    ModelRowCache::Statistics statistics = taskRowCache.getStatistics();
+    if (statistics.hits != 1 || statistics.misses != 1)
+    {
+        std::clog << std::format("Row cache test FAILED, expected 1 hit and 1 miss, found {} hits and {} misses\n",
+            statistics.hits, statistics.misses);
+        testStatus = TESTFAILED;
+    }
+
+    cachedTask->addEffortHours(1.0);
+    if (!cachedTask->save() || !task->selectByTaskID(1) || !(*cachedTask == task))
+    {
+        std::clog << "Row cache test FAILED, the saved task was still served from the cache\n";
+        testStatus = TESTFAILED;
+    }
+
+    TaskModel_shp evictingTask = std::make_shared<TaskModel>();
+    evictingTask->selectByTaskID(2);
+    evictingTask->selectByTaskID(3);
+    statistics = taskRowCache.getStatistics();
+    if (statistics.invalidations != 1 || statistics.evictions != 1 || statistics.size != 2)
+    {
+        std::clog << std::format("Row cache test FAILED, {} invalidations, {} evictions, {} cached rows\n",
+            statistics.invalidations, statistics.evictions, statistics.size);
+        testStatus = TESTFAILED;
+    }
+
+    // A row invalidated while it was being read must not be stored.
+    std::optional<NSBM::row> staleRow = taskRowCache.find(3);
+    std::uint64_t readGeneration = taskRowCache.getGeneration();
+    taskRowCache.invalidate(3);
+    if (staleRow.has_value())
+    {
+        taskRowCache.store(3, staleRow.value(), readGeneration);
+    }
+    if (!staleRow.has_value() || taskRowCache.find(3).has_value())
+    {
+        std::clog << "Row cache test FAILED, a row invalidated during the read was cached\n";
+        testStatus = TESTFAILED;
+    }
+
+    if (verboseOutput)
+    {
+        taskRowCache.reportStatistics(std::clog);
+    }
+
+    taskRowCache.setCapacity(savedCapacity);
+
+    return testStatus;
+}
+
 TestDBInterfaceCore::TestStatus TestTaskDBInterface::testTaskUpdates()
 {
     TaskModel_shp firstTaskToChange = std::make_shared<TaskModel>();
@@ -346,6 +716,562 @@ bool TestTaskDBInterface::testAddDepenedcies()
     return true;
 }
 
+/*
+ * Uses the dependencies added by testAddDepenedcies().
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testGetTasksThatDependOn()
+{
+    std::size_t user1ID = userOne->getUserID();
+    TaskModel_shp dependsOn = std::make_shared<TaskModel>();
+    TaskModel_shp dependentTask = std::make_shared<TaskModel>();
+    TaskModel_shp mostDependentTask = std::make_shared<TaskModel>();
+    dependsOn->selectByDescriptionAndAssignedUser(
+        "Check with GoDaddy about providing service to archive website to external SSD", user1ID);
+    dependentTask->selectByDescriptionAndAssignedUser("Install a WordPress Archive Plugin", user1ID);
+    mostDependentTask->selectByDescriptionAndAssignedUser("Log into PHPMyAdmin and save Database to disk", user1ID);
+
+    TaskList taskList;
+    TaskListValues dependents = taskList.getTasksThatDependOn(dependsOn->getTaskID());
+    if (dependents.size() != 2)
+    {
+        std::clog << std::format("Get tasks that depend on task {} FAILED, expected 2 tasks found {}\n{}\n",
+            dependsOn->getTaskID(), dependents.size(), taskList.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    for (auto dependent: dependents)
+    {
+        if (!(*dependent == dependentTask) && !(*dependent == mostDependentTask))
+        {
+            std::clog << std::format("Get tasks that depend on task {} FAILED, unexpected task {}\n",
+                dependsOn->getTaskID(), dependent->getTaskID());
+            return TESTFAILED;
+        }
+    }
+
+    return TESTPASSED;
+}
+
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testTaskRecordGateway()
+{
+    TaskGateway gateway;
+    TaskModel taskOne;
+    taskOne.selectByTaskID(1);
+
+    TaskGateway::DBResult<TaskRecord> record = gateway.selectByTaskID(1);
+    if (!record.has_value())
+    {
+        std::clog << std::format("TaskGateway::selectByTaskID(1) FAILED\n{}\n", record.error());
+        return TESTFAILED;
+    }
+
+    if (record->description != taskOne.getDescription() || record->assignedTo != taskOne.getAssignToID() ||
+        record->scheduledStart != taskOne.getScheduledStart())
+    {
+        std::clog << "TaskGateway::selectByTaskID(1) does not match TaskModel::selectByTaskID(1)\n";
+        return TESTFAILED;
+    }
+
+    TaskRecord newRecord = record.value();
+    newRecord.taskID = 0;
+    newRecord.parentTaskID = record->taskID;
+    newRecord.description = "Task inserted by the task gateway test";
+    TaskGateway::DBResult<void> inserted = gateway.insert(newRecord);
+    if (!inserted.has_value() || newRecord.taskID == 0)
+    {
+        std::clog << std::format("TaskGateway::insert() FAILED\n{}\n", inserted.has_value()? "" : inserted.error());
+        return TESTFAILED;
+    }
+
+    TaskGateway::DBResult<TaskRecord> insertedRecord = gateway.selectByTaskID(newRecord.taskID);
+    if (!insertedRecord.has_value() || insertedRecord.value() != newRecord)
+    {
+        std::clog << std::format("TaskGateway select of inserted task {} FAILED\n{}\n", newRecord.taskID,
+            insertedRecord.has_value()? "" : insertedRecord.error());
+        return TESTFAILED;
+    }
+
+    newRecord.percentageComplete = 50.0;
+    TaskGateway::DBResult<void> updated = gateway.update(newRecord);
+    if (!updated.has_value())
+    {
+        std::clog << std::format("TaskGateway::update() FAILED\n{}\n", updated.error());
+        return TESTFAILED;
+    }
+
+    TaskModel updatedTask;
+    if (!updatedTask.selectByTaskID(newRecord.taskID) || updatedTask.getPercentageComplete() != 50.0)
+    {
+        std::clog << std::format("TaskGateway::update() not visible to TaskModel\n{}\n",
+            updatedTask.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    if (verboseOutput)
+    {
+        std::clog << std::format("sizeof(TaskRecord) = {}, sizeof(TaskModel) = {}\n", sizeof(TaskRecord),
+            sizeof(TaskModel));
+    }
+
+    return TESTPASSED;
+}
+
+/*
+ * The SIMD and scalar filters must select the same rows as filtering the TaskModels.
+ * A generated table checks the two against each other for every column, its size is
+ * not a multiple of 64 so the AVX2 filters also run their scalar tail, and its dates
+ * start before 1970 so the day numbers include negative values.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testTaskTableFilters()
+{
+    TaskList taskList;
+    TaskListValues activeTasks = taskList.getActiveTasksForAssignedUser(userOne->getUserID());
+    if (activeTasks.empty())
+    {
+        std::clog << std::format("testTaskTableFilters: no active tasks\n{}\n", taskList.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    TaskTable table(activeTasks);
+    std::chrono::year_month_day windowStart = activeTasks.front()->getScheduledStart();
+    std::chrono::year_month_day windowEnd{std::chrono::sys_days(windowStart) + std::chrono::days(30)};
+
+    std::vector<std::size_t> expectedTaskIDs;
+    for (auto task: activeTasks)
+    {
+        if (task->getStatus() != TaskModel::TaskStatus::Complete && task->getScheduledStart() >= windowStart &&
+            task->getScheduledStart() <= windowEnd)
+        {
+            expectedTaskIDs.push_back(task->getTaskID());
+        }
+    }
+
+    bool simdAvailable = TaskTable::simdAvailable();
+    TestStatus status = TESTPASSED;
+    for (bool useSimd: {simdAvailable, false})
+    {
+        TaskTable::useSimd(useSimd);
+        TaskSelection selection = table.selectRange(TaskTable::Column::Status,
+            static_cast<int>(TaskModel::TaskStatus::Not_Started), static_cast<int>(TaskModel::TaskStatus::Work_in_Progress)) &
+            table.selectScheduledStartBetween(windowStart, windowEnd);
+
+        if (table.selectedTaskIDs(selection) != expectedTaskIDs)
+        {
+            std::clog << std::format("TaskTable {} filter FAILED, expected {} tasks, selected {}\n",
+                useSimd? "AVX2" : "scalar", expectedTaskIDs.size(), selection.selectedCount());
+            status = TESTFAILED;
+        }
+    }
+
+    constexpr std::size_t generatedRowCount = 3 * 1024 + 37;
+    constexpr std::int32_t firstDay = -1500;
+    constexpr std::int32_t dayCount = 3000;
+    std::uint32_t randomState = 20240917;
+    auto nextRandom = [&randomState]()
+    {
+        randomState = randomState * 1664525u + 1013904223u;
+        return randomState >> 8;
+    };
+
+    TaskTable generatedTable;
+    generatedTable.reserve(generatedRowCount);
+    for (std::size_t row = 0; row < generatedRowCount; ++row)
+    {
+        std::int32_t scheduledDay = firstDay + static_cast<std::int32_t>(nextRandom() % dayCount);
+        std::chrono::sys_days scheduledStart{std::chrono::days(scheduledDay)};
+        std::chrono::sys_days requiredDelivery = scheduledStart + std::chrono::days(nextRandom() % 90);
+        unsigned int priorityGroup = row % 97 == 0? UINT32_MAX : nextRandom() % 5;
+        generatedTable.append(row + 1, static_cast<TaskModel::TaskStatus>(nextRandom() % 5),
+            std::chrono::year_month_day{scheduledStart}, std::chrono::year_month_day{requiredDelivery}, priorityGroup,
+            nextRandom() % 10);
+    }
+
+    constexpr std::int32_t lowest = std::numeric_limits<std::int32_t>::min();
+    constexpr std::int32_t highest = std::numeric_limits<std::int32_t>::max();
+    const std::vector<std::pair<std::int32_t, std::int32_t>> generatedRanges = {
+        {lowest, highest}, {lowest, lowest}, {highest, highest}, {0, 0}, {-1, -1}, {-5, 0}, {1, 3}, {4, 4}, {5, 300},
+        {3, 2}, {firstDay, firstDay}, {firstDay - 1, firstDay + 10}, {-100, 100}, {-1, highest},
+        {firstDay + dayCount - 1, highest}
+    };
+    const std::vector<TaskTable::Column> generatedColumns = {
+        TaskTable::Column::Status, TaskTable::Column::ScheduledStart, TaskTable::Column::RequiredDelivery,
+        TaskTable::Column::SchedulePriorityGroup, TaskTable::Column::PriorityInGroup
+    };
+
+    for (TaskTable::Column column: generatedColumns)
+    {
+        for (auto [low, high]: generatedRanges)
+        {
+            TaskTable::useSimd(simdAvailable);
+            TaskSelection simdSelection = generatedTable.selectRange(column, low, high);
+            TaskTable::useSimd(false);
+            TaskSelection scalarSelection = generatedTable.selectRange(column, low, high);
+
+            if (simdSelection != scalarSelection)
+            {
+                std::clog << std::format("TaskTable column {} range [{}, {}] FAILED, AVX2 selected {}, scalar {}\n",
+                    static_cast<int>(column), low, high, simdSelection.selectedCount(),
+                    scalarSelection.selectedCount());
+                status = TESTFAILED;
+            }
+        }
+    }
+    TaskTable::useSimd(simdAvailable);
+
+    return status;
+}
+
+/*
+ * Reading the active tasks two at a time must return every active task once, in
+ * (RequiredDelivery, TaskID) order.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testKeysetPages()
+{
+    TaskList taskList;
+    TaskListValues allActiveTasks = taskList.getActiveTasksForAssignedUser(userOne->getUserID());
+
+    ListPage page{.pageSize = 2};
+    TaskListValues pagedTasks;
+    for (TaskListValues pageTasks = taskList.getActiveTasksForAssignedUser(userOne->getUserID(), page);
+        !pageTasks.empty(); pageTasks = taskList.getActiveTasksForAssignedUser(userOne->getUserID(), page))
+    {
+        if (pageTasks.size() > page.pageSize)
+        {
+            std::clog << std::format("Keyset page FAILED, {} tasks in a page of {}\n", pageTasks.size(), page.pageSize);
+            return TESTFAILED;
+        }
+        pagedTasks.insert(pagedTasks.end(), pageTasks.begin(), pageTasks.end());
+        page = TaskList::nextPage(page, pageTasks);
+    }
+
+    if (pagedTasks.size() != allActiveTasks.size())
+    {
+        std::clog << std::format("Keyset pages FAILED, {} tasks in pages, {} active tasks\n", pagedTasks.size(),
+            allActiveTasks.size());
+        return TESTFAILED;
+    }
+
+    for (std::size_t taskIdx = 1; taskIdx < pagedTasks.size(); ++taskIdx)
+    {
+        TaskModel_shp previous = pagedTasks[taskIdx - 1];
+        TaskModel_shp current = pagedTasks[taskIdx];
+        if (previous->getDueDate() > current->getDueDate() ||
+            (previous->getDueDate() == current->getDueDate() && previous->getTaskID() >= current->getTaskID()))
+        {
+            std::clog << std::format("Keyset pages FAILED, task {} is out of order after task {}\n",
+                current->getTaskID(), previous->getTaskID());
+            return TESTFAILED;
+        }
+    }
+
+    return TESTPASSED;
+}
+
+/*
+ * A root with two children and a grandchild. The root is then made a child of the
+ * grandchild, the tree query must stop at the cycle.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testTaskTree()
+{
+    TaskModel_shp root = insertTestTask({.description = "Task tree test root"});
+    TaskModel_shp firstChild = insertTestTask({.description = "Task tree test first child", .parent = root});
+    TaskModel_shp secondChild = insertTestTask({.description = "Task tree test second child", .parent = root});
+    TaskModel_shp grandChild = insertTestTask({.description = "Task tree test grand child", .parent = firstChild});
+    for (auto task: {root, firstChild, secondChild, grandChild})
+    {
+        if (!task->isInDataBase())
+        {
+            std::clog << std::format("Task tree test FAILED, insert of '{}' failed\n{}\n", task->getDescription(),
+                task->getAllErrorMessages());
+            return TESTFAILED;
+        }
+    }
+
+    TaskList taskList;
+    TaskTree fullTree = taskList.getTaskTree(root->getTaskID());
+    if (fullTree.size() != 4 || fullTree.getChildren(root->getTaskID()).size() != 2 ||
+        fullTree.getDepth(grandChild->getTaskID()) != 2u || fullTree.reachedDepthLimit())
+    {
+        std::clog << std::format("Task tree test FAILED, {} tasks in the tree\n{}\n", fullTree.size(),
+            taskList.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    TaskTree childTree = taskList.getTaskTree(firstChild->getTaskID());
+    if (childTree.size() != 2 || childTree.getRoot()->getTaskID() != firstChild->getTaskID())
+    {
+        std::clog << std::format("Task tree test FAILED, {} tasks in the subtree\n", childTree.size());
+        return TESTFAILED;
+    }
+
+    TaskTree exactTree = taskList.getTaskTree(root->getTaskID(), 2);
+    if (exactTree.size() != 4 || exactTree.reachedDepthLimit())
+    {
+        std::clog << std::format("Task tree test FAILED, {} tasks in the depth 2 tree\n", exactTree.size());
+        return TESTFAILED;
+    }
+
+    TaskTree shallowTree = taskList.getTaskTree(root->getTaskID(), 1);
+    if (shallowTree.size() != 3 || shallowTree.contains(grandChild->getTaskID()) || !shallowTree.reachedDepthLimit())
+    {
+        std::clog << std::format("Task tree test FAILED, {} tasks in the depth 1 tree\n", shallowTree.size());
+        return TESTFAILED;
+    }
+
+    root->setParentTaskID(grandChild);
+    if (!root->update())
+    {
+        std::clog << std::format("Task tree test FAILED, update of the root failed\n{}\n", root->getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    TaskTree cycleTree = taskList.getTaskTree(root->getTaskID());
+    std::vector<TaskModel_shp> depthFirst = cycleTree.getSubtreeDepthFirst(root->getTaskID());
+    if (cycleTree.size() != 4 || depthFirst.size() != 4 || depthFirst[1]->getTaskID() != firstChild->getTaskID() ||
+        depthFirst[2]->getTaskID() != grandChild->getTaskID())
+    {
+        std::clog << std::format("Task tree test FAILED, {} tasks in the tree with a cycle\n", cycleTree.size());
+        return TESTFAILED;
+    }
+
+    return TESTPASSED;
+}
+
+/*
+ * Task 1 (4 hours left) is needed by 2 (6 hours) and 3 (1 hour), 4 (2 hours) needs
+ * both, 5 (3 hours) is independent. The critical path is 1, 2, 4 in 12 hours.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testDependencyGraph()
+{
+    auto graphTask = [this](std::size_t taskID, unsigned int estimate, double effortToDate,
+        std::vector<std::size_t> dependsOn) {
+        TaskModel_shp task = std::make_shared<TaskModel>(userOne->getUserID(), std::format("Graph task {}", taskID));
+        task->setTaskID(taskID);
+        task->setEstimatedEffort(estimate);
+        task->setActualEffortToDate(effortToDate);
+        for (std::size_t dependency: dependsOn)
+        {
+            task->addDependency(dependency);
+        }
+        return task;
+    };
+
+    TaskListValues tasks{graphTask(4, 2, 0.0, {2, 3}), graphTask(1, 5, 1.0, {}), graphTask(2, 6, 0.0, {1}),
+        graphTask(3, 1, 0.0, {1}), graphTask(5, 3, 0.0, {})};
+    TaskDependencyGraph graph(tasks);
+
+    std::vector<std::size_t> order = graph.getTopologicalOrder();
+    auto orderPosition = [&order](std::size_t taskID) { return std::ranges::find(order, taskID) - order.begin(); };
+    if (graph.hasCycle() || order.size() != tasks.size() || orderPosition(1) > orderPosition(2) ||
+        orderPosition(2) > orderPosition(4) || orderPosition(3) > orderPosition(4))
+    {
+        std::clog << "Dependency graph FAILED, wrong topological order\n";
+        return TESTFAILED;
+    }
+
+    std::vector<TaskDependencyGraph::TaskTiming> timings = graph.computeTimings();
+    if (graph.getCriticalPath() != std::vector<std::size_t>{1, 2, 4} || timings.size() != tasks.size() ||
+        timings[3].earliestStart != 10.0 || timings[2].slack() != 5.0 || timings[4].isCritical())
+    {
+        std::clog << "Dependency graph FAILED, wrong critical path\n";
+        return TESTFAILED;
+    }
+
+    if (graph.addDependency(1, 4) || !graph.addDependency(1, 5) || graph.getTopologicalOrder().front() != 5 ||
+        graph.getCriticalPath() != std::vector<std::size_t>{5, 1, 2, 4})
+    {
+        std::clog << "Dependency graph FAILED, added dependencies\n";
+        return TESTFAILED;
+    }
+
+    tasks[1]->addDependency(4);
+    TaskDependencyGraph cyclicGraph(tasks);
+    std::vector<std::size_t> cycle = cyclicGraph.findCycle();
+    if (!cyclicGraph.hasCycle() || cycle.size() != 3 || !cyclicGraph.getTopologicalOrder().empty())
+    {
+        std::clog << std::format("Dependency graph FAILED, cycle of {} tasks found\n", cycle.size());
+        return TESTFAILED;
+    }
+
+    return TESTPASSED;
+}
+
+/*
+ * The second task waits for the first, the third waits for both. Completing the
+ * first readies the second, whose status is written back as Not_Started. The third
+ * is put on hold by another model before its status is written, so it is left alone.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testReadyTaskTracker()
+{
+    auto insertWaitingTask = [this](std::string description, std::vector<TaskModel_shp> dependsOn) {
+        TaskModel::TaskStatus status = dependsOn.empty()? TaskModel::TaskStatus::Not_Started :
+            TaskModel::TaskStatus::Waiting_for_Dependency;
+        return insertTestTask({.description = description, .scheduledStart = getTodaysDatePlus(5),
+            .dueDate = getTodaysDatePlus(20), .priorityGroup = 'B', .estimatedEffort = 2, .status = status,
+            .dependsOn = dependsOn});
+    };
+
+    TaskModel_shp first = insertWaitingTask("Ready tracker test first task", {});
+    TaskModel_shp second = insertWaitingTask("Ready tracker test second task", {first});
+    TaskModel_shp third = insertWaitingTask("Ready tracker test third task", {first, second});
+    if (!first->isInDataBase() || !second->isInDataBase() || !third->isInDataBase())
+    {
+        std::clog << "Ready tracker test FAILED, insert failed\n";
+        return TESTFAILED;
+    }
+
+    ReadyTaskTracker tracker({third, first, second});
+    if (!tracker.isReady(first->getTaskID()) || tracker.isReady(second->getTaskID()) ||
+        tracker.getUnmetDependencyCount(third->getTaskID()) != 2 || tracker.getPendingStatusChangeCount() != 0)
+    {
+        std::clog << "Ready tracker test FAILED, wrong initial state\n";
+        return TESTFAILED;
+    }
+
+    TaskListValues readyTasks = tracker.completeTask(first->getTaskID());
+    if (readyTasks.size() != 1 || readyTasks[0] != second || first->getStatus() != TaskModel::TaskStatus::Complete ||
+        tracker.getPendingStatusChangeCount() != 1 || !tracker.completeTask(first->getTaskID()).empty())
+    {
+        std::clog << std::format("Ready tracker test FAILED, {} tasks ready after the first\n", readyTasks.size());
+        return TESTFAILED;
+    }
+
+    if (!tracker.flushStatusChanges() || second->getStatus() != TaskModel::TaskStatus::Not_Started ||
+        second->isModified())
+    {
+        std::clog << std::format("Ready tracker test FAILED, status change\n{}\n", tracker.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    TaskModel storedSecond;
+    if (!storedSecond.selectByTaskID(second->getTaskID()) ||
+        storedSecond.getStatus() != TaskModel::TaskStatus::Not_Started)
+    {
+        std::clog << "Ready tracker test FAILED, status not written to the database\n";
+        return TESTFAILED;
+    }
+
+    readyTasks = tracker.completeTask(second->getTaskID());
+    if (readyTasks.size() != 1 || readyTasks[0] != third || tracker.getReadyTasks().size() != 1)
+    {
+        std::clog << std::format("Ready tracker test FAILED, {} tasks ready after the second\n", readyTasks.size());
+        return TESTFAILED;
+    }
+
+    // Someone else puts the third task on hold before the queued change is written.
+    TaskModel otherThird;
+    otherThird.selectByTaskID(third->getTaskID());
+    otherThird.setStatus(TaskModel::TaskStatus::On_Hold);
+    if (!otherThird.update())
+    {
+        std::clog << std::format("Ready tracker test FAILED, hold update\n{}\n", otherThird.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    if (!tracker.flushStatusChanges() || third->getStatus() != TaskModel::TaskStatus::Waiting_for_Dependency ||
+        tracker.getPendingStatusChangeCount() != 0 || tracker.getAllErrorMessages().empty())
+    {
+        std::clog << "Ready tracker test FAILED, status of a task changed by someone else\n";
+        return TESTFAILED;
+    }
+
+    return TESTPASSED;
+}
+
+/*
+ * Working hours 8:30 to 5:00 with a meeting from 10:00 to 11:00 on the first day.
+ * The first task (5 hours) goes around the meeting, the second (10 hours) fills the
+ * rest of the first day and part of the second, the third (1 hour) can't start
+ * before the second day and is late. The generated schedule is then written for
+ * two inserted tasks, rescheduling it again must not see its own items as busy.
+ */
+TestDBInterfaceCore::TestStatus TestTaskDBInterface::testDaySchedule()
+{
+    using std::chrono::minutes;
+    const std::chrono::sys_days firstDay{getTodaysDatePlus(100)};
+    const std::chrono::sys_days secondDay = firstDay + std::chrono::days(1);
+
+    DaySchedulePlan plan(firstDay, 3, minutes(510), minutes(1020));
+    std::vector<DaySchedulePlan::BusyTime> busyTimes{{firstDay, minutes(600), minutes(660)}};
+    plan.setBusyTimes(busyTimes);
+    plan.schedule({{3, 2, 1, firstDay, secondDay, minutes(60)}, {2, 1, 2, secondDay, firstDay, minutes(600)},
+        {1, 1, 1, secondDay, firstDay, minutes(300)}});
+
+    std::span<const DaySchedulePlan::TaskBlock> firstDayBlocks = plan.getBlocks(firstDay);
+    std::span<const DaySchedulePlan::TaskBlock> secondDayBlocks = plan.getBlocks(secondDay);
+    if (firstDayBlocks.size() != 3 ||
+        firstDayBlocks[0] != DaySchedulePlan::TaskBlock{1, firstDay, minutes(510), minutes(600)} ||
+        firstDayBlocks[2] != DaySchedulePlan::TaskBlock{2, firstDay, minutes(870), minutes(1020)} ||
+        secondDayBlocks.size() != 2 || secondDayBlocks[1].taskID != 3 ||
+        plan.getLateTaskIDs() != std::vector<std::size_t>{3})
+    {
+        std::clog << std::format("Day schedule test FAILED, {} and {} blocks placed\n", firstDayBlocks.size(),
+            secondDayBlocks.size());
+        return TESTFAILED;
+    }
+
+    DaySchedulePlan::DayRange taskDays = plan.getTaskDays(2);
+    if (taskDays.first != firstDay || taskDays.last != secondDay + std::chrono::days(1) ||
+        !plan.getTaskDays(4).empty())
+    {
+        std::clog << "Day schedule test FAILED, days of a task\n";
+        return TESTFAILED;
+    }
+
+    DaySchedulePlan::DayRange changedDays = plan.updateTask({3, 2, 1, firstDay, secondDay, minutes(30)});
+    if (changedDays.first != secondDay || changedDays.last != secondDay + std::chrono::days(1) ||
+        plan.getLastRecomputedDayCount() != 1 || plan.getBlocks(secondDay).back().end != minutes(990))
+    {
+        std::clog << std::format("Day schedule test FAILED, {} days recomputed\n", plan.getLastRecomputedDayCount());
+        return TESTFAILED;
+    }
+
+    TaskModel_shp shortTask = insertTestTask({.description = "Day schedule test short task",
+        .scheduledStart = firstDay, .dueDate = firstDay + std::chrono::days(1), .priorityGroup = 'A',
+        .estimatedEffort = 3});
+    TaskModel_shp longTask = insertTestTask({.description = "Day schedule test long task",
+        .scheduledStart = firstDay, .dueDate = firstDay + std::chrono::days(1), .priorityGroup = 'B',
+        .estimatedEffort = 10});
+    if (!shortTask->isInDataBase() || !longTask->isInDataBase())
+    {
+        std::clog << "Day schedule test FAILED, insert failed\n";
+        return TESTFAILED;
+    }
+
+    UserModel scheduledUser = *userOne;
+    scheduledUser.setStartTime("8:30 AM");
+    scheduledUser.setEndTime("5:00 PM");
+
+    DayScheduler scheduler;
+    if (!scheduler.scheduleUser(scheduledUser, {shortTask, longTask}, firstDay, 3))
+    {
+        std::clog << std::format("Day schedule test FAILED, scheduleUser\n{}\n", scheduler.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    std::vector<DaySchedulePlan::TaskBlock> scheduledBlocks = scheduler.getPlan().getBlocks(
+        scheduler.getPlan().getAllDays());
+    if (scheduledBlocks.size() != 3 || scheduledBlocks[0].taskID != shortTask->getTaskID() ||
+        !scheduler.scheduleUser(scheduledUser, {shortTask, longTask}, firstDay, 3) ||
+        scheduler.getPlan().getBlocks(scheduler.getPlan().getAllDays()) != scheduledBlocks)
+    {
+        std::clog << std::format("Day schedule test FAILED, {} blocks scheduled\n{}\n", scheduledBlocks.size(),
+            scheduler.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    shortTask->markComplete();
+    if (!scheduler.rescheduleTask(*shortTask) || scheduler.getPlan().hasTask(shortTask->getTaskID()) ||
+        scheduler.getPlan().getBlocks(firstDay).size() != 1 || scheduler.getPlan().getLastRecomputedDayCount() != 2)
+    {
+        std::clog << std::format("Day schedule test FAILED, reschedule of a completed task\n{}\n",
+            scheduler.getAllErrorMessages());
+        return TESTFAILED;
+    }
+
+    return TESTPASSED;
+}
+
 bool TestTaskDBInterface::testGetCompletedList()
 {
     std::size_t user1ID = userOne->getUserID();
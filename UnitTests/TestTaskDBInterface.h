@@ -4,6 +4,7 @@
 #include <chrono>
 #include "CSVReader.h"
 #include <functional>
+#include <optional>
 #include <string>
 #include "TaskList.h"
 #include "TaskModel.h"
@@ -18,14 +19,47 @@ public:
     virtual TestDBInterfaceCore::TestStatus runAllTests() override;
 
 private:
+/*
+ * The values of a task created by a test, a task without a status is stored with
+ * a NULL status.
+ */
+    struct TestTaskValues
+    {
+        std::string description;
+        TaskModel_shp parent;
+        std::chrono::year_month_day scheduledStart = getTodaysDatePlus(30);
+        std::chrono::year_month_day dueDate = getTodaysDatePlus(60);
+        char priorityGroup = 'C';
+        unsigned int priority = 1;
+        unsigned int estimatedEffort = 1;
+        std::optional<TaskModel::TaskStatus> status;
+        std::vector<TaskModel_shp> dependsOn;
+    };
+
     bool testGetTaskByDescription(TaskModel_shp task);
     bool testGetTaskByID(TaskModel_shp task);
     TaskListValues loadTasksFromDataFile();
     void commonTaskInit(TaskModel_shp newTask, CSVRow taskData);
     TaskModel_shp creatOddTask(CSVRow taskData);
     TaskModel_shp creatEvenTask(CSVRow taskData);
+    TaskModel_shp createTestTask(const TestTaskValues& values);
+    TaskModel_shp insertTestTask(const TestTaskValues& values);
     TestDBInterfaceCore::TestStatus testGetUnstartedTasks();
     TestDBInterfaceCore::TestStatus testGetActiveTasks();
+    TestDBInterfaceCore::TestStatus testBatchUpdates();
+    TestDBInterfaceCore::TestStatus testSelectByTaskIDs();
+    TestDBInterfaceCore::TestStatus testBulkInsert();
+    TestDBInterfaceCore::TestStatus testUnitOfWork();
+    TestDBInterfaceCore::TestStatus testDirtyColumnUpdates();
+    TestDBInterfaceCore::TestStatus testRowCache();
+    TestDBInterfaceCore::TestStatus testGetTasksThatDependOn();
+    TestDBInterfaceCore::TestStatus testTaskRecordGateway();
+    TestDBInterfaceCore::TestStatus testTaskTableFilters();
+    TestDBInterfaceCore::TestStatus testKeysetPages();
+    TestDBInterfaceCore::TestStatus testTaskTree();
+    TestDBInterfaceCore::TestStatus testDependencyGraph();
+    TestDBInterfaceCore::TestStatus testReadyTaskTracker();
+    TestDBInterfaceCore::TestStatus testDaySchedule();
     TestDBInterfaceCore::TestStatus testTaskUpdates();
     bool testTaskUpdate(TaskModel_shp changedTask);
     bool testAddDepenedcies();
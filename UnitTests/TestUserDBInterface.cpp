@@ -4,6 +4,7 @@
 #include <exception>
 #include <functional>
 #include <iostream>
+#include "ListCursor.h"
 #include <stdexcept>
 #include <string>
 #include "TestUserDBInterface.h"
@@ -69,6 +70,11 @@ TestDBInterfaceCore::TestStatus TestUserDBInterface::runPositivePathTests()
         allTestsPassed = testGetAllUsers(userProfileTestData);
     }
 
+    if (allTestsPassed)
+    {
+        allTestsPassed = testGetAllUsersCursor(userProfileTestData);
+    }
+
     userProfileTestData.clear();
 
     reportTestStatus(allTestsPassed? TESTPASSED : TESTFAILED, "positive");
@@ -251,6 +257,33 @@ bool TestUserDBInterface::testGetAllUsers(UserListValues userProfileTestData)
     return testPassed;
 }
 
+bool TestUserDBInterface::testGetAllUsersCursor(UserListValues userProfileTestData)
+{
+    UserList testULists;
+    ListCursor<UserModel> allUsersCursor = testULists.getAllUsersCursor();
+    std::size_t userCount = 0;
+
+    for (auto user: allUsersCursor)
+    {
+        if (userCount >= userProfileTestData.size() || *userProfileTestData[userCount] != *user)
+        {
+            std::clog << std::format("Get All users cursor FAILED at user {}\n", userCount) <<
+                allUsersCursor.getAllErrorMessages() << "\n";
+            return false;
+        }
+        ++userCount;
+    }
+
+    if (userCount != userProfileTestData.size() || !allUsersCursor.isComplete())
+    {
+        std::clog << std::format("Get All users cursor FAILED: {} users streamed, {} expected\n",
+            userCount, userProfileTestData.size()) << allUsersCursor.getAllErrorMessages() << "\n";
+        return false;
+    }
+
+    return true;
+}
+
 TestDBInterfaceCore::TestStatus TestUserDBInterface::negativePathMissingRequiredFields()
 {
     std::vector<std::string> expectedErrors =
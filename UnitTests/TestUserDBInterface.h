@@ -22,6 +22,7 @@ private:
     bool testUpdateUserPassword(UserModel_shp insertedUser);
     bool loadTestUsersFromFile(UserListValues& userProfileTestData);
     bool testGetAllUsers(UserListValues userProfileTestData);
+    bool testGetAllUsersCursor(UserListValues userProfileTestData);
     TestDBInterfaceCore::TestStatus negativePathMissingRequiredFields();
     void addFirstUser(UserListValues& TestUsers);
     TestDBInterfaceCore::TestStatus testnegativePathNotModified();
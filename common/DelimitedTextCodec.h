@@ -0,0 +1,183 @@
+#ifndef DELIMITEDTEXTCODEC_H_
+#define DELIMITEDTEXTCODEC_H_
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+/*
+ * Encodes and decodes TEXT columns that hold a list of values, each value followed
+ * by the delimiter ("3;7;12;"). A text without the final delimiter is accepted.
+ *
+ * Decoding never allocates, the fields are string_views into the text and numbers
+ * are parsed in place with std::from_chars. Decoding into a span fills storage the
+ * caller already owns, decodeAppend() only allocates when the vector has to grow.
+ * Encoding writes each value with std::to_chars into the codec's buffer, the buffer
+ * is reused by every encode() so a codec that lives as long as its caller stops
+ * allocating once the buffer has reached the size of the longest text.
+ */
+template<typename ElementType>
+concept DelimitedTextElement = std::same_as<ElementType, std::string_view> ||
+    (std::integral<ElementType> && !std::same_as<ElementType, bool>) || std::floating_point<ElementType>;
+
+template<DelimitedTextElement ElementType>
+class DelimitedTextCodec
+{
+public:
+    using DecodeResult = std::expected<std::size_t, std::errc>;
+
+    explicit DelimitedTextCodec(char delimiterIn = ';')
+    : delimiter{delimiterIn}
+    {
+    }
+    ~DelimitedTextCodec() = default;
+
+/*
+ * Returns the number of values decoded, std::errc::value_too_large when the text
+ * has more values than the span, or the error of the first value that could not
+ * be parsed.
+ */
+    DecodeResult decode(std::string_view text, std::span<ElementType> values) const
+    {
+        std::size_t valueCount = 0;
+        std::errc failure = forEachField(text, [&values, &valueCount](std::string_view field)
+        {
+            if (valueCount >= values.size())
+            {
+                return std::errc::value_too_large;
+            }
+
+            std::expected<ElementType, std::errc> value = parseField(field);
+            if (!value.has_value())
+            {
+                return value.error();
+            }
+            values[valueCount++] = value.value();
+            return std::errc();
+        });
+
+        if (failure != std::errc())
+        {
+            return std::unexpected(failure);
+        }
+
+        return valueCount;
+    };
+
+/*
+ * Appends the values to the vector, returns the number of values appended. Nothing
+ * is appended when any value can not be parsed.
+ */
+    DecodeResult decodeAppend(std::string_view text, std::vector<ElementType>& values) const
+    {
+        std::size_t firstNewValue = values.size();
+        std::errc failure = forEachField(text, [&values](std::string_view field)
+        {
+            std::expected<ElementType, std::errc> value = parseField(field);
+            if (!value.has_value())
+            {
+                return value.error();
+            }
+            values.push_back(value.value());
+            return std::errc();
+        });
+
+        if (failure != std::errc())
+        {
+            values.resize(firstNewValue);
+            return std::unexpected(failure);
+        }
+
+        return values.size() - firstNewValue;
+    };
+
+/*
+ * The returned view is valid until the next encode() by this codec.
+ */
+    std::string_view encode(std::span<const ElementType> values)
+    {
+        buffer.clear();
+        for (const ElementType& value: values)
+        {
+            appendField(buffer, value, delimiter);
+        }
+
+        return buffer;
+    };
+
+    static std::expected<ElementType, std::errc> parseField(std::string_view field) noexcept
+    {
+        if constexpr (std::same_as<ElementType, std::string_view>)
+        {
+            return field;
+        }
+        else
+        {
+            ElementType value{};
+            const char* fieldEnd = field.data() + field.size();
+            std::from_chars_result parsed = std::from_chars(field.data(), fieldEnd, value);
+            if (parsed.ec != std::errc())
+            {
+                return std::unexpected(parsed.ec);
+            }
+            if (parsed.ptr != fieldEnd)
+            {
+                return std::unexpected(std::errc::invalid_argument);
+            }
+            return value;
+        }
+    };
+
+/*
+ * Appends one value and the delimiter, used directly by models whose text holds
+ * values of more than one type.
+ */
+    static void appendField(std::string& text, ElementType value, char fieldDelimiter)
+    {
+        if constexpr (std::same_as<ElementType, std::string_view>)
+        {
+            text.append(value);
+        }
+        else
+        {
+            char digits[MaxFieldDigits];
+            std::to_chars_result written = std::to_chars(digits, digits + MaxFieldDigits, value);
+            text.append(digits, written.ptr);
+        }
+        text += fieldDelimiter;
+    };
+
+private:
+/*
+ * Calls fieldFunction for each field until it returns an error.
+ */
+    template<typename FieldFunction>
+    std::errc forEachField(std::string_view text, FieldFunction fieldFunction) const
+    {
+        while (!text.empty())
+        {
+            std::size_t fieldEnd = text.find(delimiter);
+            std::errc failure = fieldFunction(text.substr(0, fieldEnd));
+            if (failure != std::errc())
+            {
+                return failure;
+            }
+            text.remove_prefix(fieldEnd == std::string_view::npos ? text.size() : fieldEnd + 1);
+        }
+
+        return std::errc();
+    }
+
+    static constexpr std::size_t MaxFieldDigits = 32;   // Shortest round trip of a double is at most 24.
+    char delimiter;
+    std::string buffer;
+};
+
+#endif // DELIMITEDTEXTCODEC_H_
+
@@ -1,7 +1,11 @@
+#include "BenchmarkDBInterface.h"
 #include "CommandLineParser.h"
+#include "DBConnectionPool.h"
 #include <exception>
 #include <iostream>
+#include "ModelRowCache.h"
 #include <stdexcept>
+#include "TestQueryPlans.h"
 #include "TestTaskDBInterface.h"
 #include "TestUserDBInterface.h"
 #include "UtilityTimer.h"
@@ -28,6 +32,11 @@ int main(int argc, char* argv[])
                 {
                     return EXIT_FAILURE;
                 }
+                TestQueryPlans queryPlanTests;
+                if (queryPlanTests.runAllTests() != TestDBInterfaceCore::TestStatus::TestPassed)
+                {
+                    return EXIT_FAILURE;
+                }
             }
             else
             {
@@ -37,7 +46,14 @@ int main(int argc, char* argv[])
 			if (programOptions.enableExecutionTime)
 			{
                 stopWatch.stopTimerAndReport("Testing of Insertion and retrieval of users and tasks in MySQL database\n");
+                DBConnectionPool::reportAllPoolStatistics(std::clog);
+                ModelRowCache::reportAllCacheStatistics(std::clog);
 			}
+            if (programOptions.runBenchmarks)
+            {
+                BenchmarkDBInterface benchmarks(programOptions.benchmarkIterations);
+                benchmarks.runAllBenchmarks();
+            }
         }
         else
 		{